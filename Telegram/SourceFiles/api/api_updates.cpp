@@ -55,6 +55,9 @@ namespace {
 
 constexpr auto kChannelGetDifferenceLimit = 100;
 
+// Not more than 8 getChannelDifference requests are sent in parallel.
+constexpr auto kChannelGetDifferenceParallel = 8;
+
 // 1s wait after show channel history before sending getChannelDifference.
 constexpr auto kWaitForChannelGetDifference = crl::time(1000);
 
@@ -400,10 +403,7 @@ void Updates::channelDifferenceDone(
 			"{ good - after not final channelDifference was received }%1"
 			).arg(_session->mtp().isTestMode() ? " TESTMODE" : ""));
 		getChannelDifference(channel);
-	} else if (ranges::contains(
-			_activeChats,
-			channel,
-			[](const auto &pair) { return pair.second.peer; })) {
+	} else if (isActiveChat(channel)) {
 		channel->ptsWaitingForShortPoll(timeout
 			? (timeout * crl::time(1000))
 			: kWaitForChannelGetDifference);
@@ -684,7 +684,21 @@ void Updates::getChannelDifference(
 		_whenGetDiffByPts.remove(channel);
 	}
 
-	if (!channel->ptsInited() || channel->ptsRequesting()) return;
+	if (!channel->ptsInited()) {
+		return;
+	} else if (channel->ptsRequesting()) {
+		if (from == ChannelDifferenceRequest::PtsGapOrShortPoll) {
+			// The queued request is not sent yet, it will be forced.
+			const auto i = ranges::find(
+				_channelDifferenceQueue,
+				channel,
+				&QueuedChannelDifference::channel);
+			if (i != end(_channelDifferenceQueue)) {
+				i->ptsGap = true;
+			}
+		}
+		return;
+	}
 
 	if (from != ChannelDifferenceRequest::AfterFail) {
 		_whenGetDiffAfterFail.remove(channel);
@@ -692,24 +706,89 @@ void Updates::getChannelDifference(
 
 	channel->ptsSetRequesting(true);
 
-	auto filter = MTP_channelMessagesFilterEmpty();
-	auto flags = MTPupdates_GetChannelDifference::Flag::f_force | 0;
-	if (from != ChannelDifferenceRequest::PtsGapOrShortPoll) {
-		if (!channel->ptsWaitingForSkipped()) {
-			flags = 0; // No force flag when requesting for short poll.
-		}
+	if (!_channelDifferencesSending && _channelDifferenceQueue.empty()) {
+		_channelCatchUp = ChannelCatchUp{ .started = crl::now() };
 	}
-	api().request(MTPupdates_GetChannelDifference(
-		MTP_flags(flags),
-		channel->inputChannel,
-		filter,
-		MTP_int(channel->pts()),
-		MTP_int(kChannelGetDifferenceLimit)
-	)).done([=](const MTPupdates_ChannelDifference &result) {
-		channelDifferenceDone(channel, result);
-	}).fail([=](const MTP::Error &error) {
-		channelDifferenceFail(channel, error);
-	}).send();
+	_channelDifferenceQueue.push_back({
+		.channel = channel,
+		.ptsGap = (from == ChannelDifferenceRequest::PtsGapOrShortPoll),
+		.queued = crl::now(),
+	});
+	sendChannelDifferences();
+}
+
+void Updates::sendChannelDifferences() {
+	const auto now = crl::now();
+	while (_channelDifferencesSending < kChannelGetDifferenceParallel
+		&& !_channelDifferenceQueue.empty()) {
+		const auto i = ranges::min_element(
+			_channelDifferenceQueue,
+			ranges::less(),
+			[&](const QueuedChannelDifference &queued) {
+				return channelDifferencePriority(queued.channel);
+			});
+		const auto queued = *i;
+		const auto channel = queued.channel;
+		_channelDifferenceQueue.erase(i);
+
+		++_channelDifferencesSending;
+		accumulate_max(_channelCatchUp.maxLag, now - queued.queued);
+
+		// No force flag when requesting for short poll.
+		auto flags = MTPupdates_GetChannelDifference::Flags(0);
+		if (queued.ptsGap || channel->ptsWaitingForSkipped()) {
+			flags |= MTPupdates_GetChannelDifference::Flag::f_force;
+		}
+		api().request(MTPupdates_GetChannelDifference(
+			MTP_flags(flags),
+			channel->inputChannel,
+			MTP_channelMessagesFilterEmpty(),
+			MTP_int(channel->pts()),
+			MTP_int(kChannelGetDifferenceLimit)
+		)).done([=](const MTPupdates_ChannelDifference &result) {
+			channelDifferenceDone(channel, result);
+			channelDifferenceFinished();
+		}).fail([=](const MTP::Error &error) {
+			channelDifferenceFail(channel, error);
+			channelDifferenceFinished();
+		}).send();
+	}
+}
+
+void Updates::channelDifferenceFinished() {
+	--_channelDifferencesSending;
+	++_channelCatchUp.done;
+	sendChannelDifferences();
+	if (_channelDifferencesSending || !_channelDifferenceQueue.empty()) {
+		return;
+	}
+	MTP_LOG(0, ("getChannelDifference "
+		"{ catch up finished: %1 requests in %2ms, max lag %3ms }%4"
+		).arg(_channelCatchUp.done
+		).arg(crl::now() - _channelCatchUp.started
+		).arg(_channelCatchUp.maxLag
+		).arg(_session->mtp().isTestMode() ? " TESTMODE" : ""));
+}
+
+int Updates::channelDifferencePriority(
+		not_null<ChannelData*> channel) const {
+	if (isActiveChat(channel)) {
+		return 0;
+	}
+	const auto history = session().data().historyLoaded(channel->id);
+	if (history && history->isPinnedDialog(FilterId())) {
+		return 1;
+	} else if (!session().data().notifyIsMuted(channel)) {
+		return 2;
+	}
+	return 3;
+}
+
+bool Updates::isActiveChat(not_null<PeerData*> peer) const {
+	return ranges::contains(
+		_activeChats,
+		peer.get(),
+		[](const auto &pair) { return pair.second.peer; });
 }
 
 void Updates::sendPing() {
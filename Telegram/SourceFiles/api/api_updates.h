@@ -81,6 +81,20 @@ private:
 		PeerData *peer = nullptr;
 		rpl::lifetime lifetime;
 	};
+	struct QueuedChannelDifference {
+		not_null<ChannelData*> channel;
+		bool ptsGap = false;
+		crl::time queued = 0;
+	};
+
+	// Stats of the current channel differences catch up, reset when
+	// a new one starts after all the previous requests are finished.
+	// They are only written to the MTP log.
+	struct ChannelCatchUp {
+		int done = 0;
+		crl::time maxLag = 0;
+		crl::time started = 0;
+	};
 
 	void channelRangeDifferenceSend(
 		not_null<ChannelData*> channel,
@@ -119,6 +133,11 @@ private:
 		const MTP::Error &error);
 	void failDifferenceStartTimerFor(ChannelData *channel);
 	void feedChannelDifference(const MTPDupdates_channelDifference &data);
+	void sendChannelDifferences();
+	void channelDifferenceFinished();
+	[[nodiscard]] int channelDifferencePriority(
+		not_null<ChannelData*> channel) const;
+	[[nodiscard]] bool isActiveChat(not_null<PeerData*> peer) const;
 
 	void mtpUpdateReceived(const MTPUpdates &updates);
 	void mtpNewSessionCreated();
@@ -197,6 +216,12 @@ private:
 	bool _handlingChannelDifference = false;
 
 	base::flat_map<int, ActiveChatTracker> _activeChats;
+
+	// Channel differences wait here while too many are being requested,
+	// the open chats go first, then the pinned and the unmuted ones.
+	std::vector<QueuedChannelDifference> _channelDifferenceQueue;
+	int _channelDifferencesSending = 0;
+	ChannelCatchUp _channelCatchUp;
 	base::flat_map<
 		not_null<PeerData*>,
 		base::flat_map<PeerId, crl::time>> _pendingSpeakingCallParticipants;
@@ -166,22 +166,28 @@ struct State {
 	if (context->subscriptions.contains(session)) {
 		return context;
 	}
-	session->changes().messageUpdates(
-		Data::MessageUpdate::Flag::Destroyed
-	) | rpl::start_with_next([=](const Data::MessageUpdate &update) {
-		const auto i = context->cachedRead.find(update.item);
+	const auto forget = [=](not_null<const HistoryItem*> item) {
+		const auto i = context->cachedRead.find(item);
 		if (i != end(context->cachedRead)) {
 			session->api().request(i->second.requestId).cancel();
 			context->cachedRead.erase(i);
 		}
-		const auto j = context->cachedReacted.find(update.item);
+		const auto j = context->cachedReacted.find(item);
 		if (j != end(context->cachedReacted)) {
 			for (auto &[reaction, entry] : j->second) {
 				session->api().request(entry.requestId).cancel();
 			}
 			context->cachedReacted.erase(j);
 		}
-	}, context->subscriptions[session]);
+	};
+	auto &lifetime = context->subscriptions[session];
+	session->changes().messageUpdates(
+		Data::MessageUpdate::Flag::Destroyed
+	) | rpl::start_with_next([=](const Data::MessageUpdate &update) {
+		forget(update.item);
+	}, lifetime);
+	session->data().itemUnloaded(
+	) | rpl::start_with_next(forget, lifetime);
 	return context;
 }
 
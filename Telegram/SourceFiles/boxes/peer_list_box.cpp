@@ -36,6 +36,16 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <rpl/range.h>
 
+namespace {
+
+// Rows keep their texts and userpic views only while they are close to
+// the visible area, far rows are unloaded to lightweight records, so that
+// scrolling through a very large list doesn't keep all of them in memory.
+constexpr auto kKeepMaterializedRowsCount = 200;
+constexpr auto kKeepMaterializedHeights = 3;
+
+} // namespace
+
 PaintRoundImageCallback PaintUserpicCallback(
 		not_null<PeerData*> peer,
 		bool respectSavedMessagesChat) {
@@ -611,6 +621,26 @@ std::shared_ptr<Data::CloudImageView> &PeerListRow::ensureUserpicView() {
 	return _userpic;
 }
 
+void PeerListRow::unloadLazy() {
+	_userpic = nullptr;
+	if (_ripple && _ripple->empty()) {
+		_ripple = nullptr;
+	}
+	invalidatePixmapsCache();
+	if (!_initialized) {
+		return;
+	}
+	_initialized = false;
+	_name = Ui::Text::String();
+
+	// Custom statuses are set from outside and can't be generated again.
+	if (_statusType != StatusType::Custom
+		&& _statusType != StatusType::CustomActive) {
+		_status = Ui::Text::String();
+		_statusValidTill = 0;
+	}
+}
+
 PaintRoundImageCallback PeerListRow::generatePaintUserpicCallback() {
 	const auto saved = _isSavedMessagesChat;
 	const auto replies = _isRepliesMessagesChat;
@@ -1010,7 +1040,7 @@ void PeerListContent::addRowEntry(not_null<PeerListRow*> row) {
 	}
 	_rowsById.emplace(row->id(), row);
 	if (!row->special()) {
-		_rowsByPeer[row->peer()].push_back(row);
+		_rowsByPeer.emplace(row->peer(), row);
 	}
 	if (addingToSearchIndex()) {
 		addToSearchIndex(row);
@@ -1040,7 +1070,7 @@ void PeerListContent::addToSearchIndex(not_null<PeerListRow*> row) {
 	removeFromSearchIndex(row);
 	row->setNameFirstLetters(row->peer()->nameFirstLetters());
 	for (auto ch : row->nameFirstLetters()) {
-		_searchIndex[ch].push_back(row);
+		_searchIndex[ch].emplace(row);
 	}
 }
 
@@ -1049,9 +1079,9 @@ void PeerListContent::removeFromSearchIndex(not_null<PeerListRow*> row) {
 	if (!nameFirstLetters.empty()) {
 		for (auto ch : row->nameFirstLetters()) {
 			auto it = _searchIndex.find(ch);
-			if (it != _searchIndex.cend()) {
+			if (it != end(_searchIndex)) {
 				auto &entry = it->second;
-				entry.erase(ranges::remove(entry, row), end(entry));
+				entry.erase(row);
 				if (entry.empty()) {
 					_searchIndex.erase(it);
 				}
@@ -1135,14 +1165,20 @@ void PeerListContent::removeRow(not_null<PeerListRow*> row) {
 
 	_rowsById.erase(row->id());
 	if (!row->special()) {
-		auto &byPeer = _rowsByPeer[row->peer()];
-		byPeer.erase(ranges::remove(byPeer, row), end(byPeer));
+		auto [i, e] = _rowsByPeer.equal_range(row->peer());
+		for (; i != e; ++i) {
+			if (i->second == row) {
+				_rowsByPeer.erase(i);
+				break;
+			}
+		}
 	}
 	removeFromSearchIndex(row);
 	_filterResults.erase(
 		ranges::remove(_filterResults, row),
 		end(_filterResults));
 	_hiddenRows.remove(row);
+	_materializedRows.remove(row);
 	removeRowAtIndex(eraseFrom, index);
 
 	restoreSelection();
@@ -1160,6 +1196,7 @@ void PeerListContent::clearAllContent() {
 	_rowsByPeer.clear();
 	_filterResults.clear();
 	_searchIndex.clear();
+	_materializedRows.clear();
 	_rows.clear();
 	_searchRows.clear();
 	_searchQuery
@@ -1579,6 +1616,7 @@ crl::time PeerListContent::paintRow(
 	Assert(row != nullptr);
 
 	row->lazyInitialize(_st.item);
+	_materializedRows.emplace(row);
 	const auto outerWidth = width();
 
 	auto refreshStatusAt = row->refreshStatusTime();
@@ -1826,12 +1864,44 @@ void PeerListContent::loadProfilePhotos() {
 				const auto row = getRow(RowIndex(index));
 				if (!row->special()) {
 					row->peer()->loadUserpic();
+					_materializedRows.emplace(row);
 				}
 			}
 		}
 	}
 }
 
+void PeerListContent::unloadFarRows() {
+	if (_materializedRows.size() <= kKeepMaterializedRowsCount
+		|| _visibleTop >= _visibleBottom
+		|| _rowHeight <= 0) {
+		return;
+	}
+	const auto keep = (_visibleBottom - _visibleTop)
+		* kKeepMaterializedHeights;
+	const auto count = shownRowsCount();
+	const auto from = std::max(
+		(_visibleTop - rowsTop() - keep) / _rowHeight,
+		0);
+	const auto till = std::min(
+		(_visibleBottom - rowsTop() + keep) / _rowHeight + 1,
+		count);
+	auto near = base::flat_set<not_null<PeerListRow*>>();
+	near.reserve(std::max(till - from, 0));
+	for (auto index = from; index < till; ++index) {
+		near.emplace(getRow(RowIndex(index)));
+	}
+	for (auto i = begin(_materializedRows); i != end(_materializedRows);) {
+		const auto row = *i;
+		if (near.contains(row)) {
+			++i;
+		} else {
+			row->unloadLazy();
+			i = _materializedRows.erase(i);
+		}
+	}
+}
+
 void PeerListContent::checkScrollForPreload() {
 	if (_visibleBottom + PreloadHeightsCount * (_visibleBottom - _visibleTop) >= height()) {
 		_controller->loadMoreRows();
@@ -1846,11 +1916,11 @@ void PeerListContent::searchQueryChanged(QString query) {
 		if (_controller->searchInLocal() && !searchWordsList.isEmpty()) {
 			Assert(_hiddenRows.empty());
 
-			auto minimalList = (const std::vector<not_null<PeerListRow*>>*)nullptr;
+			auto minimalList = (const SearchIndexRows*)nullptr;
 			for (const auto &searchWord : searchWordsList) {
 				auto searchWordStart = searchWord[0].toLower();
 				auto it = _searchIndex.find(searchWordStart);
-				if (it == _searchIndex.cend()) {
+				if (it == end(_searchIndex)) {
 					// Some word can't be found in any row.
 					minimalList = nullptr;
 					break;
@@ -1885,6 +1955,10 @@ void PeerListContent::searchQueryChanged(QString query) {
 						_filterResults.push_back(row);
 					}
 				}
+				ranges::sort(_filterResults, ranges::less(), [](
+						not_null<PeerListRow*> row) {
+					return row->absoluteIndex();
+				});
 			}
 		}
 		if (_controller->hasComplexSearch()) {
@@ -1975,6 +2049,7 @@ void PeerListContent::visibleTopBottomUpdated(
 	_visibleBottom = visibleBottom;
 	loadProfilePhotos();
 	checkScrollForPreload();
+	unloadFarRows();
 }
 
 void PeerListContent::setSelected(Selected selected) {
@@ -2168,15 +2243,14 @@ PeerListContent::RowIndex PeerListContent::findRowIndex(
 }
 
 void PeerListContent::handleNameChanged(not_null<PeerData*> peer) {
-	auto byPeer = _rowsByPeer.find(peer);
-	if (byPeer != _rowsByPeer.cend()) {
-		for (auto row : byPeer->second) {
-			if (addingToSearchIndex()) {
-				addToSearchIndex(row);
-			}
-			row->refreshName(_st.item);
-			updateRow(row);
+	const auto [from, till] = _rowsByPeer.equal_range(peer);
+	for (auto i = from; i != till; ++i) {
+		const auto row = i->second;
+		if (addingToSearchIndex()) {
+			addToSearchIndex(row);
 		}
+		row->refreshName(_st.item);
+		updateRow(row);
 	}
 }
 
@@ -85,6 +85,10 @@ public:
 
 	[[nodiscard]] std::shared_ptr<Data::CloudImageView> &ensureUserpicView();
 
+	// Drops the texts and the userpic view, the row becomes a lightweight
+	// record until lazyInitialize() is called for it again.
+	virtual void unloadLazy();
+
 	[[nodiscard]] virtual QString generateName();
 	[[nodiscard]] virtual QString generateShortName();
 	[[nodiscard]] virtual auto generatePaintUserpicCallback()
@@ -633,9 +637,6 @@ public:
 	template <typename ReorderCallback>
 	void reorderRows(ReorderCallback &&callback) {
 		callback(_rows.begin(), _rows.end());
-		for (auto &searchEntity : _searchIndex) {
-			callback(searchEntity.second.begin(), searchEntity.second.end());
-		}
 		refreshIndices();
 		if (!_hiddenRows.empty()) {
 			callback(_filterResults.begin(), _filterResults.end());
@@ -678,6 +679,8 @@ private:
 
 	void invalidatePixmapsCache();
 
+	using SearchIndexRows = std::unordered_set<not_null<PeerListRow*>>;
+
 	struct RowIndex {
 		RowIndex() {
 		}
@@ -731,6 +734,7 @@ private:
 	void selectByMouse(QPoint globalPosition);
 	void loadProfilePhotos();
 	void checkScrollForPreload();
+	void unloadFarRows();
 
 	void updateRow(not_null<PeerListRow*> row, RowIndex hint);
 	void updateRow(RowIndex row);
@@ -796,17 +800,28 @@ private:
 
 	rpl::event_stream<Ui::ScrollToRequest> _scrollToRequests;
 
+	// Rows prepare their texts and userpic views only when they come close
+	// to the visible area and far rows drop them, so most of the rows of
+	// a huge list are lightweight records with ids and flags.
 	std::vector<std::unique_ptr<PeerListRow>> _rows;
 	std::map<PeerListRowId, not_null<PeerListRow*>> _rowsById;
-	std::map<PeerData*, std::vector<not_null<PeerListRow*>>> _rowsByPeer;
+	std::unordered_multimap<
+		not_null<PeerData*>,
+		not_null<PeerListRow*>> _rowsByPeer;
 
-	std::map<QChar, std::vector<not_null<PeerListRow*>>> _searchIndex;
+	// Rows in each list are not ordered, search results are sorted
+	// by the row index after filtering, so reordering doesn't touch them.
+	base::flat_map<QChar, SearchIndexRows> _searchIndex;
 	QString _searchQuery;
 	QString _normalizedSearchQuery;
 	QString _mentionHighlight;
 	std::vector<not_null<PeerListRow*>> _filterResults;
 	base::flat_set<not_null<PeerListRow*>> _hiddenRows;
 
+	// Rows that were prepared to be painted and may hold their texts
+	// and userpic views.
+	base::flat_set<not_null<PeerListRow*>> _materializedRows;
+
 	int _aboveHeight = 0;
 	int _belowHeight = 0;
 	bool _hideEmpty = false;
@@ -23,6 +23,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "window/window_session_controller.h"
 #include "main/main_session.h"
 #include "data/data_session.h"
+#include "data/data_histories.h"
 #include "data/data_changes.h"
 #include "data/data_media_types.h"
 #include "data/data_user.h"
@@ -144,6 +145,9 @@ private:
 
 	std::unique_ptr<Ui::RippleAnimation> _actionRipple;
 
+	// Calls of the shown rows are not unloaded.
+	rpl::lifetime _messagesHold;
+
 };
 
 BoxController::Row::Row(not_null<HistoryItem*> item)
@@ -153,7 +157,8 @@ BoxController::Row::Row(not_null<HistoryItem*> item)
 , _type(ComputeType(item))
 , _st(ComputeCallType(item) == CallType::Voice
 		? &st::callReDial
-		: &st::callCameraReDial) {
+		: &st::callCameraReDial)
+, _messagesHold(Data::HoldMessages(item->history())) {
 	refreshStatus();
 }
 
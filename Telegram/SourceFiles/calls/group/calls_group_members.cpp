@@ -651,11 +651,24 @@ void Members::Controller::checkRowPosition(not_null<Row*> row) {
 		return;
 	}
 
+	if (!_peer->canManageGroupCall()) {
+		// Someone started speaking and has a non-speaking row above him.
+		// Bring all speaking up and this one to the top, that is the same
+		// order as sorting, but linear instead of sorting a huge list.
+		delegate()->peerListPartitionRows([](const PeerListRow &other) {
+			return static_cast<const Row&>(other).speaking();
+		});
+		delegate()->peerListPartitionRows([&](const PeerListRow &other) {
+			return (&other == row.get());
+		});
+		return;
+	}
+
 	// Someone started speaking and has a non-speaking row above him.
 	// Or someone raised hand and has force muted above him.
 	// Or someone was forced muted and had can_unmute_self below him. Sort.
 	static constexpr auto kTop = std::numeric_limits<uint64>::max();
-	const auto projForAdmin = [&](const PeerListRow &other) {
+	const auto proj = [&](const PeerListRow &other) {
 		const auto &real = static_cast<const Row&>(other);
 		return real.speaking()
 			// Speaking 'row' to the top, all other speaking below it.
@@ -669,23 +682,11 @@ void Members::Controller::checkRowPosition(not_null<Row*> row) {
 			// All not force-muted lie between raised hands and speaking.
 			: (kTop - 2);
 	};
-	const auto projForOther = [&](const PeerListRow &other) {
-		const auto &real = static_cast<const Row&>(other);
-		return real.speaking()
-			// Speaking 'row' to the top, all other speaking below it.
-			? (&real == row.get() ? kTop : (kTop - 1))
-			: 0ULL;
-	};
-
-	using Comparator = Fn<bool(const PeerListRow&, const PeerListRow&)>;
-	const auto makeComparator = [&](const auto &proj) -> Comparator {
-		return [&](const PeerListRow &a, const PeerListRow &b) {
-			return proj(a) > proj(b);
-		};
-	};
-	delegate()->peerListSortRows(_peer->canManageGroupCall()
-		? makeComparator(projForAdmin)
-		: makeComparator(projForOther));
+	delegate()->peerListSortRows([&](
+			const PeerListRow &a,
+			const PeerListRow &b) {
+		return proj(a) > proj(b);
+	});
 }
 
 void Members::Controller::updateRow(
@@ -886,8 +887,25 @@ void Members::Controller::prepareRows(not_null<Data::GroupCall*> real) {
 			delegate()->peerListAppendRow(std::move(row));
 		}
 	}
-	for (const auto &participant : real->participants()) {
-		if (auto row = createRow(participant)) {
+	// The participants list is not ordered, removals reorder it.
+	// Speaking first, then raised hands, then the recently active ones.
+	using Participant = Data::GroupCallParticipant;
+	const auto &participants = real->participants();
+	auto sorted = std::vector<not_null<const Participant*>>();
+	sorted.reserve(participants.size());
+	for (const auto &participant : participants) {
+		sorted.push_back(&participant);
+	}
+	ranges::sort(sorted, std::greater<>(), [](
+			not_null<const Participant*> participant) {
+		return std::make_tuple(
+			bool(participant->speaking),
+			participant->raisedHandRating,
+			participant->lastActive,
+			participant->date);
+	});
+	for (const auto participant : sorted) {
+		if (auto row = createRow(*participant)) {
 			changed = true;
 			delegate()->peerListAppendRow(std::move(row));
 		}
@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "calls/group/calls_group_common.h"
 #include "calls/group/calls_group_viewport_tile.h"
 #include "calls/group/calls_group_members_row.h"
+#include "core/core_parallel.h"
 #include "data/data_peer.h"
 #include "media/view/media_view_pip.h"
 #include "webrtc/webrtc_video_track.h"
@@ -23,8 +24,116 @@ namespace {
 
 constexpr auto kBlurRadius = 15;
 
+[[nodiscard]] inline uint32 YUVToARGB(int y, int u, int v) {
+	// BT.601 limited range, 8 bit fixed point.
+	const auto c = 298 * (y - 16) + 128;
+	const auto d = u - 128;
+	const auto e = v - 128;
+	const auto r = std::clamp((c + 409 * e) >> 8, 0, 255);
+	const auto g = std::clamp((c - 100 * d - 208 * e) >> 8, 0, 255);
+	const auto b = std::clamp((c + 516 * d) >> 8, 0, 255);
+	return 0xFF000000U | (uint32(r) << 16) | (uint32(g) << 8) | uint32(b);
+}
+
+// Averages the luma over the source pixels of each target pixel and
+// takes the chroma from the middle of them, so that only the pixels
+// of the target size are converted to ARGB32. Used only for the sizes
+// not larger than the source, upscaling that way would be blocky.
+[[nodiscard]] QImage ScaleYUV420(
+		const Webrtc::FrameYUV420 &yuv,
+		QSize size) {
+	const auto sourceWidth = yuv.size.width();
+	const auto sourceHeight = yuv.size.height();
+	const auto width = size.width();
+	const auto height = size.height();
+	const auto edges = [](int source, int target) {
+		auto result = std::vector<int>(target + 1);
+		for (auto i = 0; i != target; ++i) {
+			result[i] = int(int64(i) * source / target);
+		}
+		result[target] = source;
+		return result;
+	};
+	const auto columns = edges(sourceWidth, width);
+	const auto rows = edges(sourceHeight, height);
+	const auto y = static_cast<const uchar*>(yuv.y.data);
+	const auto u = static_cast<const uchar*>(yuv.u.data);
+	const auto v = static_cast<const uchar*>(yuv.v.data);
+
+	auto result = QImage(size, QImage::Format_ARGB32_Premultiplied);
+	for (auto row = 0; row != height; ++row) {
+		const auto fromRow = rows[row];
+		const auto tillRow = std::max(rows[row + 1], fromRow + 1);
+		const auto chromaRow = ((fromRow + tillRow) / 2) / 2;
+		const auto uLine = u + chromaRow * yuv.u.stride;
+		const auto vLine = v + chromaRow * yuv.v.stride;
+		auto to = reinterpret_cast<uint32*>(result.scanLine(row));
+		for (auto column = 0; column != width; ++column) {
+			const auto fromColumn = columns[column];
+			const auto tillColumn = std::max(
+				columns[column + 1],
+				fromColumn + 1);
+			auto sum = 0;
+			for (auto i = fromRow; i != tillRow; ++i) {
+				const auto line = y + i * yuv.y.stride;
+				for (auto j = fromColumn; j != tillColumn; ++j) {
+					sum += line[j];
+				}
+			}
+			const auto count = (tillRow - fromRow) * (tillColumn - fromColumn);
+			const auto chromaColumn = ((fromColumn + tillColumn) / 2) / 2;
+			*to++ = YUVToARGB(
+				sum / count,
+				uLine[chromaColumn],
+				vLine[chromaColumn]);
+		}
+	}
+	return result;
+}
+
+[[nodiscard]] QImage ScaleFrame(
+		const Webrtc::FrameWithInfo &data,
+		QSize size) {
+	if (data.format == Webrtc::FrameFormat::ARGB32) {
+		return data.original.scaled(
+			size,
+			Qt::IgnoreAspectRatio,
+			Qt::SmoothTransformation);
+	}
+	Assert(data.yuv420 != nullptr);
+	const auto &yuv = *data.yuv420;
+	if (size.width() <= yuv.size.width()
+		&& size.height() <= yuv.size.height()) {
+		return ScaleYUV420(yuv, size);
+	}
+	return ScaleYUV420(yuv, yuv.size).scaled(
+		size,
+		Qt::IgnoreAspectRatio,
+		Qt::SmoothTransformation);
+}
+
+[[nodiscard]] QSize FrameSize(const Webrtc::FrameWithInfo &data) {
+	return (data.format == Webrtc::FrameFormat::ARGB32)
+		? data.original.size()
+		: data.yuv420
+		? data.yuv420->size
+		: QSize();
+}
+
 } // namespace
 
+struct Viewport::RendererSW::TileFrame {
+	not_null<VideoTile*> tile;
+	not_null<TileData*> data;
+	Webrtc::FrameWithInfo frame;
+	QRect target;
+	QSize scaledSize;
+	int rotation = 0;
+	bool userpic = false;
+	bool paused = false;
+	bool scale = false;
+};
+
 Viewport::RendererSW::RendererSW(not_null<Viewport*> owner)
 : _owner(owner)
 , _pinIcon(st::groupCallVideoTile.pin)
@@ -46,10 +155,32 @@ void Viewport::RendererSW::paintFallback(
 		tileData.stale = true;
 	}
 	for (const auto &tile : _owner->_tiles) {
-		if (!tile->visible()) {
-			continue;
+		if (tile->visible()) {
+			_tileData[tile.get()].stale = false;
 		}
-		paintTile(p, tile.get(), bounding, bg);
+	}
+
+	// The frames point into the flat_map, including from the worker
+	// threads of validateFrames(). All the entries are inserted above and
+	// the stale ones are erased only after the painting, so the map is
+	// not changed while the pointers are used.
+	auto frames = std::vector<TileFrame>();
+	for (const auto &tile : _owner->_tiles) {
+		if (tile->visible()) {
+			const auto raw = tile.get();
+			const auto i = _tileData.find(raw);
+			Assert(i != end(_tileData));
+			frames.push_back({
+				.tile = raw,
+				.data = &i->second,
+				.frame = raw->track()->frameWithInfo(false),
+			});
+		}
+	}
+	validateFrames(frames);
+	for (const auto &frame : frames) {
+		paintTile(p, frame, bounding, bg);
+		frame.tile->track()->markFrameShown();
 	}
 	for (const auto &rect : bg) {
 		p.fillRect(rect, st::groupCallBg);
@@ -65,8 +196,9 @@ void Viewport::RendererSW::paintFallback(
 
 void Viewport::RendererSW::validateUserpicFrame(
 		not_null<VideoTile*> tile,
-		TileData &data) {
-	if (!_userpicFrame) {
+		TileData &data,
+		bool userpic) {
+	if (!userpic) {
 		data.userpicFrame = QImage();
 		return;
 	} else if (!data.userpicFrame.isNull()) {
@@ -81,37 +213,86 @@ void Viewport::RendererSW::validateUserpicFrame(
 		kBlurRadius);
 }
 
-void Viewport::RendererSW::paintTile(
-		Painter &p,
-		not_null<VideoTile*> tile,
-		const QRect &clip,
-		QRegion &bg) {
-	const auto track = tile->track();
-	const auto markGuard = gsl::finally([&] {
-		tile->track()->markFrameShown();
+void Viewport::RendererSW::validateFrames(std::vector<TileFrame> &frames) {
+	auto scale = std::vector<not_null<TileFrame*>>();
+	for (auto &frame : frames) {
+		validateFrame(frame);
+		if (frame.scale) {
+			scale.push_back(&frame);
+		}
+	}
+	Core::ProcessInParallel(int(scale.size()), [&](int index) {
+		const auto frame = scale[index];
+		frame->data->scaledFrame = ScaleFrame(frame->frame, frame->scaledSize);
 	});
-	const auto data = track->frameWithInfo(true);
-	auto &tileData = _tileData[tile];
-	tileData.stale = false;
-	_userpicFrame = (data.format == Webrtc::FrameFormat::None);
-	_pausedFrame = (track->state() == Webrtc::VideoState::Paused);
-	validateUserpicFrame(tile, tileData);
-	if (_userpicFrame || !_pausedFrame) {
+	for (const auto frame : scale) {
+		frame->data->scaledFrameIndex = frame->frame.index;
+	}
+}
+
+void Viewport::RendererSW::validateFrame(TileFrame &frame) {
+	const auto tile = frame.tile;
+	const auto &data = frame.frame;
+	auto &tileData = *frame.data;
+	frame.userpic = (data.format == Webrtc::FrameFormat::None);
+	frame.paused = (tile->track()->state() == Webrtc::VideoState::Paused);
+	validateUserpicFrame(tile, tileData, frame.userpic);
+	if (frame.userpic || !frame.paused) {
 		tileData.blurredFrame = QImage();
 	} else if (tileData.blurredFrame.isNull()) {
 		tileData.blurredFrame = Images::BlurLargeImage(
-			data.original.scaled(
+			ScaleFrame(data, FrameSize(data).scaled(
 				VideoTile::PausedVideoSize(),
-				Qt::KeepAspectRatio),
+				Qt::KeepAspectRatio)),
 			kBlurRadius);
 	}
+	if (frame.userpic || frame.paused) {
+		tileData.scaledFrame = QImage();
+		tileData.scaledFrameIndex = -1;
+	}
+	frame.rotation = frame.userpic ? 0 : data.rotation;
+	const auto size = frame.userpic
+		? tileData.userpicFrame.size()
+		: frame.paused
+		? tileData.blurredFrame.size()
+		: FrameSize(data);
+	Assert(!size.isEmpty());
+
+	using namespace Media::View;
+	const auto geometry = tile->geometry();
+	const auto scaled = FlipSizeByRotation(
+		size,
+		frame.rotation
+	).scaled(geometry.size(), Qt::KeepAspectRatio);
+	frame.target = QRect(
+		geometry.topLeft() + QPoint(
+			(geometry.width() - scaled.width()) / 2,
+			(geometry.height() - scaled.height()) / 2),
+		scaled);
+	if (frame.userpic || frame.paused || scaled.isEmpty()) {
+		return;
+	}
+	const auto factor = style::DevicePixelRatio();
+	frame.scaledSize = FlipSizeByRotation(scaled, frame.rotation) * factor;
+	frame.scale = (tileData.scaledFrameIndex != data.index)
+		|| (tileData.scaledFrame.size() != frame.scaledSize);
+}
+
+void Viewport::RendererSW::paintTile(
+		Painter &p,
+		const TileFrame &frame,
+		const QRect &clip,
+		QRegion &bg) {
+	const auto tile = frame.tile;
+	const auto &tileData = *frame.data;
+	_userpicFrame = frame.userpic;
+	_pausedFrame = frame.paused;
 	const auto &image = _userpicFrame
 		? tileData.userpicFrame
 		: _pausedFrame
 		? tileData.blurredFrame
-		: data.original;
-	const auto frameRotation = _userpicFrame ? 0 : data.rotation;
-	Assert(!image.isNull());
+		: tileData.scaledFrame;
+	const auto frameRotation = frame.rotation;
 
 	const auto fill = [&](QRect rect) {
 		const auto intersected = rect.intersected(clip);
@@ -127,14 +308,12 @@ void Viewport::RendererSW::paintTile(
 	const auto y = geometry.y();
 	const auto width = geometry.width();
 	const auto height = geometry.height();
-	const auto scaled = FlipSizeByRotation(
-		image.size(),
-		frameRotation
-	).scaled(QSize(width, height), Qt::KeepAspectRatio);
-	const auto left = (width - scaled.width()) / 2;
-	const auto top = (height - scaled.height()) / 2;
-	const auto target = QRect(QPoint(x + left, y + top), scaled);
-	if (UsePainterRotation(frameRotation)) {
+	const auto target = frame.target;
+	const auto left = target.x() - x;
+	const auto top = target.y() - y;
+	if (target.isEmpty()) {
+		// Nothing to draw in an empty tile, only the background.
+	} else if (UsePainterRotation(frameRotation)) {
 		if (frameRotation) {
 			p.save();
 			p.rotate(frameRotation);
@@ -153,13 +332,13 @@ void Viewport::RendererSW::paintTile(
 	if (left > 0) {
 		fill({ x, y, left, height });
 	}
-	if (const auto right = left + scaled.width(); right < width) {
+	if (const auto right = left + target.width(); right < width) {
 		fill({ x + right, y, width - right, height });
 	}
 	if (top > 0) {
 		fill({ x, y, width, top });
 	}
-	if (const auto bottom = top + scaled.height(); bottom < height) {
+	if (const auto bottom = top + target.height(); bottom < height) {
 		fill({ x, y + bottom, width, height - bottom });
 	}
 
@@ -28,11 +28,19 @@ private:
 	struct TileData {
 		QImage userpicFrame;
 		QImage blurredFrame;
+		QImage scaledFrame;
+		int scaledFrameIndex = -1;
 		bool stale = false;
 	};
+	struct TileFrame;
+
+	// Video frames are scaled to the tile sizes on worker threads,
+	// the ones that didn't change since the last paint are reused.
+	void validateFrames(std::vector<TileFrame> &frames);
+	void validateFrame(TileFrame &frame);
 	void paintTile(
 		Painter &p,
-		not_null<VideoTile*> tile,
+		const TileFrame &frame,
 		const QRect &clip,
 		QRegion &bg);
 	void paintTileOutline(
@@ -51,7 +59,8 @@ private:
 		not_null<VideoTile*> tile);
 	void validateUserpicFrame(
 		not_null<VideoTile*> tile,
-		TileData &data);
+		TileData &data,
+		bool userpic);
 
 	const not_null<Viewport*> _owner;
 
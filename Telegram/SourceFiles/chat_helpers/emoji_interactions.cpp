@@ -55,17 +55,30 @@ EmojiInteractions::EmojiInteractions(not_null<Main::Session*> session)
 		| Data::MessageUpdate::Flag::Edited
 	) | rpl::start_with_next([=](const Data::MessageUpdate &update) {
 		if (update.flags & Data::MessageUpdate::Flag::Destroyed) {
-			_outgoing.remove(update.item);
-			_incoming.remove(update.item);
+			forgetItem(update.item);
 		} else if (update.flags & Data::MessageUpdate::Flag::Edited) {
 			checkEdition(update.item, _outgoing);
 			checkEdition(update.item, _incoming);
 		}
 	}, _lifetime);
+
+	_session->data().itemUnloaded(
+	) | rpl::start_with_next([=](not_null<const HistoryItem*> item) {
+		forgetItem(item);
+	}, _lifetime);
 }
 
 EmojiInteractions::~EmojiInteractions() = default;
 
+void EmojiInteractions::forgetItem(not_null<const HistoryItem*> item) {
+	for (const auto map : { &_outgoing, &_incoming }) {
+		const auto i = map->find(item);
+		if (i != end(*map)) {
+			map->erase(i);
+		}
+	}
+}
+
 void EmojiInteractions::checkEdition(
 		not_null<HistoryItem*> item,
 		base::flat_map<not_null<HistoryItem*>, std::vector<Animation>> &map) {
@@ -122,6 +122,7 @@ private:
 	void checkEdition(
 		not_null<HistoryItem*> item,
 		base::flat_map<not_null<HistoryItem*>, std::vector<Animation>> &map);
+	void forgetItem(not_null<const HistoryItem*> item);
 
 	const not_null<Main::Session*> _session;
 
@@ -95,7 +95,9 @@ EmojiPack::EmojiPack(not_null<Main::Session*> session)
 : _session(session) {
 	refresh();
 
-	session->data().itemRemoved(
+	rpl::merge(
+		session->data().itemRemoved(),
+		session->data().itemUnloaded()
 	) | rpl::filter([](not_null<const HistoryItem*> item) {
 		return item->isIsolatedEmoji();
 	}) | rpl::start_with_next([=](not_null<const HistoryItem*> item) {
@@ -26,6 +26,41 @@ namespace {
 
 constexpr auto kDontCacheLottieAfterArea = 512 * 512;
 
+struct SharedPlayerKey {
+	uint64 sessionUniqueId = 0;
+	DocumentId documentId = 0;
+	const Lottie::ColorReplacements *replacements = nullptr;
+	StickerLottieSize sizeTag = StickerLottieSize();
+	Lottie::Quality quality = Lottie::Quality();
+	int width = 0;
+	int height = 0;
+
+	friend inline bool operator<(
+			const SharedPlayerKey &a,
+			const SharedPlayerKey &b) {
+		return std::tie(
+			a.sessionUniqueId,
+			a.documentId,
+			a.replacements,
+			a.sizeTag,
+			a.quality,
+			a.width,
+			a.height) < std::tie(
+				b.sessionUniqueId,
+				b.documentId,
+				b.replacements,
+				b.sizeTag,
+				b.quality,
+				b.width,
+				b.height);
+	}
+};
+
+// The entries are removed when their players are destroyed.
+std::map<
+	SharedPlayerKey,
+	std::weak_ptr<Lottie::SinglePlayer>> SharedPlayers;
+
 } // namespace
 
 template <typename Method>
@@ -121,6 +156,44 @@ std::unique_ptr<Lottie::SinglePlayer> LottiePlayerFromDocument(
 	return LottieFromDocument(method, media, uint8(keyShift), box);
 }
 
+std::shared_ptr<Lottie::SinglePlayer> SharedLottiePlayer(
+		not_null<Data::DocumentMedia*> media,
+		const Lottie::ColorReplacements *replacements,
+		StickerLottieSize sizeTag,
+		QSize box,
+		Lottie::Quality quality) {
+	const auto document = media->owner();
+	const auto key = SharedPlayerKey{
+		.sessionUniqueId = document->session().uniqueId(),
+		.documentId = document->id,
+		.replacements = replacements,
+		.sizeTag = sizeTag,
+		.quality = quality,
+		.width = box.width(),
+		.height = box.height(),
+	};
+	auto &weak = SharedPlayers[key];
+	if (auto result = weak.lock()) {
+		return result;
+	}
+	auto result = std::shared_ptr<Lottie::SinglePlayer>(
+		LottiePlayerFromDocument(
+			media,
+			replacements,
+			sizeTag,
+			box,
+			quality).release(),
+		[=](Lottie::SinglePlayer *player) {
+			const auto i = SharedPlayers.find(key);
+			if (i != end(SharedPlayers) && i->second.expired()) {
+				SharedPlayers.erase(i);
+			}
+			delete player;
+		});
+	weak = result;
+	return result;
+}
+
 not_null<Lottie::Animation*> LottieAnimationFromDocument(
 		not_null<Lottie::MultiPlayer*> player,
 		not_null<Data::DocumentMedia*> media,
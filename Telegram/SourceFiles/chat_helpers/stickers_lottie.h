@@ -75,6 +75,16 @@ enum class StickerLottieSize : uchar {
 	QSize box,
 	Lottie::Quality quality = Lottie::Quality(),
 	std::shared_ptr<Lottie::FrameRenderer> renderer = nullptr);
+
+// Returns the player already used by another view for the same sticker
+// at the same size, if there is one, so that its frames are rendered once.
+// Such player is shared, so it is only good for looped playback.
+[[nodiscard]] std::shared_ptr<Lottie::SinglePlayer> SharedLottiePlayer(
+	not_null<Data::DocumentMedia*> media,
+	const Lottie::ColorReplacements *replacements,
+	StickerLottieSize sizeTag,
+	QSize box,
+	Lottie::Quality quality = Lottie::Quality());
 [[nodiscard]] not_null<Lottie::Animation*> LottieAnimationFromDocument(
 	not_null<Lottie::MultiPlayer*> player,
 	not_null<Data::DocumentMedia*> media,
@@ -0,0 +1,39 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <crl/crl_async.h>
+#include <crl/crl_semaphore.h>
+
+namespace Core {
+
+// Calls callback(index) for each index in [0, count). The first one is
+// processed on the calling thread and the rest on the worker threads.
+// Returns when all of them are processed.
+template <typename Callback>
+void ProcessInParallel(int count, Callback &&callback) {
+	if (count < 2) {
+		if (count > 0) {
+			callback(0);
+		}
+		return;
+	}
+	auto semaphore = crl::semaphore();
+	for (auto i = 1; i != count; ++i) {
+		crl::async([&, i] {
+			callback(i);
+			semaphore.release();
+		});
+	}
+	callback(0);
+	for (auto i = 1; i != count; ++i) {
+		semaphore.acquire();
+	}
+}
+
+} // namespace Core
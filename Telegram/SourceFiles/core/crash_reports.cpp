@@ -184,6 +184,12 @@ void WriteReportInfo(int signum, const char *name) {
 
 	dump() << "\nBacktrace omitted.\n";
 	dump() << "\n";
+
+	dump() << "Unwritten log entries:\n";
+	Logs::takeUnwritten([](const char *kind, const char *entry) {
+		dump() << "[" << kind << "] " << entry;
+	});
+	dump() << "\n";
 }
 
 const int HandledSignals[] = {
@@ -330,22 +330,17 @@ char *hashMd5Hex(const int32 *hashmd5, void *dest) {
 	return md5To;
 }
 
-namespace {
-	QMap<QString, QString> fastRusEng;
-	QHash<QChar, QString> fastLetterRusEng;
-	QMap<uint32, QString> fastDoubleLetterRusEng;
-	QHash<QChar, QChar> fastRusKeyboardSwitch;
-}
-
 QString translitLetterRusEng(QChar letter, QChar next, int32 &toSkip) {
-	if (fastDoubleLetterRusEng.isEmpty()) {
-		fastDoubleLetterRusEng.insert((QString::fromUtf8("Ы").at(0).unicode() << 16) | QString::fromUtf8("й").at(0).unicode(), qsl("Y"));
-		fastDoubleLetterRusEng.insert((QString::fromUtf8("и").at(0).unicode() << 16) | QString::fromUtf8("я").at(0).unicode(), qsl("ia"));
-		fastDoubleLetterRusEng.insert((QString::fromUtf8("и").at(0).unicode() << 16) | QString::fromUtf8("й").at(0).unicode(), qsl("y"));
-		fastDoubleLetterRusEng.insert((QString::fromUtf8("к").at(0).unicode() << 16) | QString::fromUtf8("с").at(0).unicode(), qsl("x"));
-		fastDoubleLetterRusEng.insert((QString::fromUtf8("ы").at(0).unicode() << 16) | QString::fromUtf8("й").at(0).unicode(), qsl("y"));
-		fastDoubleLetterRusEng.insert((QString::fromUtf8("ь").at(0).unicode() << 16) | QString::fromUtf8("е").at(0).unicode(), qsl("ye"));
-	}
+	static const auto fastDoubleLetterRusEng = [] {
+		auto result = QMap<uint32, QString>();
+		result.insert((QString::fromUtf8("Ы").at(0).unicode() << 16) | QString::fromUtf8("й").at(0).unicode(), qsl("Y"));
+		result.insert((QString::fromUtf8("и").at(0).unicode() << 16) | QString::fromUtf8("я").at(0).unicode(), qsl("ia"));
+		result.insert((QString::fromUtf8("и").at(0).unicode() << 16) | QString::fromUtf8("й").at(0).unicode(), qsl("y"));
+		result.insert((QString::fromUtf8("к").at(0).unicode() << 16) | QString::fromUtf8("с").at(0).unicode(), qsl("x"));
+		result.insert((QString::fromUtf8("ы").at(0).unicode() << 16) | QString::fromUtf8("й").at(0).unicode(), qsl("y"));
+		result.insert((QString::fromUtf8("ь").at(0).unicode() << 16) | QString::fromUtf8("е").at(0).unicode(), qsl("ye"));
+		return result;
+	}();
 	QMap<uint32, QString>::const_iterator i = fastDoubleLetterRusEng.constFind((letter.unicode() << 16) | next.unicode());
 	if (i != fastDoubleLetterRusEng.cend()) {
 		toSkip = 2;
@@ -353,84 +348,86 @@ QString translitLetterRusEng(QChar letter, QChar next, int32 &toSkip) {
 	}
 
 	toSkip = 1;
-	if (fastLetterRusEng.isEmpty()) {
-		fastLetterRusEng.insert(QString::fromUtf8("А").at(0), qsl("A"));
-		fastLetterRusEng.insert(QString::fromUtf8("Б").at(0), qsl("B"));
-		fastLetterRusEng.insert(QString::fromUtf8("В").at(0), qsl("V"));
-		fastLetterRusEng.insert(QString::fromUtf8("Г").at(0), qsl("G"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ґ").at(0), qsl("G"));
-		fastLetterRusEng.insert(QString::fromUtf8("Д").at(0), qsl("D"));
-		fastLetterRusEng.insert(QString::fromUtf8("Е").at(0), qsl("E"));
-		fastLetterRusEng.insert(QString::fromUtf8("Є").at(0), qsl("Ye"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ё").at(0), qsl("Yo"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ж").at(0), qsl("Zh"));
-		fastLetterRusEng.insert(QString::fromUtf8("З").at(0), qsl("Z"));
-		fastLetterRusEng.insert(QString::fromUtf8("И").at(0), qsl("I"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ї").at(0), qsl("Yi"));
-		fastLetterRusEng.insert(QString::fromUtf8("І").at(0), qsl("I"));
-		fastLetterRusEng.insert(QString::fromUtf8("Й").at(0), qsl("J"));
-		fastLetterRusEng.insert(QString::fromUtf8("К").at(0), qsl("K"));
-		fastLetterRusEng.insert(QString::fromUtf8("Л").at(0), qsl("L"));
-		fastLetterRusEng.insert(QString::fromUtf8("М").at(0), qsl("M"));
-		fastLetterRusEng.insert(QString::fromUtf8("Н").at(0), qsl("N"));
-		fastLetterRusEng.insert(QString::fromUtf8("О").at(0), qsl("O"));
-		fastLetterRusEng.insert(QString::fromUtf8("П").at(0), qsl("P"));
-		fastLetterRusEng.insert(QString::fromUtf8("Р").at(0), qsl("R"));
-		fastLetterRusEng.insert(QString::fromUtf8("С").at(0), qsl("S"));
-		fastLetterRusEng.insert(QString::fromUtf8("Т").at(0), qsl("T"));
-		fastLetterRusEng.insert(QString::fromUtf8("У").at(0), qsl("U"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ў").at(0), qsl("W"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ф").at(0), qsl("F"));
-		fastLetterRusEng.insert(QString::fromUtf8("Х").at(0), qsl("Kh"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ц").at(0), qsl("Ts"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ч").at(0), qsl("Ch"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ш").at(0), qsl("Sh"));
-		fastLetterRusEng.insert(QString::fromUtf8("Щ").at(0), qsl("Sch"));
-		fastLetterRusEng.insert(QString::fromUtf8("Э").at(0), qsl("E"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ю").at(0), qsl("Yu"));
-		fastLetterRusEng.insert(QString::fromUtf8("Я").at(0), qsl("Ya"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ў").at(0), qsl("W"));
-		fastLetterRusEng.insert(QString::fromUtf8("а").at(0), qsl("a"));
-		fastLetterRusEng.insert(QString::fromUtf8("б").at(0), qsl("b"));
-		fastLetterRusEng.insert(QString::fromUtf8("в").at(0), qsl("v"));
-		fastLetterRusEng.insert(QString::fromUtf8("г").at(0), qsl("g"));
-		fastLetterRusEng.insert(QString::fromUtf8("ґ").at(0), qsl("g"));
-		fastLetterRusEng.insert(QString::fromUtf8("д").at(0), qsl("d"));
-		fastLetterRusEng.insert(QString::fromUtf8("е").at(0), qsl("e"));
-		fastLetterRusEng.insert(QString::fromUtf8("є").at(0), qsl("ye"));
-		fastLetterRusEng.insert(QString::fromUtf8("ё").at(0), qsl("yo"));
-		fastLetterRusEng.insert(QString::fromUtf8("ж").at(0), qsl("zh"));
-		fastLetterRusEng.insert(QString::fromUtf8("з").at(0), qsl("z"));
-		fastLetterRusEng.insert(QString::fromUtf8("й").at(0), qsl("y"));
-		fastLetterRusEng.insert(QString::fromUtf8("ї").at(0), qsl("yi"));
-		fastLetterRusEng.insert(QString::fromUtf8("і").at(0), qsl("i"));
-		fastLetterRusEng.insert(QString::fromUtf8("л").at(0), qsl("l"));
-		fastLetterRusEng.insert(QString::fromUtf8("м").at(0), qsl("m"));
-		fastLetterRusEng.insert(QString::fromUtf8("н").at(0), qsl("n"));
-		fastLetterRusEng.insert(QString::fromUtf8("о").at(0), qsl("o"));
-		fastLetterRusEng.insert(QString::fromUtf8("п").at(0), qsl("p"));
-		fastLetterRusEng.insert(QString::fromUtf8("р").at(0), qsl("r"));
-		fastLetterRusEng.insert(QString::fromUtf8("с").at(0), qsl("s"));
-		fastLetterRusEng.insert(QString::fromUtf8("т").at(0), qsl("t"));
-		fastLetterRusEng.insert(QString::fromUtf8("у").at(0), qsl("u"));
-		fastLetterRusEng.insert(QString::fromUtf8("ў").at(0), qsl("w"));
-		fastLetterRusEng.insert(QString::fromUtf8("ф").at(0), qsl("f"));
-		fastLetterRusEng.insert(QString::fromUtf8("х").at(0), qsl("kh"));
-		fastLetterRusEng.insert(QString::fromUtf8("ц").at(0), qsl("ts"));
-		fastLetterRusEng.insert(QString::fromUtf8("ч").at(0), qsl("ch"));
-		fastLetterRusEng.insert(QString::fromUtf8("ш").at(0), qsl("sh"));
-		fastLetterRusEng.insert(QString::fromUtf8("щ").at(0), qsl("sch"));
-		fastLetterRusEng.insert(QString::fromUtf8("ъ").at(0), QString());
-		fastLetterRusEng.insert(QString::fromUtf8("э").at(0), qsl("e"));
-		fastLetterRusEng.insert(QString::fromUtf8("ю").at(0), qsl("yu"));
-		fastLetterRusEng.insert(QString::fromUtf8("я").at(0), qsl("ya"));
-		fastLetterRusEng.insert(QString::fromUtf8("ў").at(0), qsl("w"));
-		fastLetterRusEng.insert(QString::fromUtf8("Ы").at(0), qsl("Y"));
-		fastLetterRusEng.insert(QString::fromUtf8("и").at(0), qsl("i"));
-		fastLetterRusEng.insert(QString::fromUtf8("к").at(0), qsl("k"));
-		fastLetterRusEng.insert(QString::fromUtf8("ы").at(0), qsl("y"));
-		fastLetterRusEng.insert(QString::fromUtf8("ь").at(0), QString());
-	}
+	static const auto fastLetterRusEng = [] {
+		auto result = QHash<QChar, QString>();
+		result.insert(QString::fromUtf8("А").at(0), qsl("A"));
+		result.insert(QString::fromUtf8("Б").at(0), qsl("B"));
+		result.insert(QString::fromUtf8("В").at(0), qsl("V"));
+		result.insert(QString::fromUtf8("Г").at(0), qsl("G"));
+		result.insert(QString::fromUtf8("Ґ").at(0), qsl("G"));
+		result.insert(QString::fromUtf8("Д").at(0), qsl("D"));
+		result.insert(QString::fromUtf8("Е").at(0), qsl("E"));
+		result.insert(QString::fromUtf8("Є").at(0), qsl("Ye"));
+		result.insert(QString::fromUtf8("Ё").at(0), qsl("Yo"));
+		result.insert(QString::fromUtf8("Ж").at(0), qsl("Zh"));
+		result.insert(QString::fromUtf8("З").at(0), qsl("Z"));
+		result.insert(QString::fromUtf8("И").at(0), qsl("I"));
+		result.insert(QString::fromUtf8("Ї").at(0), qsl("Yi"));
+		result.insert(QString::fromUtf8("І").at(0), qsl("I"));
+		result.insert(QString::fromUtf8("Й").at(0), qsl("J"));
+		result.insert(QString::fromUtf8("К").at(0), qsl("K"));
+		result.insert(QString::fromUtf8("Л").at(0), qsl("L"));
+		result.insert(QString::fromUtf8("М").at(0), qsl("M"));
+		result.insert(QString::fromUtf8("Н").at(0), qsl("N"));
+		result.insert(QString::fromUtf8("О").at(0), qsl("O"));
+		result.insert(QString::fromUtf8("П").at(0), qsl("P"));
+		result.insert(QString::fromUtf8("Р").at(0), qsl("R"));
+		result.insert(QString::fromUtf8("С").at(0), qsl("S"));
+		result.insert(QString::fromUtf8("Т").at(0), qsl("T"));
+		result.insert(QString::fromUtf8("У").at(0), qsl("U"));
+		result.insert(QString::fromUtf8("Ў").at(0), qsl("W"));
+		result.insert(QString::fromUtf8("Ф").at(0), qsl("F"));
+		result.insert(QString::fromUtf8("Х").at(0), qsl("Kh"));
+		result.insert(QString::fromUtf8("Ц").at(0), qsl("Ts"));
+		result.insert(QString::fromUtf8("Ч").at(0), qsl("Ch"));
+		result.insert(QString::fromUtf8("Ш").at(0), qsl("Sh"));
+		result.insert(QString::fromUtf8("Щ").at(0), qsl("Sch"));
+		result.insert(QString::fromUtf8("Э").at(0), qsl("E"));
+		result.insert(QString::fromUtf8("Ю").at(0), qsl("Yu"));
+		result.insert(QString::fromUtf8("Я").at(0), qsl("Ya"));
+		result.insert(QString::fromUtf8("Ў").at(0), qsl("W"));
+		result.insert(QString::fromUtf8("а").at(0), qsl("a"));
+		result.insert(QString::fromUtf8("б").at(0), qsl("b"));
+		result.insert(QString::fromUtf8("в").at(0), qsl("v"));
+		result.insert(QString::fromUtf8("г").at(0), qsl("g"));
+		result.insert(QString::fromUtf8("ґ").at(0), qsl("g"));
+		result.insert(QString::fromUtf8("д").at(0), qsl("d"));
+		result.insert(QString::fromUtf8("е").at(0), qsl("e"));
+		result.insert(QString::fromUtf8("є").at(0), qsl("ye"));
+		result.insert(QString::fromUtf8("ё").at(0), qsl("yo"));
+		result.insert(QString::fromUtf8("ж").at(0), qsl("zh"));
+		result.insert(QString::fromUtf8("з").at(0), qsl("z"));
+		result.insert(QString::fromUtf8("й").at(0), qsl("y"));
+		result.insert(QString::fromUtf8("ї").at(0), qsl("yi"));
+		result.insert(QString::fromUtf8("і").at(0), qsl("i"));
+		result.insert(QString::fromUtf8("л").at(0), qsl("l"));
+		result.insert(QString::fromUtf8("м").at(0), qsl("m"));
+		result.insert(QString::fromUtf8("н").at(0), qsl("n"));
+		result.insert(QString::fromUtf8("о").at(0), qsl("o"));
+		result.insert(QString::fromUtf8("п").at(0), qsl("p"));
+		result.insert(QString::fromUtf8("р").at(0), qsl("r"));
+		result.insert(QString::fromUtf8("с").at(0), qsl("s"));
+		result.insert(QString::fromUtf8("т").at(0), qsl("t"));
+		result.insert(QString::fromUtf8("у").at(0), qsl("u"));
+		result.insert(QString::fromUtf8("ў").at(0), qsl("w"));
+		result.insert(QString::fromUtf8("ф").at(0), qsl("f"));
+		result.insert(QString::fromUtf8("х").at(0), qsl("kh"));
+		result.insert(QString::fromUtf8("ц").at(0), qsl("ts"));
+		result.insert(QString::fromUtf8("ч").at(0), qsl("ch"));
+		result.insert(QString::fromUtf8("ш").at(0), qsl("sh"));
+		result.insert(QString::fromUtf8("щ").at(0), qsl("sch"));
+		result.insert(QString::fromUtf8("ъ").at(0), QString());
+		result.insert(QString::fromUtf8("э").at(0), qsl("e"));
+		result.insert(QString::fromUtf8("ю").at(0), qsl("yu"));
+		result.insert(QString::fromUtf8("я").at(0), qsl("ya"));
+		result.insert(QString::fromUtf8("ў").at(0), qsl("w"));
+		result.insert(QString::fromUtf8("Ы").at(0), qsl("Y"));
+		result.insert(QString::fromUtf8("и").at(0), qsl("i"));
+		result.insert(QString::fromUtf8("к").at(0), qsl("k"));
+		result.insert(QString::fromUtf8("ы").at(0), qsl("y"));
+		result.insert(QString::fromUtf8("ь").at(0), QString());
+		return result;
+	}();
 	QHash<QChar, QString>::const_iterator j = fastLetterRusEng.constFind(letter);
 	if (j != fastLetterRusEng.cend()) {
 		return j.value();
@@ -439,18 +436,22 @@ QString translitLetterRusEng(QChar letter, QChar next, int32 &toSkip) {
 }
 
 QString translitRusEng(const QString &rus) {
-	if (fastRusEng.isEmpty()) {
-		fastRusEng.insert(QString::fromUtf8("Александр"), qsl("Alexander"));
-		fastRusEng.insert(QString::fromUtf8("александр"), qsl("alexander"));
-		fastRusEng.insert(QString::fromUtf8("Филипп"), qsl("Philip"));
-		fastRusEng.insert(QString::fromUtf8("филипп"), qsl("philip"));
-		fastRusEng.insert(QString::fromUtf8("Пётр"), qsl("Petr"));
-		fastRusEng.insert(QString::fromUtf8("пётр"), qsl("petr"));
-		fastRusEng.insert(QString::fromUtf8("Гай"), qsl("Gai"));
-		fastRusEng.insert(QString::fromUtf8("гай"), qsl("gai"));
-		fastRusEng.insert(QString::fromUtf8("Ильин"), qsl("Ilyin"));
-		fastRusEng.insert(QString::fromUtf8("ильин"), qsl("ilyin"));
-	}
+	// Initialized once in a thread-safe way, names may be indexed
+	// on worker threads.
+	static const auto fastRusEng = [] {
+		auto result = QMap<QString, QString>();
+		result.insert(QString::fromUtf8("Александр"), qsl("Alexander"));
+		result.insert(QString::fromUtf8("александр"), qsl("alexander"));
+		result.insert(QString::fromUtf8("Филипп"), qsl("Philip"));
+		result.insert(QString::fromUtf8("филипп"), qsl("philip"));
+		result.insert(QString::fromUtf8("Пётр"), qsl("Petr"));
+		result.insert(QString::fromUtf8("пётр"), qsl("petr"));
+		result.insert(QString::fromUtf8("Гай"), qsl("Gai"));
+		result.insert(QString::fromUtf8("гай"), qsl("gai"));
+		result.insert(QString::fromUtf8("Ильин"), qsl("Ilyin"));
+		result.insert(QString::fromUtf8("ильин"), qsl("ilyin"));
+		return result;
+	}();
 	QMap<QString, QString>::const_iterator i = fastRusEng.constFind(rus);
 	if (i != fastRusEng.cend()) {
 		return i.value();
@@ -467,140 +468,142 @@ QString translitRusEng(const QString &rus) {
 }
 
 QString rusKeyboardLayoutSwitch(const QString &from) {
-	if (fastRusKeyboardSwitch.isEmpty()) {
-		fastRusKeyboardSwitch.insert('Q', QString::fromUtf8("Й").at(0));
-		fastRusKeyboardSwitch.insert('W', QString::fromUtf8("Ц").at(0));
-		fastRusKeyboardSwitch.insert('E', QString::fromUtf8("У").at(0));
-		fastRusKeyboardSwitch.insert('R', QString::fromUtf8("К").at(0));
-		fastRusKeyboardSwitch.insert('T', QString::fromUtf8("Е").at(0));
-		fastRusKeyboardSwitch.insert('Y', QString::fromUtf8("Н").at(0));
-		fastRusKeyboardSwitch.insert('U', QString::fromUtf8("Г").at(0));
-		fastRusKeyboardSwitch.insert('I', QString::fromUtf8("Ш").at(0));
-		fastRusKeyboardSwitch.insert('O', QString::fromUtf8("Щ").at(0));
-		fastRusKeyboardSwitch.insert('P', QString::fromUtf8("З").at(0));
-		fastRusKeyboardSwitch.insert('{', QString::fromUtf8("Х").at(0));
-		fastRusKeyboardSwitch.insert('}', QString::fromUtf8("Ъ").at(0));
-		fastRusKeyboardSwitch.insert('A', QString::fromUtf8("Ф").at(0));
-		fastRusKeyboardSwitch.insert('S', QString::fromUtf8("Ы").at(0));
-		fastRusKeyboardSwitch.insert('D', QString::fromUtf8("В").at(0));
-		fastRusKeyboardSwitch.insert('F', QString::fromUtf8("А").at(0));
-		fastRusKeyboardSwitch.insert('G', QString::fromUtf8("П").at(0));
-		fastRusKeyboardSwitch.insert('H', QString::fromUtf8("Р").at(0));
-		fastRusKeyboardSwitch.insert('J', QString::fromUtf8("О").at(0));
-		fastRusKeyboardSwitch.insert('K', QString::fromUtf8("Л").at(0));
-		fastRusKeyboardSwitch.insert('L', QString::fromUtf8("Д").at(0));
-		fastRusKeyboardSwitch.insert(':', QString::fromUtf8("Ж").at(0));
-		fastRusKeyboardSwitch.insert('"', QString::fromUtf8("Э").at(0));
-		fastRusKeyboardSwitch.insert('Z', QString::fromUtf8("Я").at(0));
-		fastRusKeyboardSwitch.insert('X', QString::fromUtf8("Ч").at(0));
-		fastRusKeyboardSwitch.insert('C', QString::fromUtf8("С").at(0));
-		fastRusKeyboardSwitch.insert('V', QString::fromUtf8("М").at(0));
-		fastRusKeyboardSwitch.insert('B', QString::fromUtf8("И").at(0));
-		fastRusKeyboardSwitch.insert('N', QString::fromUtf8("Т").at(0));
-		fastRusKeyboardSwitch.insert('M', QString::fromUtf8("Ь").at(0));
-		fastRusKeyboardSwitch.insert('<', QString::fromUtf8("Б").at(0));
-		fastRusKeyboardSwitch.insert('>', QString::fromUtf8("Ю").at(0));
-		fastRusKeyboardSwitch.insert('q', QString::fromUtf8("й").at(0));
-		fastRusKeyboardSwitch.insert('w', QString::fromUtf8("ц").at(0));
-		fastRusKeyboardSwitch.insert('e', QString::fromUtf8("у").at(0));
-		fastRusKeyboardSwitch.insert('r', QString::fromUtf8("к").at(0));
-		fastRusKeyboardSwitch.insert('t', QString::fromUtf8("е").at(0));
-		fastRusKeyboardSwitch.insert('y', QString::fromUtf8("н").at(0));
-		fastRusKeyboardSwitch.insert('u', QString::fromUtf8("г").at(0));
-		fastRusKeyboardSwitch.insert('i', QString::fromUtf8("ш").at(0));
-		fastRusKeyboardSwitch.insert('o', QString::fromUtf8("щ").at(0));
-		fastRusKeyboardSwitch.insert('p', QString::fromUtf8("з").at(0));
-		fastRusKeyboardSwitch.insert('[', QString::fromUtf8("х").at(0));
-		fastRusKeyboardSwitch.insert(']', QString::fromUtf8("ъ").at(0));
-		fastRusKeyboardSwitch.insert('a', QString::fromUtf8("ф").at(0));
-		fastRusKeyboardSwitch.insert('s', QString::fromUtf8("ы").at(0));
-		fastRusKeyboardSwitch.insert('d', QString::fromUtf8("в").at(0));
-		fastRusKeyboardSwitch.insert('f', QString::fromUtf8("а").at(0));
-		fastRusKeyboardSwitch.insert('g', QString::fromUtf8("п").at(0));
-		fastRusKeyboardSwitch.insert('h', QString::fromUtf8("р").at(0));
-		fastRusKeyboardSwitch.insert('j', QString::fromUtf8("о").at(0));
-		fastRusKeyboardSwitch.insert('k', QString::fromUtf8("л").at(0));
-		fastRusKeyboardSwitch.insert('l', QString::fromUtf8("д").at(0));
-		fastRusKeyboardSwitch.insert(';', QString::fromUtf8("ж").at(0));
-		fastRusKeyboardSwitch.insert('\'', QString::fromUtf8("э").at(0));
-		fastRusKeyboardSwitch.insert('z', QString::fromUtf8("я").at(0));
-		fastRusKeyboardSwitch.insert('x', QString::fromUtf8("ч").at(0));
-		fastRusKeyboardSwitch.insert('c', QString::fromUtf8("с").at(0));
-		fastRusKeyboardSwitch.insert('v', QString::fromUtf8("м").at(0));
-		fastRusKeyboardSwitch.insert('b', QString::fromUtf8("и").at(0));
-		fastRusKeyboardSwitch.insert('n', QString::fromUtf8("т").at(0));
-		fastRusKeyboardSwitch.insert('m', QString::fromUtf8("ь").at(0));
-		fastRusKeyboardSwitch.insert(',', QString::fromUtf8("б").at(0));
-		fastRusKeyboardSwitch.insert('.', QString::fromUtf8("ю").at(0));
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Й").at(0), 'Q');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Ц").at(0), 'W');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("У").at(0), 'E');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("К").at(0), 'R');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Е").at(0), 'T');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Н").at(0), 'Y');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Г").at(0), 'U');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Ш").at(0), 'I');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Щ").at(0), 'O');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("З").at(0), 'P');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Х").at(0), '{');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Ъ").at(0), '}');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Ф").at(0), 'A');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Ы").at(0), 'S');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("В").at(0), 'D');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("А").at(0), 'F');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("П").at(0), 'G');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Р").at(0), 'H');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("О").at(0), 'J');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Л").at(0), 'K');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Д").at(0), 'L');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Ж").at(0), ':');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Э").at(0), '"');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Я").at(0), 'Z');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Ч").at(0), 'X');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("С").at(0), 'C');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("М").at(0), 'V');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("И").at(0), 'B');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Т").at(0), 'N');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Ь").at(0), 'M');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Б").at(0), '<');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Ю").at(0), '>');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("й").at(0), 'q');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("ц").at(0), 'w');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("у").at(0), 'e');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("к").at(0), 'r');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("е").at(0), 't');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("н").at(0), 'y');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("г").at(0), 'u');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("ш").at(0), 'i');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("щ").at(0), 'o');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("з").at(0), 'p');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("х").at(0), '[');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("ъ").at(0), ']');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("ф").at(0), 'a');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("ы").at(0), 's');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("в").at(0), 'd');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("а").at(0), 'f');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("п").at(0), 'g');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("р").at(0), 'h');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("о").at(0), 'j');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("л").at(0), 'k');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("д").at(0), 'l');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("ж").at(0), ';');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("э").at(0), '\'');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("я").at(0), 'z');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("ч").at(0), 'x');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("с").at(0), 'c');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("м").at(0), 'v');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("и").at(0), 'b');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("т").at(0), 'n');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("ь").at(0), 'm');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("б").at(0), ',');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("ю").at(0), '.');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("І").at(0), 'S');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("і").at(0), 's');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("Ї").at(0), ']');
-		fastRusKeyboardSwitch.insert(QString::fromUtf8("ї").at(0), ']');
-	}
+	static const auto fastRusKeyboardSwitch = [] {
+		auto result = QHash<QChar, QChar>();
+		result.insert('Q', QString::fromUtf8("Й").at(0));
+		result.insert('W', QString::fromUtf8("Ц").at(0));
+		result.insert('E', QString::fromUtf8("У").at(0));
+		result.insert('R', QString::fromUtf8("К").at(0));
+		result.insert('T', QString::fromUtf8("Е").at(0));
+		result.insert('Y', QString::fromUtf8("Н").at(0));
+		result.insert('U', QString::fromUtf8("Г").at(0));
+		result.insert('I', QString::fromUtf8("Ш").at(0));
+		result.insert('O', QString::fromUtf8("Щ").at(0));
+		result.insert('P', QString::fromUtf8("З").at(0));
+		result.insert('{', QString::fromUtf8("Х").at(0));
+		result.insert('}', QString::fromUtf8("Ъ").at(0));
+		result.insert('A', QString::fromUtf8("Ф").at(0));
+		result.insert('S', QString::fromUtf8("Ы").at(0));
+		result.insert('D', QString::fromUtf8("В").at(0));
+		result.insert('F', QString::fromUtf8("А").at(0));
+		result.insert('G', QString::fromUtf8("П").at(0));
+		result.insert('H', QString::fromUtf8("Р").at(0));
+		result.insert('J', QString::fromUtf8("О").at(0));
+		result.insert('K', QString::fromUtf8("Л").at(0));
+		result.insert('L', QString::fromUtf8("Д").at(0));
+		result.insert(':', QString::fromUtf8("Ж").at(0));
+		result.insert('"', QString::fromUtf8("Э").at(0));
+		result.insert('Z', QString::fromUtf8("Я").at(0));
+		result.insert('X', QString::fromUtf8("Ч").at(0));
+		result.insert('C', QString::fromUtf8("С").at(0));
+		result.insert('V', QString::fromUtf8("М").at(0));
+		result.insert('B', QString::fromUtf8("И").at(0));
+		result.insert('N', QString::fromUtf8("Т").at(0));
+		result.insert('M', QString::fromUtf8("Ь").at(0));
+		result.insert('<', QString::fromUtf8("Б").at(0));
+		result.insert('>', QString::fromUtf8("Ю").at(0));
+		result.insert('q', QString::fromUtf8("й").at(0));
+		result.insert('w', QString::fromUtf8("ц").at(0));
+		result.insert('e', QString::fromUtf8("у").at(0));
+		result.insert('r', QString::fromUtf8("к").at(0));
+		result.insert('t', QString::fromUtf8("е").at(0));
+		result.insert('y', QString::fromUtf8("н").at(0));
+		result.insert('u', QString::fromUtf8("г").at(0));
+		result.insert('i', QString::fromUtf8("ш").at(0));
+		result.insert('o', QString::fromUtf8("щ").at(0));
+		result.insert('p', QString::fromUtf8("з").at(0));
+		result.insert('[', QString::fromUtf8("х").at(0));
+		result.insert(']', QString::fromUtf8("ъ").at(0));
+		result.insert('a', QString::fromUtf8("ф").at(0));
+		result.insert('s', QString::fromUtf8("ы").at(0));
+		result.insert('d', QString::fromUtf8("в").at(0));
+		result.insert('f', QString::fromUtf8("а").at(0));
+		result.insert('g', QString::fromUtf8("п").at(0));
+		result.insert('h', QString::fromUtf8("р").at(0));
+		result.insert('j', QString::fromUtf8("о").at(0));
+		result.insert('k', QString::fromUtf8("л").at(0));
+		result.insert('l', QString::fromUtf8("д").at(0));
+		result.insert(';', QString::fromUtf8("ж").at(0));
+		result.insert('\'', QString::fromUtf8("э").at(0));
+		result.insert('z', QString::fromUtf8("я").at(0));
+		result.insert('x', QString::fromUtf8("ч").at(0));
+		result.insert('c', QString::fromUtf8("с").at(0));
+		result.insert('v', QString::fromUtf8("м").at(0));
+		result.insert('b', QString::fromUtf8("и").at(0));
+		result.insert('n', QString::fromUtf8("т").at(0));
+		result.insert('m', QString::fromUtf8("ь").at(0));
+		result.insert(',', QString::fromUtf8("б").at(0));
+		result.insert('.', QString::fromUtf8("ю").at(0));
+		result.insert(QString::fromUtf8("Й").at(0), 'Q');
+		result.insert(QString::fromUtf8("Ц").at(0), 'W');
+		result.insert(QString::fromUtf8("У").at(0), 'E');
+		result.insert(QString::fromUtf8("К").at(0), 'R');
+		result.insert(QString::fromUtf8("Е").at(0), 'T');
+		result.insert(QString::fromUtf8("Н").at(0), 'Y');
+		result.insert(QString::fromUtf8("Г").at(0), 'U');
+		result.insert(QString::fromUtf8("Ш").at(0), 'I');
+		result.insert(QString::fromUtf8("Щ").at(0), 'O');
+		result.insert(QString::fromUtf8("З").at(0), 'P');
+		result.insert(QString::fromUtf8("Х").at(0), '{');
+		result.insert(QString::fromUtf8("Ъ").at(0), '}');
+		result.insert(QString::fromUtf8("Ф").at(0), 'A');
+		result.insert(QString::fromUtf8("Ы").at(0), 'S');
+		result.insert(QString::fromUtf8("В").at(0), 'D');
+		result.insert(QString::fromUtf8("А").at(0), 'F');
+		result.insert(QString::fromUtf8("П").at(0), 'G');
+		result.insert(QString::fromUtf8("Р").at(0), 'H');
+		result.insert(QString::fromUtf8("О").at(0), 'J');
+		result.insert(QString::fromUtf8("Л").at(0), 'K');
+		result.insert(QString::fromUtf8("Д").at(0), 'L');
+		result.insert(QString::fromUtf8("Ж").at(0), ':');
+		result.insert(QString::fromUtf8("Э").at(0), '"');
+		result.insert(QString::fromUtf8("Я").at(0), 'Z');
+		result.insert(QString::fromUtf8("Ч").at(0), 'X');
+		result.insert(QString::fromUtf8("С").at(0), 'C');
+		result.insert(QString::fromUtf8("М").at(0), 'V');
+		result.insert(QString::fromUtf8("И").at(0), 'B');
+		result.insert(QString::fromUtf8("Т").at(0), 'N');
+		result.insert(QString::fromUtf8("Ь").at(0), 'M');
+		result.insert(QString::fromUtf8("Б").at(0), '<');
+		result.insert(QString::fromUtf8("Ю").at(0), '>');
+		result.insert(QString::fromUtf8("й").at(0), 'q');
+		result.insert(QString::fromUtf8("ц").at(0), 'w');
+		result.insert(QString::fromUtf8("у").at(0), 'e');
+		result.insert(QString::fromUtf8("к").at(0), 'r');
+		result.insert(QString::fromUtf8("е").at(0), 't');
+		result.insert(QString::fromUtf8("н").at(0), 'y');
+		result.insert(QString::fromUtf8("г").at(0), 'u');
+		result.insert(QString::fromUtf8("ш").at(0), 'i');
+		result.insert(QString::fromUtf8("щ").at(0), 'o');
+		result.insert(QString::fromUtf8("з").at(0), 'p');
+		result.insert(QString::fromUtf8("х").at(0), '[');
+		result.insert(QString::fromUtf8("ъ").at(0), ']');
+		result.insert(QString::fromUtf8("ф").at(0), 'a');
+		result.insert(QString::fromUtf8("ы").at(0), 's');
+		result.insert(QString::fromUtf8("в").at(0), 'd');
+		result.insert(QString::fromUtf8("а").at(0), 'f');
+		result.insert(QString::fromUtf8("п").at(0), 'g');
+		result.insert(QString::fromUtf8("р").at(0), 'h');
+		result.insert(QString::fromUtf8("о").at(0), 'j');
+		result.insert(QString::fromUtf8("л").at(0), 'k');
+		result.insert(QString::fromUtf8("д").at(0), 'l');
+		result.insert(QString::fromUtf8("ж").at(0), ';');
+		result.insert(QString::fromUtf8("э").at(0), '\'');
+		result.insert(QString::fromUtf8("я").at(0), 'z');
+		result.insert(QString::fromUtf8("ч").at(0), 'x');
+		result.insert(QString::fromUtf8("с").at(0), 'c');
+		result.insert(QString::fromUtf8("м").at(0), 'v');
+		result.insert(QString::fromUtf8("и").at(0), 'b');
+		result.insert(QString::fromUtf8("т").at(0), 'n');
+		result.insert(QString::fromUtf8("ь").at(0), 'm');
+		result.insert(QString::fromUtf8("б").at(0), ',');
+		result.insert(QString::fromUtf8("ю").at(0), '.');
+		result.insert(QString::fromUtf8("І").at(0), 'S');
+		result.insert(QString::fromUtf8("і").at(0), 's');
+		result.insert(QString::fromUtf8("Ї").at(0), ']');
+		result.insert(QString::fromUtf8("ї").at(0), ']');
+		return result;
+	}();
 
 	QString result;
 	result.reserve(from.size());
@@ -10,6 +10,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session.h"
 
 namespace Data {
+namespace {
+
+constexpr auto kLogFanOutCount = 1000;
+
+} // namespace
 
 template <typename DataType, typename UpdateType>
 void Changes::Manager<DataType, UpdateType>::updated(
@@ -17,13 +22,18 @@ void Changes::Manager<DataType, UpdateType>::updated(
 		Flags flags,
 		bool dropScheduled) {
 	sendRealtimeNotifications(data, flags);
-	if (dropScheduled) {
+	if (_batchLevel > 0 && !dropScheduled) {
+		_batched[data] |= flags;
+	} else if (dropScheduled) {
 		const auto i = _updates.find(data);
 		if (i != _updates.end()) {
 			flags |= i->second;
 			_updates.erase(i);
 		}
-		_stream.fire({ data, flags });
+		notify({ data, flags });
+
+		// The object is destroyed, its address may be reused.
+		_listeners.erase(data);
 	} else {
 		_updates[data] |= flags;
 	}
@@ -44,21 +54,154 @@ void Changes::Manager<DataType, UpdateType>::sendRealtimeNotifications(
 template <typename DataType, typename UpdateType>
 rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::updates(
 		Flags flags) const {
-	return _stream.events(
-	) | rpl::filter([=](const UpdateType &update) {
-		return (update.flags & flags);
-	});
+	return listen(nullptr, flags);
 }
 
 template <typename DataType, typename UpdateType>
 rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::updates(
 		not_null<DataType*> data,
 		Flags flags) const {
-	return _stream.events(
-	) | rpl::filter([=](const UpdateType &update) {
-		const auto [updateData, updateFlags] = update;
-		return (updateData == data) && (updateFlags & flags);
-	});
+	return listen(data, flags);
+}
+
+template <typename DataType, typename UpdateType>
+rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::listen(
+		DataType *data,
+		Flags flags) const {
+	return [=](auto consumer) {
+		auto &list = data
+			? _listeners[not_null<DataType*>(data)]
+			: _allListeners;
+		if (!_notifying && list.size() == list.capacity()) {
+			PrepareToGrow(list);
+		}
+		list.push_back(std::make_shared<Listeners>(Listeners{
+			.flags = flags,
+			.order = ++_listenersOrder,
+		}));
+		return list.back()->stream.events().start_existing(consumer);
+	};
+}
+
+template <typename DataType, typename UpdateType>
+void Changes::Manager<DataType, UpdateType>::notify(
+		const UpdateType &update) {
+	const auto [data, flags] = update;
+	const auto findOwn = [&]() -> ListenersList* {
+		const auto i = _listeners.find(data);
+		return (i != end(_listeners)) ? &i->second : nullptr;
+	};
+
+	// Both lists are sorted by the subscription order, merge them so that
+	// the handlers are called in that order, as with a single stream.
+	// Handlers may subscribe to the same object or notify about it, so
+	// the lists are not compacted until the outermost notify() finishes
+	// and the subscriptions made after this notify() started are skipped.
+	++_notifying;
+	const auto lastOrder = _listenersOrder;
+	const auto allCount = int(_allListeners.size());
+	auto own = findOwn();
+	auto ownCount = own ? int(own->size()) : 0;
+	auto unused = false;
+	auto a = 0;
+	auto o = 0;
+	while (a < allCount || o < ownCount) {
+		const auto fromOwn = (a == allCount)
+			|| (o < ownCount
+				&& (*own)[o]->order < _allListeners[a]->order);
+		const auto &listeners = fromOwn ? (*own)[o++] : _allListeners[a++];
+		if (listeners->order > lastOrder) {
+			continue;
+		} else if (!listeners->stream.has_consumers()) {
+			unused = true;
+		} else if (listeners->flags & flags) {
+			if (fromOwn) {
+				++_fanOut;
+			}
+
+			// The handler may drop the list of this object.
+			const auto strong = listeners;
+			strong->stream.fire_copy(update);
+			own = findOwn();
+			ownCount = own ? std::min(ownCount, int(own->size())) : 0;
+		}
+	}
+	if (--_notifying > 0 || !unused) {
+		return;
+	}
+	RemoveUnused(_allListeners);
+	const auto j = _listeners.find(data);
+	if (j != end(_listeners)) {
+		RemoveUnused(j->second);
+		if (j->second.empty()) {
+			_listeners.erase(j);
+		}
+	}
+}
+
+template <typename DataType, typename UpdateType>
+void Changes::Manager<DataType, UpdateType>::RemoveUnused(
+		ListenersList &list) {
+	list.erase(ranges::remove_if(list, [](const auto &listeners) {
+		return !listeners->stream.has_consumers();
+	}), end(list));
+}
+
+template <typename DataType, typename UpdateType>
+void Changes::Manager<DataType, UpdateType>::PrepareToGrow(
+		ListenersList &list) {
+	// Compact only when the list is full and leave it at most half full,
+	// so that subscribing takes amortized constant time.
+	RemoveUnused(list);
+	if (list.size() * 2 > list.capacity()) {
+		list.reserve(std::max(list.capacity() * 2, std::size_t(4)));
+	}
+}
+
+template <typename DataType, typename UpdateType>
+void Changes::Manager<DataType, UpdateType>::startBatch() {
+	++_batchLevel;
+}
+
+template <typename DataType, typename UpdateType>
+void Changes::Manager<DataType, UpdateType>::finishBatch() {
+	Expects(_batchLevel > 0);
+
+	if (--_batchLevel > 0) {
+		return;
+	}
+	using Pair = std::pair<not_null<DataType*>, Flags>;
+	auto batched = std::vector<Pair>(begin(_batched), end(_batched));
+	_batched.clear();
+	ranges::sort(batched, ranges::less(), &Pair::first);
+
+	// Merge the sorted batch with the scheduled updates in one pass
+	// instead of inserting the entries into the flat map one by one.
+	auto merged = std::vector<Pair>();
+	merged.reserve(_updates.size() + batched.size());
+	auto i = begin(_updates);
+	auto j = begin(batched);
+	while (i != end(_updates) || j != end(batched)) {
+		if (j == end(batched)
+			|| (i != end(_updates) && i->first < j->first)) {
+			merged.emplace_back(i->first, i->second);
+			++i;
+		} else if (i == end(_updates) || j->first < i->first) {
+			merged.push_back(*j++);
+		} else {
+			merged.emplace_back(i->first, i->second | j->second);
+			++i;
+			++j;
+		}
+	}
+	_updates = base::flat_map<not_null<DataType*>, Flags>(
+		begin(merged),
+		end(merged));
+}
+
+template <typename DataType, typename UpdateType>
+int Changes::Manager<DataType, UpdateType>::takeFanOut() {
+	return base::take(_fanOut);
 }
 
 template <typename DataType, typename UpdateType>
@@ -79,7 +222,7 @@ rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::flagsValue(
 template <typename DataType, typename UpdateType>
 void Changes::Manager<DataType, UpdateType>::sendNotifications() {
 	for (const auto &[data, flags] : base::take(_updates)) {
-		_stream.fire({ data, flags });
+		notify({ data, flags });
 	}
 }
 
@@ -112,6 +255,15 @@ void Changes::peerUpdated(not_null<PeerData*> peer, PeerUpdate::Flags flags) {
 	scheduleNotifications();
 }
 
+void Changes::startPeerUpdatesBatch() {
+	_peerChanges.startBatch();
+}
+
+void Changes::finishPeerUpdatesBatch() {
+	_peerChanges.finishBatch();
+	scheduleNotifications();
+}
+
 rpl::producer<PeerUpdate> Changes::peerUpdates(
 		PeerUpdate::Flags flags) const {
 	return _peerChanges.updates(flags);
@@ -242,6 +394,15 @@ void Changes::sendNotifications() {
 	_historyChanges.sendNotifications();
 	_messageChanges.sendNotifications();
 	_entryChanges.sendNotifications();
+
+	const auto fanOut = _peerChanges.takeFanOut()
+		+ _historyChanges.takeFanOut()
+		+ _messageChanges.takeFanOut()
+		+ _entryChanges.takeFanOut();
+	if (fanOut >= kLogFanOutCount) {
+		DEBUG_LOG(("Changes: %1 subscriptions notified at once."
+			).arg(fanOut));
+	}
 }
 
 } // namespace Data
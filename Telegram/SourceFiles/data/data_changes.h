@@ -195,6 +195,14 @@ public:
 	void peerUpdated(not_null<PeerData*> peer, PeerUpdate::Flags flags);
 	[[nodiscard]] rpl::producer<PeerUpdate> peerUpdates(
 		PeerUpdate::Flags flags) const;
+
+	// While the batch is active the scheduled updates of each peer are
+	// merged and queued once when it is finished. Realtime updates are
+	// still sent right away, but new search words of the renamed peers
+	// are applied only at the end of the batch.
+	void startPeerUpdatesBatch();
+	void finishPeerUpdatesBatch();
+
 	[[nodiscard]] rpl::producer<PeerUpdate> peerUpdates(
 		not_null<PeerData*> peer,
 		PeerUpdate::Flags flags) const;
@@ -271,16 +279,50 @@ private:
 
 		void sendNotifications();
 
+		void startBatch();
+		void finishBatch();
+
+		// Count of the single object subscriptions notified since the
+		// last call, for the diagnostics of the update bursts.
+		[[nodiscard]] int takeFanOut();
+
 	private:
 		static constexpr auto kCount = details::CountBit<Flag>() + 1;
 
+		struct Listeners {
+			Flags flags;
+			uint64 order = 0;
+			rpl::event_stream<UpdateType> stream;
+		};
+		using ListenersList = std::vector<std::shared_ptr<Listeners>>;
+
 		void sendRealtimeNotifications(
 			not_null<DataType*> data,
 			Flags flags);
+		[[nodiscard]] rpl::producer<UpdateType> listen(
+			DataType *data,
+			Flags flags) const;
+		void notify(const UpdateType &update);
+		static void RemoveUnused(ListenersList &list);
+		static void PrepareToGrow(ListenersList &list);
 
 		std::array<rpl::event_stream<UpdateType>, kCount> _realtimeStreams;
 		base::flat_map<not_null<DataType*>, Flags> _updates;
-		rpl::event_stream<UpdateType> _stream;
+
+		std::unordered_map<not_null<DataType*>, Flags> _batched;
+		int _batchLevel = 0;
+
+		// Subscriptions to a single object are kept by the object, so that
+		// its update reaches only them instead of going through all the
+		// subscriptions in the app. Each subscription remembers when it
+		// was made, the updates are delivered in that order.
+		mutable ListenersList _allListeners;
+		mutable std::unordered_map<
+			not_null<DataType*>,
+			ListenersList> _listeners;
+		mutable uint64 _listenersOrder = 0;
+		int _notifying = 0;
+		int _fanOut = 0;
 
 	};
 
@@ -279,12 +279,8 @@ bool StickerData::isWebm() const {
 }
 
 VoiceData::~VoiceData() {
-	if (!waveform.isEmpty()
-		&& waveform[0] == -1
-		&& waveform.size() > int32(sizeof(TaskId))) {
-		auto taskId = TaskId();
-		memcpy(&taskId, waveform.constData() + 1, sizeof(taskId));
-		Local::cancelTask(taskId);
+	if (waveformCancelled) {
+		*waveformCancelled = true;
 	}
 }
 
@@ -87,6 +87,9 @@ struct VoiceData : public DocumentAdditionalData {
 	int duration = 0;
 	VoiceWaveform waveform;
 	char wavemax = 0;
+
+	// Cancels the waveform counting job when the voice data is destroyed.
+	std::shared_ptr<std::atomic<bool>> waveformCancelled;
 };
 
 namespace Serialize {
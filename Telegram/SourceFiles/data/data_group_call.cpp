@@ -224,8 +224,95 @@ const GroupCallParticipant *GroupCall::participantByPeer(
 
 GroupCallParticipant *GroupCall::findParticipant(
 		not_null<PeerData*> peer) {
-	const auto i = ranges::find(_participants, peer, &Participant::peer);
-	return (i != end(_participants)) ? &*i : nullptr;
+	const auto i = _participantIndexByPeer.find(peer);
+	return (i != end(_participantIndexByPeer))
+		? &_participants[i->second]
+		: nullptr;
+}
+
+void GroupCall::addParticipant(const Participant &participant) {
+	_participantIndexByPeer.emplace(
+		participant.peer,
+		int(_participants.size()));
+	_participants.push_back(participant);
+	indexParticipant(participant);
+}
+
+void GroupCall::removeParticipant(not_null<PeerData*> peer) {
+	const auto i = _participantIndexByPeer.find(peer);
+	if (i == end(_participantIndexByPeer)) {
+		return;
+	}
+	const auto index = i->second;
+	_participantIndexByPeer.erase(i);
+	unindexParticipant(_participants[index]);
+
+	// Move the last participant to the freed place, so that only its
+	// index changes. The list order is not kept, the members list sorts
+	// the participants itself when it fills the rows.
+	const auto last = int(_participants.size()) - 1;
+	if (index != last) {
+		_participants[index] = std::move(_participants[last]);
+		_participantIndexByPeer[_participants[index].peer] = index;
+	}
+	_participants.pop_back();
+}
+
+void GroupCall::updateParticipant(
+		not_null<Participant*> participant,
+		const Participant &value) {
+	Expects(participant->peer == value.peer);
+
+	unindexParticipant(*participant);
+	*participant = value;
+	indexParticipant(*participant);
+}
+
+void GroupCall::clearParticipants() {
+	_participants.clear();
+	_participantIndexByPeer.clear();
+	_participantPeerByAudioSsrc.clear();
+	_participantPeerByEndpoint.clear();
+}
+
+void GroupCall::indexParticipant(const Participant &participant) {
+	const auto peer = participant.peer;
+	if (participant.ssrc) {
+		_participantPeerByAudioSsrc.emplace(participant.ssrc, peer);
+	}
+	const auto &params = participant.videoParams;
+	if (const auto additional = GetAdditionalAudioSsrc(params)) {
+		_participantPeerByAudioSsrc.emplace(additional, peer);
+	}
+	for (const auto &endpoint : {
+		GetCameraEndpoint(params),
+		GetScreenEndpoint(params),
+	}) {
+		if (!endpoint.empty()) {
+			_participantPeerByEndpoint.emplace(endpoint, peer);
+		}
+	}
+}
+
+void GroupCall::unindexParticipant(const Participant &participant) {
+	const auto peer = participant.peer;
+	const auto removeSsrc = [&](uint32 ssrc) {
+		const auto i = _participantPeerByAudioSsrc.find(ssrc);
+		if (i != end(_participantPeerByAudioSsrc) && i->second == peer) {
+			_participantPeerByAudioSsrc.erase(i);
+		}
+	};
+	const auto removeEndpoint = [&](const std::string &endpoint) {
+		const auto i = _participantPeerByEndpoint.find(endpoint);
+		if (i != end(_participantPeerByEndpoint) && i->second == peer) {
+			_participantPeerByEndpoint.erase(i);
+		}
+	};
+	const auto &params = participant.videoParams;
+	removeSsrc(participant.ssrc);
+	removeSsrc(GetAdditionalAudioSsrc(params));
+	removeEndpoint(GetCameraEndpoint(params));
+	removeEndpoint(GetScreenEndpoint(params));
 }
 
 const GroupCallParticipant *GroupCall::participantByEndpoint(
@@ -233,13 +320,10 @@ const GroupCallParticipant *GroupCall::participantByEndpoint(
 	if (endpoint.empty()) {
 		return nullptr;
 	}
-	for (const auto &participant : _participants) {
-		if (GetCameraEndpoint(participant.videoParams) == endpoint
-			|| GetScreenEndpoint(participant.videoParams) == endpoint) {
-			return &participant;
-		}
-	}
-	return nullptr;
+	const auto i = _participantPeerByEndpoint.find(endpoint);
+	return (i != end(_participantPeerByEndpoint))
+		? participantByPeer(i->second)
+		: nullptr;
 }
 
 rpl::producer<> GroupCall::participantsReloaded() {
@@ -349,9 +433,8 @@ void GroupCall::processFullCallFields(const MTPphone_GroupCall &call) {
 		const auto &participants = data.vparticipants().v;
 		const auto nextOffset = qs(data.vparticipants_next_offset());
 		data.vcall().match([&](const MTPDgroupCall &data) {
-			_participants.clear();
+			clearParticipants();
 			_speakingByActiveFinishes.clear();
-			_participantPeerByAudioSsrc.clear();
 			_allParticipantsLoaded = false;
 
 			applyParticipantsSlice(
@@ -537,20 +620,14 @@ void GroupCall::applyParticipantsSlice(
 			const auto participantPeerId = peerFromMTP(data.vpeer());
 			const auto participantPeer = _peer->owner().peer(
 				participantPeerId);
-			const auto i = ranges::find(
-				_participants,
-				participantPeer,
-				&Participant::peer);
+			const auto i = findParticipant(participantPeer);
 			if (data.is_left()) {
-				if (i != end(_participants)) {
+				if (i) {
 					auto update = ParticipantUpdate{
 						.was = *i,
 					};
-					_participantPeerByAudioSsrc.erase(i->ssrc);
-					_participantPeerByAudioSsrc.erase(
-						GetAdditionalAudioSsrc(i->videoParams));
 					_speakingByActiveFinishes.remove(participantPeer);
-					_participants.erase(i);
+					removeParticipant(participantPeer);
 					if (sliceSource != ApplySliceSource::FullReloaded) {
 						_participantUpdates.fire(std::move(update));
 					}
@@ -563,7 +640,7 @@ void GroupCall::applyParticipantsSlice(
 			if (const auto about = data.vabout()) {
 				participantPeer->setAbout(qs(*about));
 			}
-			const auto was = (i != end(_participants))
+			const auto was = i
 				? std::make_optional(*i)
 				: std::nullopt;
 			const auto canSelfUnmute = !data.is_muted()
@@ -588,7 +665,7 @@ void GroupCall::applyParticipantsSlice(
 				= data.vraise_hand_rating().value_or_empty();
 			const auto localUpdate = (sliceSource
 				== ApplySliceSource::UpdateConstructed);
-			const auto existingVideoParams = (i != end(_participants))
+			const auto existingVideoParams = i
 				? i->videoParams
 				: nullptr;
 			auto videoParams = localUpdate
@@ -620,43 +697,13 @@ void GroupCall::applyParticipantsSlice(
 				.videoJoined = videoJoined,
 				.applyVolumeFromMin = applyVolumeFromMin,
 			};
-			if (i == end(_participants)) {
-				if (value.ssrc) {
-					_participantPeerByAudioSsrc.emplace(
-						value.ssrc,
-						participantPeer);
-				}
-				if (const auto additional = GetAdditionalAudioSsrc(
-						value.videoParams)) {
-					_participantPeerByAudioSsrc.emplace(
-						additional,
-						participantPeer);
-				}
-				_participants.push_back(value);
+			if (!i) {
+				addParticipant(value);
 				if (const auto user = participantPeer->asUser()) {
 					_peer->owner().unregisterInvitedToCallUser(_id, user);
 				}
 			} else {
-				if (i->ssrc != value.ssrc) {
-					_participantPeerByAudioSsrc.erase(i->ssrc);
-					if (value.ssrc) {
-						_participantPeerByAudioSsrc.emplace(
-							value.ssrc,
-							participantPeer);
-					}
-				}
-				if (GetAdditionalAudioSsrc(i->videoParams)
-					!= GetAdditionalAudioSsrc(value.videoParams)) {
-					_participantPeerByAudioSsrc.erase(
-						GetAdditionalAudioSsrc(i->videoParams));
-					if (const auto additional = GetAdditionalAudioSsrc(
-						value.videoParams)) {
-						_participantPeerByAudioSsrc.emplace(
-							additional,
-							participantPeer);
-					}
-				}
-				*i = value;
+				updateParticipant(i, value);
 			}
 			if (data.is_just_joined()) {
 				++_serverParticipantsCount;
@@ -884,11 +931,7 @@ void GroupCall::requestUnknownParticipants() {
 		}
 		for (const auto &[id, when] : participantPeerIds) {
 			if (const auto participantPeer = _peer->owner().peerLoaded(id)) {
-				const auto isParticipant = ranges::contains(
-					_participants,
-					not_null{ participantPeer },
-					&Participant::peer);
-				if (isParticipant) {
+				if (findParticipant(participantPeer)) {
 					applyActiveUpdate(id, when, participantPeer);
 				}
 			}
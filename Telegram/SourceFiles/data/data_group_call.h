@@ -193,6 +193,14 @@ private:
 	[[nodiscard]] bool processSavedFullCall();
 	void finishParticipantsSliceRequest();
 	[[nodiscard]] Participant *findParticipant(not_null<PeerData*> peer);
+	void addParticipant(const Participant &participant);
+	void removeParticipant(not_null<PeerData*> peer);
+	void updateParticipant(
+		not_null<Participant*> participant,
+		const Participant &value);
+	void clearParticipants();
+	void indexParticipant(const Participant &participant);
+	void unindexParticipant(const Participant &participant);
 
 	const CallId _id = 0;
 	const CallId _accessHash = 0;
@@ -209,8 +217,13 @@ private:
 	base::Timer _reloadByQueuedUpdatesTimer;
 	std::optional<MTPphone_GroupCall> _savedFull;
 
+	// Indices are kept in sync with the list in add / remove / update.
 	std::vector<Participant> _participants;
-	base::flat_map<uint32, not_null<PeerData*>> _participantPeerByAudioSsrc;
+	std::unordered_map<not_null<PeerData*>, int> _participantIndexByPeer;
+	std::unordered_map<uint32, not_null<PeerData*>> _participantPeerByAudioSsrc;
+	std::unordered_map<
+		std::string,
+		not_null<PeerData*>> _participantPeerByEndpoint;
 	base::flat_map<not_null<PeerData*>, crl::time> _speakingByActiveFinishes;
 	base::Timer _speakingByActiveFinishTimer;
 	QString _nextOffset;
@@ -12,6 +12,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_chat.h"
 #include "data/data_folder.h"
 #include "data/data_scheduled_messages.h"
+#include "history/history_allocator.h"
 #include "base/unixtime.h"
 #include "main/main_session.h"
 #include "window/notifications_manager.h"
@@ -19,18 +20,21 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history_item.h"
 #include "history/view/history_view_element.h"
 #include "core/application.h"
+#include "kotato/kotato_settings.h"
 #include "apiwrap.h"
 
 namespace Data {
 namespace {
 
 constexpr auto kReadRequestTimeout = 3 * crl::time(1000);
+constexpr auto kMessagesBudgetCheckDelay = 10 * crl::time(1000);
 
 } // namespace
 
 Histories::Histories(not_null<Session*> owner)
 : _owner(owner)
-, _readRequestsTimer([=] { sendReadRequests(); }) {
+, _readRequestsTimer([=] { sendReadRequests(); })
+, _messagesBudgetTimer([=] { checkMessagesBudget(); }) {
 }
 
 Session &Histories::owner() const {
@@ -65,9 +69,89 @@ void Histories::unloadAll() {
 }
 
 void Histories::clearAll() {
+	_messagesBudgetTimer.cancel();
+	_messagesHolders.clear();
+	_messagesReleased.clear();
 	_map.clear();
 }
 
+rpl::lifetime Histories::holdMessages(not_null<History*> history) {
+	if (++_messagesHolders[history] == 1) {
+		_messagesReleased.erase(
+			ranges::remove(_messagesReleased, history),
+			end(_messagesReleased));
+	}
+	auto result = rpl::lifetime();
+	result.add(crl::guard(this, [=] {
+		releaseMessages(history);
+	}));
+	return result;
+}
+
+void Histories::releaseMessages(not_null<History*> history) {
+	const auto i = _messagesHolders.find(history);
+	if (i == end(_messagesHolders) || --i->second > 0) {
+		return;
+	}
+	_messagesHolders.erase(i);
+	_messagesReleased.push_back(history);
+	_messagesBudgetTimer.callOnce(kMessagesBudgetCheckDelay);
+}
+
+void Histories::checkMessagesBudget() {
+	// The budget is per account, the allocators of other sessions'
+	// histories are not ours to unload.
+	const auto budget = int64(
+		::Kotato::JsonSettings::GetInt("messages_memory_budget"))
+		* 1024 * 1024;
+	auto bytes = int64(0);
+	for (const auto &[peerId, history] : _map) {
+		bytes += history->allocator()->stats().bytes;
+	}
+	const auto fits = [&] {
+		return (bytes <= budget);
+	};
+	const auto unloading = [&](not_null<History*> history, auto &&method) {
+		const auto was = history->allocator()->stats().bytes;
+		method();
+		bytes -= (was - history->allocator()->stats().bytes);
+	};
+	if (fits()) {
+		return;
+	}
+
+	// Views are cheap to recreate, so first unload all the views of the
+	// released histories and only then their messages as well.
+	for (const auto history : _messagesReleased) {
+		if (!history->isEmpty()) {
+			unloading(history, [&] {
+				history->clear(History::ClearType::Unload);
+			});
+			if (fits()) {
+				return;
+			}
+		}
+	}
+	// Forward drafts keep only the ids of the messages to be forwarded.
+	auto forwarding = base::flat_set<FullMsgId>();
+	for (const auto &[peerId, history] : _map) {
+		for (const auto &id : history->forwardDraft().ids) {
+			forwarding.emplace(id);
+		}
+	}
+	auto unloaded = 0;
+	while (!_messagesReleased.empty() && !fits()) {
+		const auto history = _messagesReleased.front();
+		_messagesReleased.erase(begin(_messagesReleased));
+		unloading(history, [&] {
+			unloaded += history->unloadMessages(forwarding);
+		});
+	}
+	DEBUG_LOG(("Histories: %1 messages unloaded, %2 bytes allocated."
+		).arg(unloaded
+		).arg(bytes));
+}
+
 void Histories::readInbox(not_null<History*> history) {
 	DEBUG_LOG(("Reading: readInbox called."));
 	if (history->lastServerMessageKnown()) {
@@ -902,4 +986,14 @@ Histories::State *Histories::lookup(not_null<History*> history) {
 	return (i != end(_states)) ? &i->second : nullptr;
 }
 
+rpl::lifetime HoldMessages(History *history, History *migrated) {
+	auto result = rpl::lifetime();
+	for (const auto held : { history, migrated }) {
+		if (held) {
+			result.add(held->owner().histories().holdMessages(held));
+		}
+	}
+	return result;
+}
+
 } // namespace Data
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "base/timer.h"
+#include "base/weak_ptr.h"
 
 class History;
 class HistoryItem;
@@ -21,7 +22,7 @@ namespace Data {
 class Session;
 class Folder;
 
-class Histories final {
+class Histories final : public base::has_weak_ptr {
 public:
 	enum class RequestType : uchar {
 		None,
@@ -44,6 +45,12 @@ public:
 	void unloadAll();
 	void clearAll();
 
+	// Histories in use keep their messages while the returned lifetime is
+	// alive. The messages of the other ones are unloaded, least recently
+	// used first, when all the loaded messages don't fit in the memory
+	// budget. Reopened histories load them again.
+	[[nodiscard]] rpl::lifetime holdMessages(not_null<History*> history);
+
 	void readInbox(not_null<History*> history);
 	void readInboxTill(not_null<HistoryItem*> item);
 	void readInboxTill(not_null<History*> history, MsgId tillId);
@@ -129,6 +136,9 @@ private:
 
 	void sendDialogRequests();
 
+	void releaseMessages(not_null<History*> history);
+	void checkMessagesBudget();
+
 	const not_null<Session*> _owner;
 
 	std::unordered_map<PeerId, std::unique_ptr<History>> _map;
@@ -151,6 +161,15 @@ private:
 		not_null<History*>,
 		ChatListGroupRequest> _chatListGroupRequests;
 
+	base::flat_map<not_null<History*>, int> _messagesHolders;
+	std::vector<not_null<History*>> _messagesReleased;
+	base::Timer _messagesBudgetTimer;
+
 };
 
+// For the holders that may have no history or no migrated history.
+[[nodiscard]] rpl::lifetime HoldMessages(
+	History *history,
+	History *migrated = nullptr);
+
 } // namespace Data
@@ -46,10 +46,12 @@ Reactions::Reactions(not_null<Session*> owner)
 	_owner->session().changes().messageUpdates(
 		MessageUpdate::Flag::Destroyed
 	) | rpl::start_with_next([=](const MessageUpdate &update) {
-		const auto item = update.item;
-		_pollingItems.remove(item);
-		_pollItems.remove(item);
-		_repaintItems.remove(item);
+		forgetItem(update.item);
+	}, _lifetime);
+
+	_owner->itemUnloaded(
+	) | rpl::start_with_next([=](not_null<const HistoryItem*> item) {
+		forgetItem(item);
 	}, _lifetime);
 
 	const auto appConfig = &_owner->session().account().appConfig();
@@ -415,6 +417,18 @@ void Reactions::updateAllInHistory(not_null<PeerData*> peer, bool enabled) {
 	}
 }
 
+void Reactions::forgetItem(not_null<const HistoryItem*> item) {
+	const auto remove = [&](auto &items) {
+		const auto i = items.find(item);
+		if (i != end(items)) {
+			items.erase(i);
+		}
+	};
+	remove(_pollingItems);
+	remove(_pollItems);
+	remove(_repaintItems);
+}
+
 void Reactions::repaintCollected() {
 	const auto now = crl::now();
 	auto closest = crl::time();
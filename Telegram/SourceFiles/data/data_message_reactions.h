@@ -98,6 +98,7 @@ private:
 
 	void repaintCollected();
 	void pollCollected();
+	void forgetItem(not_null<const HistoryItem*> item);
 
 	const not_null<Session*> _owner;
 
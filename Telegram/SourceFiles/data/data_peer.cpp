@@ -253,9 +253,17 @@ void PeerData::updateNameDelayed(
 			flags |= UpdateFlag::Username;
 		}
 	}
-	fillNames();
-	if (nameUpdated) {
-		session().changes().nameUpdated(this, std::move(oldFirstLetters));
+	if (owner().peersBatched()) {
+		owner().enqueueNameWords(
+			this,
+			(nameUpdated
+				? std::make_optional(std::move(oldFirstLetters))
+				: std::nullopt));
+	} else {
+		fillNames();
+		if (nameUpdated) {
+			session().changes().nameUpdated(this, std::move(oldFirstLetters));
+		}
 	}
 	if (flags) {
 		session().changes().peerUpdated(this, flags);
@@ -659,52 +667,70 @@ void PeerData::setSettings(const MTPPeerSettings &data) {
 }
 
 void PeerData::fillNames() {
-	_nameWords.clear();
-	_nameFirstLetters.clear();
-	auto toIndexList = QStringList();
-	auto appendToIndex = [&](const QString &value) {
+	applyNameWords(ComputeNameWords(nameWordsSource()));
+}
+
+QStringList PeerData::nameWordsSource() const {
+	auto result = QStringList();
+	auto append = [&](const QString &value) {
 		if (!value.isEmpty()) {
-			toIndexList.push_back(TextUtilities::RemoveAccents(value));
+			result.push_back(value);
 		}
 	};
 
-	appendToIndex(name);
-	const auto appendTranslit = !toIndexList.isEmpty()
-		&& cRussianLetters().match(toIndexList.front()).hasMatch();
-	if (appendTranslit) {
-		appendToIndex(translitRusEng(toIndexList.front()));
-	}
+	append(name);
 	if (const auto user = asUser()) {
 		if (user->nameOrPhone != name) {
-			appendToIndex(user->nameOrPhone);
+			append(user->nameOrPhone);
 		}
-		appendToIndex(user->username);
+		append(user->username);
 		if (isSelf()) {
 			const auto english = qsl("Saved messages");
 			const auto localized = tr::lng_saved_messages(tr::now);
-			appendToIndex(english);
+			append(english);
 			if (localized != english) {
-				appendToIndex(localized);
+				append(localized);
 			}
 		} else if (isRepliesChat()) {
 			const auto english = qsl("Replies");
 			const auto localized = tr::lng_replies_messages(tr::now);
-			appendToIndex(english);
+			append(english);
 			if (localized != english) {
-				appendToIndex(localized);
+				append(localized);
 			}
 		}
 	} else if (const auto channel = asChannel()) {
-		appendToIndex(channel->username);
+		append(channel->username);
+	}
+	return result;
+}
+
+PeerData::NameWords PeerData::ComputeNameWords(const QStringList &source) {
+	auto toIndexList = QStringList();
+	toIndexList.reserve(source.size() + 1);
+	for (const auto &value : source) {
+		toIndexList.push_back(TextUtilities::RemoveAccents(value));
+	}
+	const auto appendTranslit = !toIndexList.isEmpty()
+		&& cRussianLetters().match(toIndexList.front()).hasMatch();
+	if (appendTranslit) {
+		toIndexList.push_back(translitRusEng(toIndexList.front()));
 	}
 	auto toIndex = toIndexList.join(' ');
 	toIndex += ' ' + rusKeyboardLayoutSwitch(toIndex);
 
+	auto result = NameWords();
 	const auto namesList = TextUtilities::PrepareSearchWords(toIndex);
 	for (const auto &name : namesList) {
-		_nameWords.insert(name);
-		_nameFirstLetters.insert(name[0]);
+		result.words.insert(name);
+		result.firstLetters.insert(name[0]);
 	}
+	return result;
+}
+
+void PeerData::applyNameWords(NameWords &&words) {
+	_nameWords = std::move(words.words);
+	_nameFirstLetters = std::move(words.firstLetters);
 }
 
 PeerData::~PeerData() = default;
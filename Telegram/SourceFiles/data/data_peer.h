@@ -258,6 +258,18 @@ public:
 		return _nameFirstLetters;
 	}
 
+	// Search words are computed in two steps, so that a lot of peers
+	// can be indexed on worker threads: the strings to index are collected
+	// on the main thread and then split and transliterated on any thread.
+	struct NameWords {
+		base::flat_set<QString> words;
+		base::flat_set<QChar> firstLetters;
+	};
+	[[nodiscard]] QStringList nameWordsSource() const;
+	[[nodiscard]] static NameWords ComputeNameWords(
+		const QStringList &source);
+	void applyNameWords(NameWords &&words);
+
 	void setUserpic(PhotoId photoId, const ImageLocation &location);
 	void setUserpicPhoto(const MTPPhoto &data);
 	void paintUserpic(
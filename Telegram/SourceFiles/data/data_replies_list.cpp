@@ -52,7 +52,8 @@ struct RepliesList::Viewer {
 
 RepliesList::RepliesList(not_null<History*> history, MsgId rootId)
 : _history(history)
-, _rootId(rootId) {
+, _rootId(rootId)
+, _messagesHold(histories().holdMessages(_history)) {
 }
 
 RepliesList::~RepliesList() {
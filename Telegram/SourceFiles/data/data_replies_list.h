@@ -64,6 +64,7 @@ private:
 
 	const not_null<History*> _history;
 	const MsgId _rootId = 0;
+	const rpl::lifetime _messagesHold;
 	std::vector<MsgId> _list;
 	std::optional<int> _skippedBefore;
 	std::optional<int> _skippedAfter;
@@ -14,6 +14,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mainwidget.h"
 #include "api/api_text_entities.h"
 #include "core/application.h"
+#include "core/core_parallel.h"
 #include "core/mime_type.h" // Core::IsMimeSticker
 #include "core/crash_reports.h" // CrashReports::SetAnnotation
 #include "ui/image/image.h"
@@ -70,6 +71,8 @@ namespace Data {
 namespace {
 
 constexpr auto kMaxNotifyCheckDelay = 24 * 3600 * crl::time(1000);
+constexpr auto kParallelNameWordsCount = 256;
+constexpr auto kMaxNameWordsThreads = 8;
 
 using ViewElement = HistoryView::Element;
 
@@ -837,20 +840,95 @@ not_null<PeerData*> Session::processChat(const MTPChat &data) {
 
 UserData *Session::processUsers(const MTPVector<MTPUser> &data) {
 	auto result = (UserData*)nullptr;
+	startPeersBatch();
 	for (const auto &user : data.v) {
 		result = processUser(user);
 	}
+	finishPeersBatch();
 	return result;
 }
 
 PeerData *Session::processChats(const MTPVector<MTPChat> &data) {
 	auto result = (PeerData*)nullptr;
+	startPeersBatch();
 	for (const auto &chat : data.v) {
 		result = processChat(chat);
 	}
+	finishPeersBatch();
 	return result;
 }
 
+bool Session::peersBatched() const {
+	return (_peersBatchLevel > 0);
+}
+
+void Session::enqueueNameWords(
+		not_null<PeerData*> peer,
+		std::optional<base::flat_set<QChar>> oldFirstLetters) {
+	Expects(peersBatched());
+
+	auto &pending = _pendingNameWords[peer];
+	if (!pending) {
+		pending = std::move(oldFirstLetters);
+	}
+}
+
+void Session::startPeersBatch() {
+	if (!_peersBatchLevel++) {
+		session().changes().startPeerUpdatesBatch();
+	}
+}
+
+void Session::finishPeersBatch() {
+	Expects(_peersBatchLevel > 0);
+
+	if (--_peersBatchLevel > 0) {
+		return;
+	}
+	applyPendingNameWords();
+	session().changes().finishPeerUpdatesBatch();
+}
+
+void Session::applyPendingNameWords() {
+	if (_pendingNameWords.empty()) {
+		return;
+	}
+	auto pending = base::take(_pendingNameWords);
+	const auto count = int(pending.size());
+	auto sources = std::vector<QStringList>();
+	sources.reserve(count);
+	for (const auto &[peer, oldFirstLetters] : pending) {
+		sources.push_back(peer->nameWordsSource());
+	}
+	auto words = std::vector<PeerData::NameWords>(count);
+	const auto compute = [&](int from, int till) {
+		for (auto i = from; i != till; ++i) {
+			words[i] = PeerData::ComputeNameWords(sources[i]);
+		}
+	};
+	const auto threads = (count < kParallelNameWordsCount)
+		? 1
+		: std::clamp(
+			QThread::idealThreadCount(),
+			1,
+			kMaxNameWordsThreads);
+	const auto chunk = (count + threads - 1) / threads;
+	Core::ProcessInParallel((count + chunk - 1) / chunk, [&](int index) {
+		const auto from = index * chunk;
+		compute(from, std::min(from + chunk, count));
+	});
+
+	auto index = 0;
+	for (auto &[peer, oldFirstLetters] : pending) {
+		peer->applyNameWords(std::move(words[index++]));
+		if (oldFirstLetters) {
+			session().changes().nameUpdated(
+				peer,
+				std::move(*oldFirstLetters));
+		}
+	}
+}
+
 void Session::applyMaximumChatVersions(const MTPVector<MTPChat> &data) {
 	for (const auto &chat : data.v) {
 		chat.match([&](const MTPDchat &data) {
@@ -1508,6 +1586,11 @@ rpl::producer<not_null<const HistoryItem*>> Session::itemRemoved(
 	});
 }
 
+auto Session::itemUnloaded() const
+-> rpl::producer<not_null<const HistoryItem*>> {
+	return _itemUnloaded.events();
+}
+
 void Session::notifyViewRemoved(not_null<const ViewElement*> view) {
 	_viewRemoved.fire_copy(view);
 }
@@ -1556,36 +1639,33 @@ rpl::producer<> Session::pinnedDialogsOrderUpdated() const {
 }
 
 void Session::registerHeavyViewPart(not_null<ViewElement*> view) {
-	_heavyViewParts.emplace(view);
+	_heavyViewParts[view->delegate()].emplace(view);
 }
 
 void Session::unregisterHeavyViewPart(not_null<ViewElement*> view) {
-	_heavyViewParts.remove(view);
+	const auto i = _heavyViewParts.find(view->delegate());
+	if (i != end(_heavyViewParts)
+		&& i->second.erase(view)
+		&& i->second.empty()) {
+		_heavyViewParts.erase(i);
+	}
+}
+
+bool Session::hasHeavyViewPart(not_null<ViewElement*> view) const {
+	const auto i = _heavyViewParts.find(view->delegate());
+	return (i != end(_heavyViewParts)) && i->second.contains(view);
 }
 
 void Session::unloadHeavyViewParts(
 		not_null<HistoryView::ElementDelegate*> delegate) {
-	if (_heavyViewParts.empty()) {
+	const auto i = _heavyViewParts.find(delegate);
+	if (i == end(_heavyViewParts)) {
 		return;
 	}
-	const auto remove = ranges::count(
-		_heavyViewParts,
-		delegate,
-		[](not_null<ViewElement*> element) { return element->delegate(); });
-	if (remove == _heavyViewParts.size()) {
-		for (const auto &view : base::take(_heavyViewParts)) {
-			view->unloadHeavyPart();
-		}
-	} else {
-		auto remove = std::vector<not_null<ViewElement*>>();
-		for (const auto &view : _heavyViewParts) {
-			if (view->delegate() == delegate) {
-				remove.push_back(view);
-			}
-		}
-		for (const auto view : remove) {
-			view->unloadHeavyPart();
-		}
+	const auto remove = std::move(i->second);
+	_heavyViewParts.erase(i);
+	for (const auto &view : remove) {
+		view->unloadHeavyPart();
 	}
 }
 
@@ -1593,13 +1673,13 @@ void Session::unloadHeavyViewParts(
 		not_null<HistoryView::ElementDelegate*> delegate,
 		int from,
 		int till) {
-	if (_heavyViewParts.empty()) {
+	const auto i = _heavyViewParts.find(delegate);
+	if (i == end(_heavyViewParts)) {
 		return;
 	}
 	auto remove = std::vector<not_null<ViewElement*>>();
-	for (const auto &view : _heavyViewParts) {
-		if (view->delegate() == delegate
-			&& !delegate->elementIntersectsRange(view, from, till)) {
+	for (const auto &view : i->second) {
+		if (!delegate->elementIntersectsRange(view, from, till)) {
 			remove.push_back(view);
 		}
 	}
@@ -2074,13 +2154,30 @@ void Session::removeDependencyMessage(not_null<HistoryItem*> item) {
 }
 
 void Session::unregisterMessage(not_null<HistoryItem*> item) {
-	const auto peerId = item->history()->peer->id;
-	const auto itemId = item->id;
 	_shownSpoilers.remove(item);
 	_itemRemoved.fire_copy(item);
 	session().changes().messageUpdated(
 		item,
 		Data::MessageUpdate::Flag::Destroyed);
+	forgetMessage(item);
+}
+
+void Session::unregisterUnloadedMessage(not_null<HistoryItem*> item) {
+	_shownSpoilers.remove(item);
+	_itemUnloaded.fire_copy(item);
+
+	// Whoever holds the pointer has to drop it the same way as for
+	// a deleted message, the object itself is destroyed anyway.
+	_itemRemoved.fire_copy(item);
+	session().changes().messageUpdated(
+		item,
+		Data::MessageUpdate::Flag::Destroyed);
+	forgetMessage(item);
+}
+
+void Session::forgetMessage(not_null<HistoryItem*> item) {
+	const auto peerId = item->history()->peer->id;
+	const auto itemId = item->id;
 	groups().unregisterMessage(item);
 	removeDependencyMessage(item);
 	messagesListForInsert(peerId)->erase(itemId);
@@ -2171,6 +2268,16 @@ void Session::unregisterDependentMessage(
 	}
 }
 
+bool Session::canUnloadMessage(not_null<HistoryItem*> item) const {
+	if (_dependentMessages.contains(item)) {
+		return false;
+	}
+	const auto id = item->fullId();
+	const auto player = ::Media::Player::instance();
+	return (player->current(AudioMsgId::Type::Voice).contextId() != id)
+		&& (player->current(AudioMsgId::Type::Song).contextId() != id);
+}
+
 void Session::registerMessageRandomId(uint64 randomId, FullMsgId itemId) {
 	_messageByRandomId.emplace(randomId, itemId);
 }
@@ -2697,6 +2804,11 @@ not_null<DocumentData*> Session::document(DocumentId id) {
 	return i->second.get();
 }
 
+DocumentData *Session::documentLoaded(DocumentId id) const {
+	const auto i = _documents.find(id);
+	return (i != end(_documents)) ? i->second.get() : nullptr;
+}
+
 not_null<DocumentData*> Session::processDocument(const MTPDocument &data) {
 	return data.match([&](const MTPDdocument &data) {
 		return processDocument(data);
@@ -3558,9 +3670,12 @@ void Session::documentMessageRemoved(not_null<DocumentData*> document) {
 
 void Session::checkPlayingAnimations() {
 	auto check = base::flat_set<not_null<ViewElement*>>();
-	for (const auto &view : _heavyViewParts) {
-		if (const auto media = view->media()) {
-			if (const auto document = media->getDocument()) {
+	for (const auto &[delegate, views] : _heavyViewParts) {
+		for (const auto &view : views) {
+			const auto media = view->media();
+			if (!media) {
+				continue;
+			} else if (const auto document = media->getDocument()) {
 				if (document->isAnimation() || document->isVideoFile()) {
 					check.emplace(view);
 				}
@@ -3680,7 +3795,7 @@ void Session::registerItemView(not_null<ViewElement*> view) {
 }
 
 void Session::unregisterItemView(not_null<ViewElement*> view) {
-	Expects(!_heavyViewParts.contains(view));
+	Expects(!hasHeavyViewPart(view));
 
 	const auto i = _views.find(view->data());
 	if (i != end(_views)) {
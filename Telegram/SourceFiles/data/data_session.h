@@ -165,6 +165,13 @@ public:
 	UserData *processUsers(const MTPVector<MTPUser> &data);
 	PeerData *processChats(const MTPVector<MTPChat> &data);
 
+	// Inside processUsers / processChats the search words of the renamed
+	// peers are computed together when the whole vector is applied.
+	[[nodiscard]] bool peersBatched() const;
+	void enqueueNameWords(
+		not_null<PeerData*> peer,
+		std::optional<base::flat_set<QChar>> oldFirstLetters);
+
 	void applyMaximumChatVersions(const MTPVector<MTPChat> &data);
 
 	void registerGroupCall(not_null<GroupCall*> call);
@@ -263,6 +270,8 @@ public:
 	[[nodiscard]] rpl::producer<not_null<const HistoryItem*>> itemRemoved() const;
 	[[nodiscard]] rpl::producer<not_null<const HistoryItem*>> itemRemoved(
 		FullMsgId itemId) const;
+	[[nodiscard]] auto itemUnloaded() const
+		-> rpl::producer<not_null<const HistoryItem*>>;
 	void notifyViewRemoved(not_null<const ViewElement*> view);
 	[[nodiscard]] rpl::producer<not_null<const ViewElement*>> viewRemoved() const;
 	void notifyHistoryCleared(not_null<const History*> history);
@@ -276,6 +285,7 @@ public:
 
 	void registerHeavyViewPart(not_null<ViewElement*> view);
 	void unregisterHeavyViewPart(not_null<ViewElement*> view);
+	[[nodiscard]] bool hasHeavyViewPart(not_null<ViewElement*> view) const;
 	void unloadHeavyViewParts(
 		not_null<HistoryView::ElementDelegate*> delegate);
 	void unloadHeavyViewParts(
@@ -345,6 +355,11 @@ public:
 	void registerMessage(not_null<HistoryItem*> item);
 	void unregisterMessage(not_null<HistoryItem*> item);
 
+	// The message is not deleted, it is destroyed to save memory and can
+	// be requested again. itemUnloaded() is fired first to let the caches
+	// tell it apart from a deletion, then itemRemoved() as usual.
+	void unregisterUnloadedMessage(not_null<HistoryItem*> item);
+
 	void registerMessageTTL(TimeId when, not_null<HistoryItem*> item);
 	void unregisterMessageTTL(TimeId when, not_null<HistoryItem*> item);
 
@@ -384,6 +399,10 @@ public:
 		not_null<HistoryItem*> dependent,
 		not_null<HistoryItem*> dependency);
 
+	// Not referenced by other messages and not being played right now.
+	[[nodiscard]] bool canUnloadMessage(
+		not_null<HistoryItem*> item) const;
+
 	void destroyAllCallItems();
 
 	void registerMessageRandomId(uint64 randomId, FullMsgId itemId);
@@ -474,6 +493,7 @@ public:
 		const ImageLocation &thumbnailLocation);
 
 	[[nodiscard]] not_null<DocumentData*> document(DocumentId id);
+	[[nodiscard]] DocumentData *documentLoaded(DocumentId id) const;
 	not_null<DocumentData*> processDocument(const MTPDocument &data);
 	not_null<DocumentData*> processDocument(const MTPDdocument &data);
 	not_null<DocumentData*> processDocument(
@@ -702,9 +722,15 @@ private:
 
 	void checkSelfDestructItems();
 
+	void startPeersBatch();
+	void finishPeersBatch();
+	void applyPendingNameWords();
+
 	void scheduleNextTTLs();
 	void checkTTLs();
 
+	void forgetMessage(not_null<HistoryItem*> item);
+
 	int computeUnreadBadge(const Dialogs::UnreadState &state) const;
 	bool computeUnreadBadgeMuted(const Dialogs::UnreadState &state) const;
 
@@ -847,6 +873,7 @@ private:
 	rpl::event_stream<not_null<HistoryItem*>> _itemDataChanges;
 	rpl::event_stream<not_null<HistoryItem*>> _animationPlayInlineRequest;
 	rpl::event_stream<not_null<const HistoryItem*>> _itemRemoved;
+	rpl::event_stream<not_null<const HistoryItem*>> _itemUnloaded;
 	rpl::event_stream<not_null<const ViewElement*>> _viewRemoved;
 	rpl::event_stream<not_null<const History*>> _historyUnloaded;
 	rpl::event_stream<not_null<const History*>> _historyCleared;
@@ -942,7 +969,11 @@ private:
 
 	rpl::event_stream<> _pinnedDialogsOrderUpdated;
 
-	base::flat_set<not_null<ViewElement*>> _heavyViewParts;
+	// Grouped by delegate, so that unloading the parts of one list
+	// doesn't look through the parts of all the other lists.
+	base::flat_map<
+		not_null<HistoryView::ElementDelegate*>,
+		std::unordered_set<not_null<ViewElement*>>> _heavyViewParts;
 
 	base::flat_map<uint64, not_null<GroupCall*>> _groupCalls;
 	rpl::event_stream<InviteToCall> _invitesToCalls;
@@ -962,6 +993,10 @@ private:
 	base::Timer _unmuteByFinishedTimer;
 
 	std::unordered_map<PeerId, std::unique_ptr<PeerData>> _peers;
+	int _peersBatchLevel = 0;
+	std::unordered_map<
+		not_null<PeerData*>,
+		std::optional<base::flat_set<QChar>>> _pendingNameWords;
 
 	MessageIdsList _mimeForwardIds;
 
@@ -21,6 +21,26 @@ constexpr auto kDocumentThumbCacheMask = 0x00000000000000FFULL;
 constexpr auto kWebDocumentCacheTag = 0x0000020000000000ULL;
 constexpr auto kUrlCacheTag = 0x0000030000000000ULL;
 constexpr auto kGeoPointCacheTag = 0x0000040000000000ULL;
+constexpr auto kChatBackgroundCacheTag = 0x0000050000000000ULL;
+
+[[nodiscard]] Storage::Cache::Key HashCacheKey(
+		uint64 tag,
+		bytes::const_span data) {
+	const auto hash = openssl::Sha256(data);
+	const auto bytes = bytes::make_span(hash);
+	const auto bytes1 = bytes.subspan(0, sizeof(uint32));
+	const auto bytes2 = bytes.subspan(sizeof(uint32), sizeof(uint64));
+	const auto bytes3 = bytes.subspan(
+		sizeof(uint32) + sizeof(uint64),
+		sizeof(uint16));
+	const auto part1 = *reinterpret_cast<const uint32*>(bytes1.data());
+	const auto part2 = *reinterpret_cast<const uint64*>(bytes2.data());
+	const auto part3 = *reinterpret_cast<const uint16*>(bytes3.data());
+	return Storage::Cache::Key{
+		tag | (uint64(part3) << 32) | part1,
+		part2
+	};
+}
 
 } // namespace
 
@@ -57,20 +77,7 @@ Storage::Cache::Key WebDocumentCacheKey(const WebFileLocation &location) {
 
 Storage::Cache::Key UrlCacheKey(const QString &location) {
 	const auto url = location.toUtf8();
-	const auto hash = openssl::Sha256(bytes::make_span(url));
-	const auto bytes = bytes::make_span(hash);
-	const auto bytes1 = bytes.subspan(0, sizeof(uint32));
-	const auto bytes2 = bytes.subspan(sizeof(uint32), sizeof(uint64));
-	const auto bytes3 = bytes.subspan(
-		sizeof(uint32) + sizeof(uint64),
-		sizeof(uint16));
-	const auto part1 = *reinterpret_cast<const uint32*>(bytes1.data());
-	const auto part2 = *reinterpret_cast<const uint64*>(bytes2.data());
-	const auto part3 = *reinterpret_cast<const uint16*>(bytes3.data());
-	return Storage::Cache::Key{
-		Data::kUrlCacheTag | (uint64(part3) << 32) | part1,
-		part2
-	};
+	return HashCacheKey(Data::kUrlCacheTag, bytes::make_span(url));
 }
 
 Storage::Cache::Key GeoPointCacheKey(const GeoPointLocation &location) {
@@ -86,6 +93,12 @@ Storage::Cache::Key GeoPointCacheKey(const GeoPointLocation &location) {
 	};
 }
 
+Storage::Cache::Key ChatBackgroundCacheKey(const QByteArray &description) {
+	return HashCacheKey(
+		Data::kChatBackgroundCacheTag,
+		bytes::make_span(description));
+}
+
 } // namespace Data
 
 void MessageCursor::fillFrom(not_null<const Ui::InputField*> field) {
@@ -50,6 +50,10 @@ Storage::Cache::Key WebDocumentCacheKey(const WebFileLocation &location);
 Storage::Cache::Key UrlCacheKey(const QString &location);
 Storage::Cache::Key GeoPointCacheKey(const GeoPointLocation &location);
 
+// Prepared chat theme background, the description lists all the paper
+// properties that affect the prepared image.
+Storage::Cache::Key ChatBackgroundCacheKey(const QByteArray &description);
+
 constexpr auto kImageCacheTag = uint8(0x01);
 constexpr auto kStickerCacheTag = uint8(0x02);
 constexpr auto kVoiceMessageCacheTag = uint8(0x03);
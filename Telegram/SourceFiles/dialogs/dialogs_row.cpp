@@ -13,6 +13,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/text/text_utilities.h"
 #include "dialogs/dialogs_entry.h"
 #include "data/data_folder.h"
+#include "data/data_histories.h"
 #include "data/data_peer_values.h"
 #include "history/history.h"
 #include "lang/lang_keys.h"
@@ -317,7 +318,8 @@ void Row::validateListEntryCache() const {
 
 FakeRow::FakeRow(Key searchInChat, not_null<HistoryItem*> item)
 : _searchInChat(searchInChat)
-, _item(item) {
+, _item(item)
+, _messagesHold(Data::HoldMessages(_item->history())) {
 }
 
 } // namespace Dialogs
@@ -150,6 +150,9 @@ private:
 	not_null<HistoryItem*> _item;
 	mutable Ui::MessageView _itemView;
 
+	// Search results are not unloaded while they're shown.
+	rpl::lifetime _messagesHold;
+
 };
 
 } // namespace Dialogs
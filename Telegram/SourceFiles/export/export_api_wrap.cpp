@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "export/export_api_wrap.h"
 
 #include "export/export_settings.h"
+#include "export/export_checkpoint.h"
 #include "export/data/export_data_types.h"
 #include "export/output/export_output_result.h"
 #include "export/output/export_output_file.h"
@@ -15,6 +16,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/value_ordering.h"
 #include "base/bytes.h"
 #include "base/random.h"
+
+#include <QtCore/QCryptographicHash>
+
 #include <set>
 #include <deque>
 
@@ -24,6 +28,8 @@ namespace {
 constexpr auto kUserpicsSliceLimit = 100;
 constexpr auto kFileChunkSize = 128 * 1024;
 constexpr auto kFileRequestsCount = 2;
+constexpr auto kFileLoadsCount = 8;
+constexpr auto kFileLoadsPerDcCount = 4;
 //constexpr auto kFileNextRequestDelay = crl::time(20);
 constexpr auto kChatsSliceLimit = 100;
 constexpr auto kMessagesSliceLimit = 100;
@@ -38,6 +44,9 @@ struct LocationKey {
 	inline bool operator<(const LocationKey &other) const {
 		return std::tie(type, id) < std::tie(other.type, other.id);
 	}
+	inline bool operator==(const LocationKey &other) const {
+		return (type == other.type) && (id == other.id);
+	}
 };
 
 LocationKey ComputeLocationKey(const Data::FileLocation &value) {
@@ -88,19 +97,29 @@ Settings::Type SettingsFromDialogsType(Data::DialogInfo::Type type) {
 
 } // namespace
 
+// Recently exported files by location and by content, the same media
+// forwarded to different chats has the same location, while the same
+// content may be uploaded several times. Older locations are found in the
+// checkpoint, it knows all the files of this and of the previous exports.
 class ApiWrap::LoadedFileCache {
 public:
 	using Location = Data::FileLocation;
 
 	LoadedFileCache(int limit);
 
-	void save(const Location &location, const QString &relativePath);
+	void save(LocationKey key, const QString &relativePath);
+	void save(const QByteArray &hash, int64 size, const QString &relativePath);
 	std::optional<QString> find(const Location &location) const;
+	std::optional<QString> find(const QByteArray &hash, int64 size) const;
 
 private:
+	using ContentKey = std::pair<QByteArray, int64>;
+
 	int _limit = 0;
 	std::map<LocationKey, QString> _map;
 	std::deque<LocationKey> _list;
+	std::map<ContentKey, QString> _byContent;
+	std::deque<ContentKey> _contentList;
 
 };
 
@@ -149,6 +168,7 @@ struct ApiWrap::FileProcess {
 
 	Output::File file;
 	QString relativePath;
+	QCryptographicHash hash;
 
 	Fn<bool(FileProgress)> progress;
 	FnMut<void(const QString &relativePath)> done;
@@ -162,12 +182,18 @@ struct ApiWrap::FileProcess {
 	struct Request {
 		int offset = 0;
 		QByteArray bytes;
+		mtpRequestId requestId = 0;
 	};
 	std::deque<Request> requests;
-	mtpRequestId requestId = 0;
+
+	// Parts waiting for the file reference to be refreshed.
+	std::vector<int> referenceOffsets;
+	mtpRequestId referenceRequestId = 0;
 };
 
 struct ApiWrap::FileProgress {
+	uint64 randomId = 0;
+	QString path;
 	int ready = 0;
 	int total = 0;
 };
@@ -194,6 +220,8 @@ struct ApiWrap::DialogsProcess : ChatsProcess {
 	MTPInputPeer offsetPeer = MTP_inputPeerEmpty();
 };
 
+// Several chats can be requested at the same time, their files share
+// the limits of the parallel loads.
 struct ApiWrap::ChatProcess {
 	Data::DialogInfo info;
 
@@ -210,7 +238,13 @@ struct ApiWrap::ChatProcess {
 	Data::ParseMediaContext context;
 	std::optional<Data::MessagesSlice> slice;
 	bool lastSlice = false;
+
+	// Files of the slice are loaded in parallel, the slice is passed
+	// to the writer only after all of them are finished.
 	int fileIndex = 0;
+	int filesLoading = 0;
+	bool thumbPending = false;
+	bool waitingForFileLoad = false;
 };
 
 
@@ -295,12 +329,8 @@ ApiWrap::LoadedFileCache::LoadedFileCache(int limit) : _limit(limit) {
 }
 
 void ApiWrap::LoadedFileCache::save(
-		const Location &location,
+		LocationKey key,
 		const QString &relativePath) {
-	if (!location) {
-		return;
-	}
-	const auto key = ComputeLocationKey(location);
 	_map[key] = relativePath;
 	_list.push_back(key);
 	if (_list.size() > _limit) {
@@ -310,6 +340,20 @@ void ApiWrap::LoadedFileCache::save(
 	}
 }
 
+void ApiWrap::LoadedFileCache::save(
+		const QByteArray &hash,
+		int64 size,
+		const QString &relativePath) {
+	const auto key = ContentKey{ hash, size };
+	_byContent[key] = relativePath;
+	_contentList.push_back(key);
+	if (_contentList.size() > _limit) {
+		const auto key = _contentList.front();
+		_contentList.pop_front();
+		_byContent.erase(key);
+	}
+}
+
 std::optional<QString> ApiWrap::LoadedFileCache::find(
 		const Location &location) const {
 	if (!location) {
@@ -322,8 +366,19 @@ std::optional<QString> ApiWrap::LoadedFileCache::find(
 	return std::nullopt;
 }
 
+std::optional<QString> ApiWrap::LoadedFileCache::find(
+		const QByteArray &hash,
+		int64 size) const {
+	const auto i = _byContent.find({ hash, size });
+	if (i != end(_byContent)) {
+		return i->second;
+	}
+	return std::nullopt;
+}
+
 ApiWrap::FileProcess::FileProcess(const QString &path, Output::Stats *stats)
-: file(path, stats) {
+: file(path, stats)
+, hash(QCryptographicHash::Sha256) {
 }
 
 template <typename Request>
@@ -352,25 +407,37 @@ auto ApiWrap::splitRequest(int index, Request &&request) {
 		std::forward<Request>(request)));
 }
 
-auto ApiWrap::fileRequest(const Data::FileLocation &location, int offset) {
-	Expects(location.dcId != 0
-		|| location.data.type() == mtpc_inputTakeoutFileLocation);
+auto ApiWrap::fileRequest(not_null<FileProcess*> process, int offset) {
+	Expects(process->location.dcId != 0
+		|| process->location.data.type() == mtpc_inputTakeoutFileLocation);
 	Expects(_takeoutId.has_value());
-	Expects(_fileProcess->requestId == 0);
 
+	const auto randomId = process->randomId;
 	return std::move(_mtp.request(MTPInvokeWithTakeout<MTPupload_GetFile>(
 		MTP_long(*_takeoutId),
 		MTPupload_GetFile(
 			MTP_flags(0),
-			location.data,
+			process->location.data,
 			MTP_int(offset),
 			MTP_int(kFileChunkSize))
 	)).fail([=](const MTP::Error &result) {
-		_fileProcess->requestId = 0;
+		const auto process = fileProcess(randomId);
+		if (!process) {
+			return;
+		}
+		using Request = FileProcess::Request;
+		const auto i = ranges::find(
+			process->requests,
+			offset,
+			&Request::offset);
+		Assert(i != end(process->requests));
+		i->requestId = 0;
+
 		if (result.type() == qstr("TAKEOUT_FILE_EMPTY")
 			&& _otherDataProcess != nullptr) {
 			filePartDone(
-				0,
+				randomId,
+				offset,
 				MTP_upload_file(
 					MTP_storage_filePartial(),
 					MTP_int(0),
@@ -378,14 +445,16 @@ auto ApiWrap::fileRequest(const Data::FileLocation &location, int offset) {
 		} else if (result.type() == qstr("LOCATION_INVALID")
 			|| result.type() == qstr("VERSION_INVALID")
 			|| result.type() == qstr("LOCATION_NOT_AVAILABLE")) {
-			filePartUnavailable();
+			filePartUnavailable(randomId);
 		} else if (result.code() == 400
 			&& result.type().startsWith(qstr("FILE_REFERENCE_"))) {
-			filePartRefreshReference(offset);
+			filePartRefreshReference(randomId, offset);
 		} else {
 			error(std::move(result));
 		}
-	}).toDC(MTP::ShiftDcId(location.dcId, MTP::kExportMediaDcShift)));
+	}).toDC(MTP::ShiftDcId(
+		process->location.dcId,
+		MTP::kExportMediaDcShift)));
 }
 
 ApiWrap::ApiWrap(QPointer<MTP::Instance> weak, Fn<void(FnMut<void()>)> runner)
@@ -404,12 +473,15 @@ rpl::producer<Output::Result> ApiWrap::ioErrors() const {
 void ApiWrap::startExport(
 		const Settings &settings,
 		Output::Stats *stats,
+		Checkpoint *checkpoint,
 		FnMut<void(StartInfo)> done) {
 	Expects(_settings == nullptr);
 	Expects(_startProcess == nullptr);
 
 	_settings = std::make_unique<Settings>(settings);
 	_stats = stats;
+	_checkpoint = checkpoint;
+	restoreExportedFiles();
 	_startProcess = std::make_unique<StartProcess>();
 	_startProcess->done = std::move(done);
 
@@ -572,6 +644,33 @@ void ApiWrap::finishStartProcess() {
 	process->done(process->info);
 }
 
+void ApiWrap::restoreExportedFiles() {
+	Expects(_settings != nullptr);
+
+	if (!_checkpoint) {
+		return;
+	}
+
+	// Files of the interrupted or of the previous exports are used
+	// as if they were loaded, if they weren't changed or removed since then.
+	auto &files = _checkpoint->files;
+	for (auto i = begin(files); i != end(files);) {
+		const auto &[key, file] = *i;
+		const auto info = QFileInfo(_settings->path + file.relativePath);
+		if (!info.isFile() || info.size() != file.size) {
+			i = files.erase(i);
+			continue;
+		}
+		_fileCache->save(
+			LocationKey{ key.first, key.second },
+			file.relativePath);
+		if (!file.hash.isEmpty()) {
+			_fileCache->save(file.hash, file.size, file.relativePath);
+		}
+		++i;
+	}
+}
+
 bool ApiWrap::useOnlyLastSplit() const {
 	return !(_settings->types & Settings::Type::NonChannelChatsMask);
 }
@@ -819,7 +918,6 @@ void ApiWrap::finishUserpicsSlice() {
 }
 
 bool ApiWrap::loadUserpicProgress(FileProgress progress) {
-	Expects(_fileProcess != nullptr);
 	Expects(_userpicsProcess != nullptr);
 	Expects(_userpicsProcess->slice.has_value());
 	Expects((_userpicsProcess->fileIndex >= 0)
@@ -827,8 +925,8 @@ bool ApiWrap::loadUserpicProgress(FileProgress progress) {
 			< _userpicsProcess->slice->list.size()));
 
 	return _userpicsProcess->fileProgress(DownloadProgress{
-		_fileProcess->randomId,
-		_fileProcess->relativePath,
+		progress.randomId,
+		progress.path,
 		_userpicsProcess->fileIndex,
 		progress.ready,
 		progress.total });
@@ -939,32 +1037,53 @@ void ApiWrap::requestMessages(
 		Fn<bool(DownloadProgress)> progress,
 		Fn<bool(Data::MessagesSlice&&)> slice,
 		FnMut<void()> done) {
-	Expects(_chatProcess == nullptr);
+	Expects(!_chatProcesses.contains(info.peerId));
 	Expects(_selfId.has_value());
 
-	_chatProcess = std::make_unique<ChatProcess>();
-	_chatProcess->context.selfPeerId = peerFromUser(*_selfId);
-	_chatProcess->info = info;
-	_chatProcess->start = std::move(start);
-	_chatProcess->fileProgress = std::move(progress);
-	_chatProcess->handleSlice = std::move(slice);
-	_chatProcess->done = std::move(done);
+	const auto process = _chatProcesses.emplace(
+		info.peerId,
+		std::make_unique<ChatProcess>()).first->second.get();
+	process->context.selfPeerId = peerFromUser(*_selfId);
+	process->info = info;
+	process->start = std::move(start);
+	process->fileProgress = std::move(progress);
+	process->handleSlice = std::move(slice);
+	process->done = std::move(done);
+	process->largestIdPlusOne = messagesOffsetId(process, 0);
 
-	requestMessagesCount(0);
+	requestMessagesCount(process, 0);
 }
 
-void ApiWrap::requestMessagesCount(int localSplitIndex) {
-	Expects(_chatProcess != nullptr);
-	Expects(localSplitIndex < _chatProcess->info.splits.size());
+int32 ApiWrap::messagesOffsetId(
+		not_null<ChatProcess*> process,
+		int localSplitIndex) const {
+	Expects(localSplitIndex < process->info.splits.size());
 
+	if (!_checkpoint) {
+		return 1;
+	}
+	const auto since = _checkpoint->since(process->info.peerId);
+	const auto migrated = (process->info.splits[localSplitIndex] < 0);
+	return 1 + (migrated
+		? since.lastMigratedMessageId
+		: since.lastMessageId);
+}
+
+void ApiWrap::requestMessagesCount(
+		not_null<ChatProcess*> process,
+		int localSplitIndex) {
+	Expects(localSplitIndex < process->info.splits.size());
+
+	// In the incremental mode only the messages after the checkpoint
+	// are exported, so only they are counted as well.
 	requestChatMessages(
-		_chatProcess->info.splits[localSplitIndex],
+		process,
+		process->info.splits[localSplitIndex],
 		0, // offset_id
 		0, // add_offset
 		1, // limit
+		messagesOffsetId(process, localSplitIndex) - 1, // min_id
 		[=](const MTPmessages_Messages &result) {
-		Expects(_chatProcess != nullptr);
-
 		const auto count = result.match(
 			[](const MTPDmessages_messages &data) {
 			return int(data.vmessages().v.size());
@@ -984,47 +1103,51 @@ void ApiWrap::requestMessagesCount(int localSplitIndex) {
 			_settings->singlePeerFrom);
 		if (skipSplit) {
 			// No messages from the requested range, skip this split.
-			messagesCountLoaded(localSplitIndex, 0);
+			messagesCountLoaded(process, localSplitIndex, 0);
 			return;
 		}
-		checkFirstMessageDate(localSplitIndex, count);
+		checkFirstMessageDate(process, localSplitIndex, count);
 	});
 }
 
-void ApiWrap::checkFirstMessageDate(int localSplitIndex, int count) {
-	Expects(_chatProcess != nullptr);
-	Expects(localSplitIndex < _chatProcess->info.splits.size());
+void ApiWrap::checkFirstMessageDate(
+		not_null<ChatProcess*> process,
+		int localSplitIndex,
+		int count) {
+	Expects(localSplitIndex < process->info.splits.size());
 
 	if (_settings->singlePeerTill <= 0) {
-		messagesCountLoaded(localSplitIndex, count);
+		messagesCountLoaded(process, localSplitIndex, count);
 		return;
 	}
 
 	// Request first message in this split to check if its' date < till.
 	requestChatMessages(
-		_chatProcess->info.splits[localSplitIndex],
+		process,
+		process->info.splits[localSplitIndex],
 		1, // offset_id
 		-1, // add_offset
 		1, // limit
+		0, // min_id
 		[=](const MTPmessages_Messages &result) {
-		Expects(_chatProcess != nullptr);
-
 		const auto skipSplit = !Data::SingleMessageBefore(
 			result,
 			_settings->singlePeerTill);
-		messagesCountLoaded(localSplitIndex, skipSplit ? 0 : count);
+		messagesCountLoaded(process, localSplitIndex, skipSplit ? 0 : count);
 	});
 }
 
-void ApiWrap::messagesCountLoaded(int localSplitIndex, int count) {
-	Expects(_chatProcess != nullptr);
-	Expects(localSplitIndex < _chatProcess->info.splits.size());
+void ApiWrap::messagesCountLoaded(
+		not_null<ChatProcess*> process,
+		int localSplitIndex,
+		int count) {
+	Expects(localSplitIndex < process->info.splits.size());
 
-	_chatProcess->info.messagesCountPerSplit[localSplitIndex] = count;
-	if (localSplitIndex + 1 < _chatProcess->info.splits.size()) {
-		requestMessagesCount(localSplitIndex + 1);
-	} else if (_chatProcess->start(_chatProcess->info)) {
-		requestMessagesSlice();
+	process->info.messagesCountPerSplit[localSplitIndex] = count;
+	if (localSplitIndex + 1 < process->info.splits.size()) {
+		requestMessagesCount(process, localSplitIndex + 1);
+	} else if (process->start(process->info)) {
+		requestMessagesSlice(process);
 	}
 }
 
@@ -1037,14 +1160,11 @@ void ApiWrap::finishExport(FnMut<void()> done) {
 }
 
 void ApiWrap::skipFile(uint64 randomId) {
-	if (!_fileProcess || _fileProcess->randomId != randomId) {
+	if (!fileProcess(randomId)) {
 		return;
 	}
 	LOG(("Export Info: File skipped."));
-	Assert(!_fileProcess->requests.empty());
-	Assert(_fileProcess->requestId != 0);
-	_mtp.request(base::take(_fileProcess->requestId)).cancel();
-	base::take(_fileProcess)->done(QString());
+	takeFileProcess(randomId)->done(QString());
 }
 
 void ApiWrap::cancelExportFast() {
@@ -1359,61 +1479,59 @@ void ApiWrap::appendChatsSlice(
 	}
 }
 
-void ApiWrap::requestMessagesSlice() {
-	Expects(_chatProcess != nullptr);
+void ApiWrap::requestMessagesSlice(not_null<ChatProcess*> process) {
 
-	const auto count = _chatProcess->info.messagesCountPerSplit[
-		_chatProcess->localSplitIndex];
+	const auto count = process->info.messagesCountPerSplit[
+		process->localSplitIndex];
 	if (!count) {
-		loadMessagesFiles({});
+		loadMessagesFiles(process, {});
 		return;
 	}
 	requestChatMessages(
-		_chatProcess->info.splits[_chatProcess->localSplitIndex],
-		_chatProcess->largestIdPlusOne,
+		process,
+		process->info.splits[process->localSplitIndex],
+		process->largestIdPlusOne,
 		-kMessagesSliceLimit,
 		kMessagesSliceLimit,
+		0, // min_id
 		[=](const MTPmessages_Messages &result) {
-		Expects(_chatProcess != nullptr);
-
 		result.match([&](const MTPDmessages_messagesNotModified &data) {
 			error("Unexpected messagesNotModified received.");
 		}, [&](const auto &data) {
 			if constexpr (MTPDmessages_messages::Is<decltype(data)>()) {
-				_chatProcess->lastSlice = true;
+				process->lastSlice = true;
 			}
-			loadMessagesFiles(Data::ParseMessagesSlice(
-				_chatProcess->context,
+			loadMessagesFiles(process, Data::ParseMessagesSlice(
+				process->context,
 				data.vmessages(),
 				data.vusers(),
 				data.vchats(),
-				_chatProcess->info.relativePath));
+				process->info.relativePath));
 		});
 	});
 }
 
 void ApiWrap::requestChatMessages(
+		not_null<ChatProcess*> process,
 		int splitIndex,
 		int offsetId,
 		int addOffset,
 		int limit,
+		int minId,
 		FnMut<void(MTPmessages_Messages&&)> done) {
-	Expects(_chatProcess != nullptr);
 
-	_chatProcess->requestDone = std::move(done);
+	process->requestDone = std::move(done);
 	const auto doneHandler = [=](MTPmessages_Messages &&result) {
-		Expects(_chatProcess != nullptr);
-
-		base::take(_chatProcess->requestDone)(std::move(result));
+		base::take(process->requestDone)(std::move(result));
 	};
 	const auto splitsCount = int(_splits.size());
 	const auto realPeerInput = (splitIndex >= 0)
-		? _chatProcess->info.input
-		: _chatProcess->info.migratedFromInput;
+		? process->info.input
+		: process->info.migratedFromInput;
 	const auto realSplitIndex = (splitIndex >= 0)
 		? splitIndex
 		: (splitsCount + splitIndex);
-	if (_chatProcess->info.onlyMyMessages) {
+	if (process->info.onlyMyMessages) {
 		splitRequest(realSplitIndex, MTPmessages_Search(
 			MTP_flags(MTPmessages_Search::Flag::f_from_id),
 			realPeerInput,
@@ -1427,7 +1545,7 @@ void ApiWrap::requestChatMessages(
 			MTP_int(addOffset),
 			MTP_int(limit),
 			MTP_int(0), // max_id
-			MTP_int(0), // min_id
+			MTP_int(minId),
 			MTP_long(0) // hash
 		)).done(doneHandler).send();
 	} else {
@@ -1438,24 +1556,24 @@ void ApiWrap::requestChatMessages(
 			MTP_int(addOffset),
 			MTP_int(limit),
 			MTP_int(0), // max_id
-			MTP_int(0), // min_id
+			MTP_int(minId),
 			MTP_long(0)  // hash
 		)).fail([=](const MTP::Error &error) {
-			Expects(_chatProcess != nullptr);
-
 			if (error.type() == qstr("CHANNEL_PRIVATE")) {
 				if (realPeerInput.type() == mtpc_inputPeerChannel
-					&& !_chatProcess->info.onlyMyMessages) {
+					&& !process->info.onlyMyMessages) {
 
 					// Perhaps we just left / were kicked from channel.
 					// Just switch to only my messages.
-					_chatProcess->info.onlyMyMessages = true;
+					process->info.onlyMyMessages = true;
 					requestChatMessages(
+						process,
 						splitIndex,
 						offsetId,
 						addOffset,
 						limit,
-						base::take(_chatProcess->requestDone));
+						minId,
+						base::take(process->requestDone));
 					return true;
 				}
 			}
@@ -1464,166 +1582,196 @@ void ApiWrap::requestChatMessages(
 	}
 }
 
-void ApiWrap::loadMessagesFiles(Data::MessagesSlice &&slice) {
-	Expects(_chatProcess != nullptr);
-	Expects(!_chatProcess->slice.has_value());
+void ApiWrap::loadMessagesFiles(
+		not_null<ChatProcess*> process,
+		Data::MessagesSlice &&slice) {
+	Expects(!process->slice.has_value());
+	Expects(!process->filesLoading);
 
 	if (slice.list.empty()) {
-		_chatProcess->lastSlice = true;
+		process->lastSlice = true;
 	}
-	_chatProcess->slice = std::move(slice);
-	_chatProcess->fileIndex = 0;
-
-	loadNextMessageFile();
-}
-
-Data::Message *ApiWrap::currentFileMessage() const {
-	Expects(_chatProcess != nullptr);
-	Expects(_chatProcess->slice.has_value());
+	process->slice = std::move(slice);
+	process->fileIndex = 0;
+	process->thumbPending = false;
 
-	return &_chatProcess->slice->list[_chatProcess->fileIndex];
+	loadNextMessageFile(process);
 }
 
-Data::FileOrigin ApiWrap::currentFileMessageOrigin() const {
-	Expects(_chatProcess != nullptr);
-	Expects(_chatProcess->slice.has_value());
+Data::FileOrigin ApiWrap::fileMessageOrigin(
+		not_null<ChatProcess*> process,
+		int index) const {
+	Expects(process->slice.has_value());
+	Expects(index >= 0 && index < process->slice->list.size());
 
-	const auto splitIndex = _chatProcess->info.splits[
-		_chatProcess->localSplitIndex];
+	const auto splitIndex = process->info.splits[
+		process->localSplitIndex];
 	auto result = Data::FileOrigin();
-	result.messageId = currentFileMessage()->id;
+	result.messageId = process->slice->list[index].id;
 	result.split = (splitIndex >= 0)
 		? splitIndex
 		: (int(_splits.size()) + splitIndex);
 	result.peer = (splitIndex >= 0)
-		? _chatProcess->info.input
-		: _chatProcess->info.migratedFromInput;
+		? process->info.input
+		: process->info.migratedFromInput;
 	return result;
 }
 
-void ApiWrap::loadNextMessageFile() {
-	Expects(_chatProcess != nullptr);
-	Expects(_chatProcess->slice.has_value());
+void ApiWrap::loadNextMessageFile(not_null<ChatProcess*> process) {
+	Expects(process->slice.has_value());
 
-	for (auto &list = _chatProcess->slice->list
-		; _chatProcess->fileIndex < list.size()
-		; ++_chatProcess->fileIndex) {
-		const auto &message = list[_chatProcess->fileIndex];
-		if (Data::SkipMessageByDate(message, *_settings)) {
+	for (auto &list = process->slice->list
+		; process->fileIndex < list.size()
+		; ++process->fileIndex) {
+		const auto index = process->fileIndex;
+		if (Data::SkipMessageByDate(list[index], *_settings)) {
 			continue;
 		}
-		const auto fileProgress = [=](FileProgress value) {
-			return loadMessageFileProgress(value);
-		};
-		const auto ready = processFileLoad(
-			list[_chatProcess->fileIndex].file(),
-			currentFileMessageOrigin(),
-			fileProgress,
-			[=](const QString &path) { loadMessageFileDone(path); },
-			currentFileMessage());
-		if (!ready) {
-			return;
+		if (!process->thumbPending) {
+			if (!startMessageFile(process, index, false)) {
+				process->waitingForFileLoad = true;
+				return;
+			}
+			process->thumbPending = true;
 		}
-		const auto thumbProgress = [=](FileProgress value) {
-			return loadMessageThumbProgress(value);
-		};
-		const auto thumbReady = processFileLoad(
-			list[_chatProcess->fileIndex].thumb().file,
-			currentFileMessageOrigin(),
-			thumbProgress,
-			[=](const QString &path) { loadMessageThumbDone(path); },
-			currentFileMessage());
-		if (!thumbReady) {
+		if (!startMessageFile(process, index, true)) {
+			process->waitingForFileLoad = true;
 			return;
 		}
+		process->thumbPending = false;
+	}
+	if (!process->filesLoading) {
+		finishMessagesSlice(process);
+	}
+}
+
+bool ApiWrap::startMessageFile(
+		not_null<ChatProcess*> process,
+		int index,
+		bool thumb) {
+	Expects(process->slice.has_value());
+
+	auto &message = process->slice->list[index];
+	auto &file = thumb ? message.thumb().file : message.file();
+	if (!fileLoadAllowed(file.location)) {
+		return false;
 	}
-	finishMessagesSlice();
+	const auto ready = processFileLoad(
+		file,
+		fileMessageOrigin(process, index),
+		[=](FileProgress value) {
+			return loadMessageFileProgress(process, index, value);
+		},
+		[=](const QString &path) {
+			loadMessageFileDone(process, index, thumb, path);
+		},
+		&message);
+	if (!ready) {
+		++process->filesLoading;
+	}
+	return true;
 }
 
-void ApiWrap::finishMessagesSlice() {
-	Expects(_chatProcess != nullptr);
-	Expects(_chatProcess->slice.has_value());
+void ApiWrap::finishMessagesSlice(not_null<ChatProcess*> process) {
+	Expects(process->slice.has_value());
 
-	auto slice = *base::take(_chatProcess->slice);
+	auto slice = *base::take(process->slice);
 	if (!slice.list.empty()) {
-		_chatProcess->largestIdPlusOne = slice.list.back().id + 1;
-		const auto splitIndex = _chatProcess->info.splits[
-			_chatProcess->localSplitIndex];
+		process->largestIdPlusOne = slice.list.back().id + 1;
+		const auto splitIndex = process->info.splits[
+			process->localSplitIndex];
+		if (_checkpoint) {
+			_checkpoint->messageExported(
+				process->info.peerId,
+				(splitIndex < 0),
+				slice.list.back().id);
+		}
 		if (splitIndex < 0) {
 			slice = AdjustMigrateMessageIds(std::move(slice));
 		}
-		if (!_chatProcess->handleSlice(std::move(slice))) {
+		if (!process->handleSlice(std::move(slice))) {
 			return;
 		}
 	}
-	if (_chatProcess->lastSlice
-		&& (++_chatProcess->localSplitIndex
-			< _chatProcess->info.splits.size())) {
-		_chatProcess->lastSlice = false;
-		_chatProcess->largestIdPlusOne = 1;
+	if (process->lastSlice
+		&& (++process->localSplitIndex
+			< process->info.splits.size())) {
+		process->lastSlice = false;
+		process->largestIdPlusOne = messagesOffsetId(
+			process,
+			process->localSplitIndex);
 	}
-	if (!_chatProcess->lastSlice) {
-		requestMessagesSlice();
+	if (!process->lastSlice) {
+		requestMessagesSlice(process);
 	} else {
-		finishMessages();
+		finishMessages(process);
 	}
 }
 
-bool ApiWrap::loadMessageFileProgress(FileProgress progress) {
-	Expects(_fileProcess != nullptr);
-	Expects(_chatProcess != nullptr);
-	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
+bool ApiWrap::loadMessageFileProgress(
+		not_null<ChatProcess*> process,
+		int index,
+		FileProgress progress) {
+	Expects(process->slice.has_value());
+	Expects(index >= 0 && index < process->slice->list.size());
 
-	return _chatProcess->fileProgress(DownloadProgress{
-		.randomId = _fileProcess->randomId,
-		.path = _fileProcess->relativePath,
-		.itemIndex = _chatProcess->fileIndex,
+	return process->fileProgress(DownloadProgress{
+		.randomId = progress.randomId,
+		.path = progress.path,
+		.itemIndex = index,
 		.ready = progress.ready,
 		.total = progress.total });
 }
 
-void ApiWrap::loadMessageFileDone(const QString &relativePath) {
-	Expects(_chatProcess != nullptr);
-	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
+void ApiWrap::loadMessageFileDone(
+		not_null<ChatProcess*> process,
+		int index,
+		bool thumb,
+		const QString &relativePath) {
+	Expects(process->slice.has_value());
+	Expects(index >= 0 && index < process->slice->list.size());
+	Expects(process->filesLoading > 0);
 
-	const auto index = _chatProcess->fileIndex;
-	auto &file = _chatProcess->slice->list[index].file();
+	auto &message = process->slice->list[index];
+	auto &file = thumb ? message.thumb().file : message.file();
 	file.relativePath = relativePath;
 	if (relativePath.isEmpty()) {
 		file.skipReason = Data::File::SkipReason::Unavailable;
 	}
-	loadNextMessageFile();
-}
+	--process->filesLoading;
+	process->waitingForFileLoad = false;
+	loadNextMessageFile(process);
 
-bool ApiWrap::loadMessageThumbProgress(FileProgress progress) {
-	return loadMessageFileProgress(progress);
+	// The finished load may allow the files of the other chats.
+	resumeMessagesFiles();
 }
 
-void ApiWrap::loadMessageThumbDone(const QString &relativePath) {
-	Expects(_chatProcess != nullptr);
-	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
+void ApiWrap::finishMessages(not_null<ChatProcess*> process) {
+	Expects(!process->slice.has_value());
 
-	const auto index = _chatProcess->fileIndex;
-	auto &file = _chatProcess->slice->list[index].thumb().file;
-	file.relativePath = relativePath;
-	if (relativePath.isEmpty()) {
-		file.skipReason = Data::File::SkipReason::Unavailable;
-	}
-	loadNextMessageFile();
+	const auto i = _chatProcesses.find(process->info.peerId);
+	Assert(i != end(_chatProcesses));
+	auto done = std::move(i->second->done);
+	_chatProcesses.erase(i);
+	done();
 }
 
-void ApiWrap::finishMessages() {
-	Expects(_chatProcess != nullptr);
-	Expects(!_chatProcess->slice.has_value());
+void ApiWrap::resumeMessagesFiles() {
+	auto waiting = std::vector<PeerId>();
+	for (const auto &[peer, process] : _chatProcesses) {
+		if (process->waitingForFileLoad) {
+			waiting.push_back(peer);
+		}
+	}
 
-	const auto process = base::take(_chatProcess);
-	process->done();
+	// Chats can be finished and started while we resume the others.
+	for (const auto peer : waiting) {
+		const auto i = _chatProcesses.find(peer);
+		if (i != end(_chatProcesses) && i->second->waitingForFileLoad) {
+			i->second->waitingForFileLoad = false;
+			loadNextMessageFile(i->second.get());
+		}
+	}
 }
 
 bool ApiWrap::processFileLoad(
@@ -1687,14 +1835,25 @@ bool ApiWrap::writePreloadedFile(
 
 	using namespace Output;
 
-	if (const auto path = _fileCache->find(file.location)) {
+	if (const auto path = findExportedFile(file)) {
 		file.relativePath = *path;
 		return true;
 	} else if (!file.content.isEmpty()) {
 		const auto process = prepareFileProcess(file, origin);
-		if (const auto result = process->file.writeBlock(file.content)) {
-			file.relativePath = process->relativePath;
-			_fileCache->save(file.location, file.relativePath);
+		auto result = process->file.writeBlock(file.content);
+		if (result) {
+			result = process->file.close();
+		}
+		if (result) {
+			const auto size = int64(process->file.size());
+			const auto hash = QCryptographicHash::hash(
+				file.content,
+				QCryptographicHash::Sha256);
+			file.relativePath = deduplicateFile(
+				process->relativePath,
+				size,
+				hash);
+			fileSaved(file.location, file.relativePath, size, hash);
 		} else {
 			ioError(result);
 		}
@@ -1703,32 +1862,165 @@ bool ApiWrap::writePreloadedFile(
 	return false;
 }
 
+std::optional<QString> ApiWrap::findExportedFile(const Data::File &file) {
+	Expects(_settings != nullptr);
+
+	if (!file.location) {
+		return std::nullopt;
+	}
+	auto path = _fileCache->find(file.location);
+	if (!_checkpoint) {
+		return path;
+	}
+
+	// Look for the files evicted from the cache in the checkpoint before
+	// downloading anything, the same id with another size is not reused.
+	const auto key = ComputeLocationKey(file.location);
+	const auto i = _checkpoint->files.find({ key.type, key.id });
+	if (i == end(_checkpoint->files)) {
+		return path;
+	} else if (!path) {
+		if (file.size > 0 && i->second.size != file.size) {
+			return std::nullopt;
+		}
+		path = i->second.relativePath;
+		_fileCache->save(key, *path);
+	}
+	if (!path->startsWith("../")) {
+		return path;
+	}
+	const auto exported = i->second;
+	const auto result = linkExportedFile(
+		*path,
+		Output::File::PrepareRelativePath(
+			_settings->path,
+			file.suggestedPath));
+	if (result != *path) {
+		fileSaved(file.location, result, exported.size, exported.hash);
+	}
+	return result;
+}
+
+QString ApiWrap::linkExportedFile(
+		const QString &existing,
+		const QString &relativePath) const {
+	Expects(_settings != nullptr);
+
+	// Files of the previous exports are hard-linked to the export folder
+	// if possible, so that it stays complete without them.
+	if (!existing.startsWith("../")) {
+		return existing;
+	}
+	const auto linked = Output::File::Link(
+		_settings->path + existing,
+		_settings->path + relativePath);
+	return linked ? relativePath : existing;
+}
+
+QString ApiWrap::deduplicateFile(
+		const QString &relativePath,
+		int64 size,
+		const QByteArray &hash) {
+	Expects(_settings != nullptr);
+
+	if (hash.isEmpty() || !size) {
+		return relativePath;
+	}
+	const auto existing = _fileCache->find(hash, size);
+	if (!existing
+		|| *existing == relativePath
+		|| !QFile::exists(_settings->path + *existing)) {
+		_fileCache->save(hash, size, relativePath);
+		return relativePath;
+	} else if (!QFile::remove(_settings->path + relativePath)) {
+		return relativePath;
+	}
+	const auto result = linkExportedFile(*existing, relativePath);
+	_fileCache->save(hash, size, result);
+	return result;
+}
+
+bool ApiWrap::fileLoadAllowed(const Data::FileLocation &location) const {
+	if (int(_fileProcesses.size()) >= kFileLoadsCount) {
+		return false;
+	} else if (!location) {
+		return true;
+	}
+	const auto i = _fileLoadsPerDc.find(location.dcId);
+	if (i != end(_fileLoadsPerDc) && i->second >= kFileLoadsPerDcCount) {
+		return false;
+	}
+
+	// Wait for the same file to be loaded and take it from the cache.
+	const auto key = ComputeLocationKey(location);
+	for (const auto &[randomId, process] : _fileProcesses) {
+		if (process->location
+			&& ComputeLocationKey(process->location) == key) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void ApiWrap::loadFile(
 		const Data::File &file,
 		const Data::FileOrigin &origin,
 		Fn<bool(FileProgress)> progress,
 		FnMut<void(QString)> done) {
-	Expects(_fileProcess == nullptr);
 	Expects(file.location.dcId != 0
 		|| file.location.data.type() == mtpc_inputTakeoutFileLocation);
 
-	_fileProcess = prepareFileProcess(file, origin);
-	_fileProcess->progress = std::move(progress);
-	_fileProcess->done = std::move(done);
+	auto owned = prepareFileProcess(file, origin);
+	const auto process = owned.get();
+	const auto randomId = process->randomId;
+	process->progress = std::move(progress);
+	process->done = std::move(done);
+	_fileProcesses.emplace(randomId, std::move(owned));
+	++_fileLoadsPerDc[process->location.dcId];
 
-	if (_fileProcess->progress) {
+	if (process->progress) {
 		const auto progress = FileProgress{
-			_fileProcess->file.size(),
-			_fileProcess->size
+			.randomId = randomId,
+			.path = process->relativePath,
+			.ready = process->file.size(),
+			.total = process->size,
 		};
-		if (!_fileProcess->progress(progress)) {
+		if (!process->progress(progress)) {
 			return;
 		}
 	}
 
-	loadFilePart();
+	loadFilePart(randomId);
+}
+
+auto ApiWrap::fileProcess(uint64 randomId) const -> FileProcess* {
+	const auto i = _fileProcesses.find(randomId);
+	return (i != end(_fileProcesses)) ? i->second.get() : nullptr;
+}
+
+auto ApiWrap::takeFileProcess(uint64 randomId)
+-> std::unique_ptr<FileProcess> {
+	const auto i = _fileProcesses.find(randomId);
+	Assert(i != end(_fileProcesses));
+
+	auto result = std::move(i->second);
+	_fileProcesses.erase(i);
+
+	const auto j = _fileLoadsPerDc.find(result->location.dcId);
+	Assert(j != end(_fileLoadsPerDc));
+	if (!--j->second) {
+		_fileLoadsPerDc.erase(j);
+	}
 
-	Ensures(_fileProcess->requestId != 0);
+	for (auto &request : result->requests) {
+		if (request.requestId) {
+			_mtp.request(base::take(request.requestId)).cancel();
+		}
+	}
+	if (result->referenceRequestId) {
+		_mtp.request(base::take(result->referenceRequestId)).cancel();
+	}
+	return result;
 }
 
 auto ApiWrap::prepareFileProcess(
@@ -1751,43 +2043,56 @@ auto ApiWrap::prepareFileProcess(
 	return result;
 }
 
-void ApiWrap::loadFilePart() {
-	if (!_fileProcess
-		|| _fileProcess->requestId
-		|| _fileProcess->requests.size() >= kFileRequestsCount
-		|| (_fileProcess->size > 0
-			&& _fileProcess->offset >= _fileProcess->size)) {
+void ApiWrap::loadFilePart(uint64 randomId) {
+	const auto process = fileProcess(randomId);
+	if (!process) {
 		return;
 	}
 
-	const auto offset = _fileProcess->offset;
-	_fileProcess->requests.push_back({ offset });
-	_fileProcess->requestId = fileRequest(
-		_fileProcess->location,
-		_fileProcess->offset
+	// While the size is unknown we request parts one by one
+	// until an empty part is received.
+	const auto limit = (process->size > 0) ? kFileRequestsCount : 1;
+	while (process->requests.size() < limit
+		&& process->referenceOffsets.empty()
+		&& !(process->size > 0 && process->offset >= process->size)) {
+		const auto offset = process->offset;
+		process->requests.push_back({ .offset = offset });
+		sendFilePart(process, offset);
+		process->offset += kFileChunkSize;
+	}
+}
+
+void ApiWrap::sendFilePart(not_null<FileProcess*> process, int offset) {
+	using Request = FileProcess::Request;
+	const auto i = ranges::find(
+		process->requests,
+		offset,
+		&Request::offset);
+	Assert(i != end(process->requests));
+	Assert(i->requestId == 0);
+
+	const auto randomId = process->randomId;
+	i->requestId = fileRequest(
+		process,
+		offset
 	).done([=](const MTPupload_File &result) {
-		_fileProcess->requestId = 0;
-		filePartDone(offset, result);
+		filePartDone(randomId, offset, result);
 	}).send();
-	_fileProcess->offset += kFileChunkSize;
-
-	if (_fileProcess->size > 0
-		&& _fileProcess->requests.size() < kFileRequestsCount) {
-		// Only one request at a time supported right now.
-		//const auto runner = _runner;
-		//crl::on_main([=] {
-		//	QTimer::singleShot(kFileNextRequestDelay, [=] {
-		//		runner([=] {
-		//			loadFilePart();
-		//		});
-		//	});
-		//});
-	}
 }
 
-void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
-	Expects(_fileProcess != nullptr);
-	Expects(!_fileProcess->requests.empty());
+void ApiWrap::filePartDone(
+		uint64 randomId,
+		int offset,
+		const MTPupload_File &result) {
+	const auto process = fileProcess(randomId);
+	if (!process) {
+		return;
+	}
+	using Request = FileProcess::Request;
+	auto &requests = process->requests;
+	const auto i = ranges::find(requests, offset, &Request::offset);
+	Assert(i != end(requests));
+	i->requestId = 0;
 
 	if (result.type() == mtpc_upload_fileCdnRedirect) {
 		error("Cdn redirect is not supported.");
@@ -1795,65 +2100,106 @@ void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
 	}
 	const auto &data = result.c_upload_file();
 	if (data.vbytes().v.isEmpty()) {
-		if (_fileProcess->size > 0) {
+		if (process->size > 0) {
 			error("Empty bytes received in file part.");
 			return;
 		}
-		const auto result = _fileProcess->file.writeBlock({});
+		const auto result = process->file.writeBlock({});
 		if (!result) {
 			ioError(result);
 			return;
 		}
 	} else {
-		using Request = FileProcess::Request;
-		auto &requests = _fileProcess->requests;
-		const auto i = ranges::find(
-			requests,
-			offset,
-			[](const Request &request) { return request.offset; });
-		Assert(i != end(requests));
-
 		i->bytes = data.vbytes().v;
 
-		auto &file = _fileProcess->file;
+		auto &file = process->file;
 		while (!requests.empty() && !requests.front().bytes.isEmpty()) {
 			const auto &bytes = requests.front().bytes;
 			if (const auto result = file.writeBlock(bytes); !result) {
 				ioError(result);
 				return;
 			}
+			process->hash.addData(bytes);
 			requests.pop_front();
 		}
 
-		if (_fileProcess->progress) {
-			_fileProcess->progress(FileProgress{
-				file.size(),
-				_fileProcess->size });
+		if (process->progress) {
+			process->progress(FileProgress{
+				.randomId = randomId,
+				.path = process->relativePath,
+				.ready = file.size(),
+				.total = process->size,
+			});
 		}
 
 		if (!requests.empty()
-			|| !_fileProcess->size
-			|| _fileProcess->size > _fileProcess->offset) {
-			loadFilePart();
+			|| !process->size
+			|| process->size > process->offset) {
+			loadFilePart(randomId);
 			return;
 		}
 	}
 
-	auto process = base::take(_fileProcess);
-	const auto relativePath = process->relativePath;
-	_fileCache->save(process->location, relativePath);
-	process->done(process->relativePath);
+	auto taken = takeFileProcess(randomId);
+	if (const auto result = taken->file.close(); !result) {
+		ioError(result);
+		return;
+	}
+	const auto size = int64(taken->file.size());
+	const auto hash = taken->hash.result();
+	const auto relativePath = deduplicateFile(
+		taken->relativePath,
+		size,
+		hash);
+	fileSaved(taken->location, relativePath, size, hash);
+	taken->done(relativePath);
+}
+
+void ApiWrap::fileSaved(
+		const Data::FileLocation &location,
+		const QString &relativePath,
+		int64 size,
+		const QByteArray &hash) {
+	if (!location) {
+		return;
+	}
+	const auto key = ComputeLocationKey(location);
+	_fileCache->save(key, relativePath);
+	if (_checkpoint) {
+		_checkpoint->fileExported(
+			{ key.type, key.id },
+			relativePath,
+			size,
+			hash);
+	}
 }
 
-void ApiWrap::filePartRefreshReference(int offset) {
-	Expects(_fileProcess != nullptr);
-	Expects(_fileProcess->requestId == 0);
+void ApiWrap::filePartRefreshReference(uint64 randomId, int offset) {
+	const auto process = fileProcess(randomId);
+	Assert(process != nullptr);
 
-	const auto &origin = _fileProcess->origin;
+	process->referenceOffsets.push_back(offset);
+	if (process->referenceRequestId) {
+		return;
+	}
+	const auto &origin = process->origin;
 	if (!origin.messageId) {
 		error("FILE_REFERENCE error for non-message file.");
 		return;
 	}
+	const auto fail = [=](const MTP::Error &error) {
+		if (const auto process = fileProcess(randomId)) {
+			process->referenceRequestId = 0;
+			filePartUnavailable(randomId);
+		}
+		return true;
+	};
+	const auto done = [=](const MTPmessages_Messages &result) {
+		if (const auto process = fileProcess(randomId)) {
+			process->referenceRequestId = 0;
+			filePartExtractReference(randomId, result);
+		}
+	};
 	if (origin.peer.type() == mtpc_inputPeerChannel
 		|| origin.peer.type() == mtpc_inputPeerChannelFromMessage) {
 		const auto channel = (origin.peer.type() == mtpc_inputPeerChannel)
@@ -1864,43 +2210,30 @@ void ApiWrap::filePartRefreshReference(int offset) {
 				origin.peer.c_inputPeerChannelFromMessage().vpeer(),
 				origin.peer.c_inputPeerChannelFromMessage().vmsg_id(),
 				origin.peer.c_inputPeerChannelFromMessage().vchannel_id());
-		_fileProcess->requestId = mainRequest(MTPchannels_GetMessages(
+		process->referenceRequestId = mainRequest(MTPchannels_GetMessages(
 			channel,
 			MTP_vector<MTPInputMessage>(
 				1,
 				MTP_inputMessageID(MTP_int(origin.messageId)))
-		)).fail([=](const MTP::Error &error) {
-			_fileProcess->requestId = 0;
-			filePartUnavailable();
-			return true;
-		}).done([=](const MTPmessages_Messages &result) {
-			_fileProcess->requestId = 0;
-			filePartExtractReference(offset, result);
-		}).send();
+		)).fail(fail).done(done).send();
 	} else {
-		_fileProcess->requestId = splitRequest(
+		process->referenceRequestId = splitRequest(
 			origin.split,
 			MTPmessages_GetMessages(
 				MTP_vector<MTPInputMessage>(
 					1,
 					MTP_inputMessageID(MTP_int(origin.messageId)))
 			)
-		).fail([=](const MTP::Error &error) {
-			_fileProcess->requestId = 0;
-			filePartUnavailable();
-			return true;
-		}).done([=](const MTPmessages_Messages &result) {
-			_fileProcess->requestId = 0;
-			filePartExtractReference(offset, result);
-		}).send();
+		).fail(fail).done(done).send();
 	}
 }
 
 void ApiWrap::filePartExtractReference(
-		int offset,
+		uint64 randomId,
 		const MTPmessages_Messages &result) {
-	Expects(_fileProcess != nullptr);
-	Expects(_fileProcess->requestId == 0);
+	const auto process = fileProcess(randomId);
+	Assert(process != nullptr);
+	Assert(process->referenceRequestId == 0);
 
 	result.match([&](const MTPDmessages_messagesNotModified &data) {
 		error("Unexpected messagesNotModified received.");
@@ -1914,38 +2247,36 @@ void ApiWrap::filePartExtractReference(
 			data.vmessages(),
 			data.vusers(),
 			data.vchats(),
-			_chatProcess->info.relativePath);
+			QString());
 		for (const auto &message : messages.list) {
-			if (message.id == _fileProcess->origin.messageId) {
+			if (message.id == process->origin.messageId) {
 				const auto refresh1 = Data::RefreshFileReference(
-					_fileProcess->location,
+					process->location,
 					message.file().location);
 				const auto refresh2 = Data::RefreshFileReference(
-					_fileProcess->location,
+					process->location,
 					message.thumb().file.location);
 				if (refresh1 || refresh2) {
-					_fileProcess->requestId = fileRequest(
-						_fileProcess->location,
-						offset
-					).done([=](const MTPupload_File &result) {
-						_fileProcess->requestId = 0;
-						filePartDone(offset, result);
-					}).send();
+					const auto offsets = base::take(
+						process->referenceOffsets);
+					for (const auto offset : offsets) {
+						sendFilePart(process, offset);
+					}
+					loadFilePart(randomId);
 					return;
 				}
 			}
 		}
-		filePartUnavailable();
+		filePartUnavailable(randomId);
 	});
 }
 
-void ApiWrap::filePartUnavailable() {
-	Expects(_fileProcess != nullptr);
-	Expects(!_fileProcess->requests.empty());
+void ApiWrap::filePartUnavailable(uint64 randomId) {
+	Expects(fileProcess(randomId) != nullptr);
 
 	LOG(("Export Error: File unavailable."));
 
-	base::take(_fileProcess)->done(QString());
+	takeFileProcess(randomId)->done(QString());
 }
 
 void ApiWrap::error(const MTP::Error &error) {
@@ -33,6 +33,7 @@ class Stats;
 } // namespace Output
 
 struct Settings;
+struct Checkpoint;
 
 class ApiWrap {
 public:
@@ -48,6 +49,7 @@ public:
 	void startExport(
 		const Settings &settings,
 		Output::Stats *stats,
+		Checkpoint *checkpoint,
 		FnMut<void(StartInfo)> done);
 
 	void requestDialogsList(
@@ -77,6 +79,7 @@ public:
 
 	void requestSessions(FnMut<void(Data::SessionsList&&)> done);
 
+	// Can be called for several chats without waiting for the 'done'.
 	void requestMessages(
 		const Data::DialogInfo &info,
 		FnMut<bool(const Data::DialogInfo &)> start,
@@ -110,6 +113,7 @@ private:
 	void requestDialogsCount();
 	void requestLeftChannelsCount();
 	void finishStartProcess();
+	void restoreExportedFiles();
 
 	void requestTopPeersSlice();
 
@@ -146,27 +150,53 @@ private:
 		std::vector<Data::DialogInfo> &&from,
 		int splitIndex);
 
-	void requestMessagesCount(int localSplitIndex);
-	void checkFirstMessageDate(int localSplitIndex, int count);
-	void messagesCountLoaded(int localSplitIndex, int count);
-	void requestMessagesSlice();
+	void requestMessagesCount(
+		not_null<ChatProcess*> process,
+		int localSplitIndex);
+	void checkFirstMessageDate(
+		not_null<ChatProcess*> process,
+		int localSplitIndex,
+		int count);
+	void messagesCountLoaded(
+		not_null<ChatProcess*> process,
+		int localSplitIndex,
+		int count);
+	[[nodiscard]] int32 messagesOffsetId(
+		not_null<ChatProcess*> process,
+		int localSplitIndex) const;
+	void requestMessagesSlice(not_null<ChatProcess*> process);
 	void requestChatMessages(
+		not_null<ChatProcess*> process,
 		int splitIndex,
 		int offsetId,
 		int addOffset,
 		int limit,
+		int minId,
 		FnMut<void(MTPmessages_Messages&&)> done);
-	void loadMessagesFiles(Data::MessagesSlice &&slice);
-	void loadNextMessageFile();
-	bool loadMessageFileProgress(FileProgress value);
-	void loadMessageFileDone(const QString &relativePath);
-	bool loadMessageThumbProgress(FileProgress value);
-	void loadMessageThumbDone(const QString &relativePath);
-	void finishMessagesSlice();
-	void finishMessages();
-
-	[[nodiscard]] Data::Message *currentFileMessage() const;
-	[[nodiscard]] Data::FileOrigin currentFileMessageOrigin() const;
+	void loadMessagesFiles(
+		not_null<ChatProcess*> process,
+		Data::MessagesSlice &&slice);
+	void loadNextMessageFile(not_null<ChatProcess*> process);
+	[[nodiscard]] bool startMessageFile(
+		not_null<ChatProcess*> process,
+		int index,
+		bool thumb);
+	bool loadMessageFileProgress(
+		not_null<ChatProcess*> process,
+		int index,
+		FileProgress value);
+	void loadMessageFileDone(
+		not_null<ChatProcess*> process,
+		int index,
+		bool thumb,
+		const QString &relativePath);
+	void finishMessagesSlice(not_null<ChatProcess*> process);
+	void finishMessages(not_null<ChatProcess*> process);
+	void resumeMessagesFiles();
+
+	[[nodiscard]] Data::FileOrigin fileMessageOrigin(
+		not_null<ChatProcess*> process,
+		int index) const;
 
 	bool processFileLoad(
 		Data::File &file,
@@ -180,17 +210,39 @@ private:
 	bool writePreloadedFile(
 		Data::File &file,
 		const Data::FileOrigin &origin);
+	[[nodiscard]] std::optional<QString> findExportedFile(
+		const Data::File &file);
+	[[nodiscard]] QString linkExportedFile(
+		const QString &existing,
+		const QString &relativePath) const;
+	[[nodiscard]] QString deduplicateFile(
+		const QString &relativePath,
+		int64 size,
+		const QByteArray &hash);
+	void fileSaved(
+		const Data::FileLocation &location,
+		const QString &relativePath,
+		int64 size,
+		const QByteArray &hash);
+	[[nodiscard]] bool fileLoadAllowed(
+		const Data::FileLocation &location) const;
 	void loadFile(
 		const Data::File &file,
 		const Data::FileOrigin &origin,
 		Fn<bool(FileProgress)> progress,
 		FnMut<void(QString)> done);
-	void loadFilePart();
-	void filePartDone(int offset, const MTPupload_File &result);
-	void filePartUnavailable();
-	void filePartRefreshReference(int offset);
-	void filePartExtractReference(
+	[[nodiscard]] FileProcess *fileProcess(uint64 randomId) const;
+	std::unique_ptr<FileProcess> takeFileProcess(uint64 randomId);
+	void loadFilePart(uint64 randomId);
+	void sendFilePart(not_null<FileProcess*> process, int offset);
+	void filePartDone(
+		uint64 randomId,
 		int offset,
+		const MTPupload_File &result);
+	void filePartUnavailable(uint64 randomId);
+	void filePartRefreshReference(uint64 randomId, int offset);
+	void filePartExtractReference(
+		uint64 randomId,
 		const MTPmessages_Messages &result);
 
 	template <typename Request>
@@ -203,7 +255,7 @@ private:
 	[[nodiscard]] auto splitRequest(int index, Request &&request);
 
 	[[nodiscard]] auto fileRequest(
-		const Data::FileLocation &location,
+		not_null<FileProcess*> process,
 		int offset);
 
 	void error(const MTP::Error &error);
@@ -214,6 +266,7 @@ private:
 	std::optional<uint64> _takeoutId;
 	std::optional<UserId> _selfId;
 	Output::Stats *_stats = nullptr;
+	Checkpoint *_checkpoint = nullptr;
 
 	std::unique_ptr<Settings> _settings;
 	MTPInputUser _user = MTP_inputUserSelf();
@@ -223,10 +276,11 @@ private:
 	std::unique_ptr<ContactsProcess> _contactsProcess;
 	std::unique_ptr<UserpicsProcess> _userpicsProcess;
 	std::unique_ptr<OtherDataProcess> _otherDataProcess;
-	std::unique_ptr<FileProcess> _fileProcess;
+	base::flat_map<uint64, std::unique_ptr<FileProcess>> _fileProcesses;
+	base::flat_map<int, int> _fileLoadsPerDc;
 	std::unique_ptr<LeftChannelsProcess> _leftChannelsProcess;
 	std::unique_ptr<DialogsProcess> _dialogsProcess;
-	std::unique_ptr<ChatProcess> _chatProcess;
+	base::flat_map<PeerId, std::unique_ptr<ChatProcess>> _chatProcesses;
 	QVector<MTPMessageRange> _splits;
 
 	rpl::event_stream<MTP::Error> _errors;
@@ -0,0 +1,179 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "export/export_checkpoint.h"
+
+#include "export/output/export_output_result.h"
+#include "base/unixtime.h"
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
+#include <QtCore/QSaveFile>
+
+namespace Export {
+namespace {
+
+constexpr auto kVersion = 1;
+constexpr auto kFileName = "export_checkpoint.json";
+
+[[nodiscard]] QJsonArray SerializeChats(
+		const base::flat_map<PeerId, Checkpoint::Chat> &chats) {
+	auto result = QJsonArray();
+	for (const auto &[peer, chat] : chats) {
+		result.append(QJsonObject{
+			{ "peer", QString::number(peer.value) },
+			{ "last", chat.lastMessageId },
+			{ "last_migrated", chat.lastMigratedMessageId },
+		});
+	}
+	return result;
+}
+
+[[nodiscard]] base::flat_map<PeerId, Checkpoint::Chat> ParseChats(
+		const QJsonArray &list) {
+	auto result = base::flat_map<PeerId, Checkpoint::Chat>();
+	for (const auto &value : list) {
+		const auto object = value.toObject();
+		const auto peer = PeerId(
+			object.value("peer").toString().toULongLong());
+		if (!peer) {
+			continue;
+		}
+		result.emplace(peer, Checkpoint::Chat{
+			.lastMessageId = object.value("last").toInt(),
+			.lastMigratedMessageId = object.value("last_migrated").toInt(),
+		});
+	}
+	return result;
+}
+
+} // namespace
+
+void Checkpoint::messageExported(PeerId peer, bool migrated, int32 id) {
+	auto &chat = chats[peer];
+	auto &last = migrated ? chat.lastMigratedMessageId : chat.lastMessageId;
+	last = std::max(last, id);
+}
+
+void Checkpoint::fileExported(
+		FileKey key,
+		const QString &relativePath,
+		int64 size,
+		const QByteArray &hash) {
+	files[key] = File{ relativePath, size, hash };
+}
+
+Checkpoint::Chat Checkpoint::since(PeerId peer) const {
+	const auto i = sinceChats.find(peer);
+	return (i != end(sinceChats)) ? i->second : Chat();
+}
+
+QByteArray Checkpoint::serialize() const {
+	auto list = QJsonArray();
+	for (const auto &[key, file] : files) {
+		list.append(QJsonObject{
+			{ "type", QString::number(key.first) },
+			{ "id", QString::number(key.second) },
+			{ "path", file.relativePath },
+			{ "size", QString::number(file.size) },
+			{ "hash", QString::fromLatin1(file.hash.toHex()) },
+		});
+	}
+	return QJsonDocument(QJsonObject{
+		{ "version", kVersion },
+		{ "format", format },
+		{ "types", QString::number(types) },
+		{ "finished", finished },
+		{ "date", QString::number(date) },
+		{ "since", SerializeChats(sinceChats) },
+		{ "chats", SerializeChats(chats) },
+		{ "files", list },
+	}).toJson(QJsonDocument::Compact);
+}
+
+std::optional<Checkpoint> Checkpoint::Parse(const QByteArray &data) {
+	auto error = QJsonParseError();
+	const auto document = QJsonDocument::fromJson(data, &error);
+	if (error.error != QJsonParseError::NoError || !document.isObject()) {
+		return std::nullopt;
+	}
+	const auto object = document.object();
+	if (object.value("version").toInt() != kVersion) {
+		return std::nullopt;
+	}
+	auto result = Checkpoint();
+	result.format = object.value("format").toInt();
+	result.types = object.value("types").toString().toUInt();
+	result.finished = object.value("finished").toBool();
+	result.date = TimeId(object.value("date").toString().toLongLong());
+	result.sinceChats = ParseChats(object.value("since").toArray());
+	result.chats = ParseChats(object.value("chats").toArray());
+	for (const auto &value : object.value("files").toArray()) {
+		const auto file = value.toObject();
+		const auto path = file.value("path").toString();
+		if (path.isEmpty()) {
+			continue;
+		}
+		const auto key = FileKey{
+			file.value("type").toString().toULongLong(),
+			file.value("id").toString().toULongLong(),
+		};
+		result.files.emplace(key, File{
+			path,
+			file.value("size").toString().toLongLong(),
+			QByteArray::fromHex(file.value("hash").toString().toLatin1()),
+		});
+	}
+	return result;
+}
+
+Output::Result Checkpoint::write(const QString &folder) {
+	date = base::unixtime::now();
+
+	const auto path = folder + kFileName;
+	auto file = QSaveFile(path);
+	if (!file.open(QIODevice::WriteOnly)) {
+		return Output::Result(Output::Result::Type::Error, path);
+	}
+	const auto data = serialize();
+	if (file.write(data) != data.size() || !file.commit()) {
+		return Output::Result(Output::Result::Type::Error, path);
+	}
+	return Output::Result::Success();
+}
+
+std::optional<Checkpoint> Checkpoint::Read(const QString &folder) {
+	auto file = QFile(folder + kFileName);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return std::nullopt;
+	}
+	return Parse(file.readAll());
+}
+
+QString Checkpoint::FindLatest(const QString &folder, bool finished) {
+	const auto normalized = folder.endsWith('/') ? folder : (folder + '/');
+	auto result = QString();
+	auto date = TimeId(0);
+	const auto check = [&](const QString &path) {
+		const auto checkpoint = Read(path);
+		if (checkpoint
+			&& checkpoint->finished == finished
+			&& (result.isEmpty() || date < checkpoint->date)) {
+			result = path;
+			date = checkpoint->date;
+		}
+	};
+	check(normalized);
+	const auto mode = QDir::Dirs | QDir::NoDotAndDotDot;
+	for (const auto &entry : QDir(normalized).entryInfoList(mode)) {
+		check(entry.absoluteFilePath() + '/');
+	}
+	return result;
+}
+
+} // namespace Export
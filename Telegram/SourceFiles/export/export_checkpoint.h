@@ -0,0 +1,77 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "data/data_peer_id.h"
+#include "base/flat_map.h"
+
+namespace Export {
+namespace Output {
+struct Result;
+} // namespace Output
+
+// Progress of the export, saved next to the exported data.
+//
+// An interrupted export is resumed to the same folder reusing the files
+// that were already downloaded, a finished one provides the last exported
+// message id of each chat, so that the next incremental export requests
+// only the messages that were sent after it.
+struct Checkpoint {
+	struct Chat {
+		int32 lastMessageId = 0;
+		int32 lastMigratedMessageId = 0;
+	};
+	struct File {
+		QString relativePath;
+		int64 size = 0;
+		QByteArray hash; // SHA-256 of the content, empty if unknown.
+	};
+
+	// Data::FileLocation type and id, see ComputeLocationKey.
+	using FileKey = std::pair<uint64, uint64>;
+
+	void messageExported(PeerId peer, bool migrated, int32 id);
+	void fileExported(
+		FileKey key,
+		const QString &relativePath,
+		int64 size,
+		const QByteArray &hash);
+
+	[[nodiscard]] Chat since(PeerId peer) const;
+
+	[[nodiscard]] QByteArray serialize() const;
+	[[nodiscard]] static std::optional<Checkpoint> Parse(
+		const QByteArray &data);
+
+	[[nodiscard]] Output::Result write(const QString &folder);
+	[[nodiscard]] static std::optional<Checkpoint> Read(
+		const QString &folder);
+
+	// Returns the folder with the latest finished or unfinished checkpoint,
+	// looking in the folder itself and in its direct subfolders.
+	[[nodiscard]] static QString FindLatest(
+		const QString &folder,
+		bool finished);
+
+	int format = 0;
+	uint32 types = 0;
+	bool finished = false;
+	TimeId date = 0;
+
+	// Lower bounds of the incremental export, empty for the full one.
+	base::flat_map<PeerId, Chat> sinceChats;
+
+	base::flat_map<PeerId, Chat> chats;
+
+	// Paths are relative to the export folder, files of the previous
+	// exports that are reused by the incremental one start with "../".
+	base::flat_map<FileKey, File> files;
+
+};
+
+} // namespace Export
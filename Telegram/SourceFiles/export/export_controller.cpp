@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "export/export_api_wrap.h"
 #include "export/export_settings.h"
+#include "export/export_checkpoint.h"
 #include "export/data/export_data_types.h"
 #include "export/output/export_output_abstract.h"
 #include "export/output/export_output_result.h"
@@ -18,6 +19,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace Export {
 namespace {
 
+constexpr auto kCheckpointSaveDelay = crl::time(5000);
+constexpr auto kDialogsInParallel = 4;
+
 const auto kNullStateCallback = [](ProcessingState&) {};
 
 Settings NormalizeSettings(const Settings &settings) {
@@ -29,6 +33,15 @@ Settings NormalizeSettings(const Settings &settings) {
 	return result;
 }
 
+ProcessingState::EntityType ComputeEntityType(const Data::DialogInfo &info) {
+	using Type = Data::DialogInfo::Type;
+	return (info.type == Type::Self)
+		? ProcessingState::EntityType::SavedMessages
+		: (info.type == Type::Replies)
+		? ProcessingState::EntityType::RepliesMessages
+		: ProcessingState::EntityType::Chat;
+}
+
 } // namespace
 
 class ControllerObject {
@@ -57,6 +70,16 @@ public:
 private:
 	using Step = ProcessingState::Step;
 	using DownloadProgress = ApiWrap::DownloadProgress;
+	struct DialogExport {
+		int index = 0;
+
+		// Null for the chat that is written by the main writer.
+		std::unique_ptr<Output::AbstractWriter> writer;
+
+		int messagesWritten = 0;
+		int messagesCount = 0;
+		bool finished = false;
+	};
 
 	[[nodiscard]] bool stopped() const;
 	void setState(State &&state);
@@ -64,6 +87,10 @@ private:
 	bool ioCatchError(Output::Result result);
 	void setFinishedState();
 
+	void prepareCheckpoint(const QString &folder);
+	Output::Result saveCheckpoint(bool force);
+	void skipUnchangedDialogs();
+
 	//void requestPasswordState();
 	//void passwordStateDone(const MTPaccount_Password &password);
 
@@ -79,7 +106,13 @@ private:
 	void exportSessions();
 	void exportOtherData();
 	void exportDialogs();
-	void exportNextDialog();
+	void exportNextDialogs();
+	void exportDialog(int index);
+	bool writeFinishedDialogs();
+	[[nodiscard]] DialogExport &dialogExport(int index);
+	[[nodiscard]] const DialogExport &dialogExport(int index) const;
+	[[nodiscard]] not_null<Output::AbstractWriter*> dialogWriter(
+		const DialogExport &dialog) const;
 
 	template <typename Callback = const decltype(kNullStateCallback) &>
 	ProcessingState prepareState(
@@ -92,7 +125,9 @@ private:
 	ProcessingState stateContacts() const;
 	ProcessingState stateSessions() const;
 	ProcessingState stateOtherData() const;
-	ProcessingState stateDialogs(const DownloadProgress &progress) const;
+	ProcessingState stateDialogs(
+		int index,
+		const DownloadProgress &progress) const;
 	void fillMessagesState(
 		ProcessingState &result,
 		const Data::DialogsInfo &info,
@@ -108,8 +143,9 @@ private:
 	Data::DialogsInfo _dialogsInfo;
 	int _dialogIndex = -1;
 
-	int _messagesWritten = 0;
-	int _messagesCount = 0;
+	// Chats are requested in parallel, but added to the main writer
+	// in the order of the chats list.
+	std::deque<DialogExport> _dialogs;
 
 	int _userpicsWritten = 0;
 	int _userpicsCount = 0;
@@ -125,6 +161,9 @@ private:
 	mutable int _substepsPassed = 0;
 	mutable Step _lastProcessingStep = Step::Initializing;
 
+	std::optional<Checkpoint> _checkpoint;
+	crl::time _checkpointSaved = 0;
+
 	std::unique_ptr<Output::AbstractWriter> _writer;
 	std::vector<Step> _steps;
 	int _stepIndex = -1;
@@ -249,6 +288,7 @@ void ControllerObject::startExport(
 	_environment = environment;
 
 	_settings.path = Output::NormalizePath(_settings);
+	prepareCheckpoint(settings.path);
 	_writer = Output::CreateWriter(_settings.format);
 	fillExportSteps();
 	exportNext();
@@ -324,14 +364,81 @@ void ControllerObject::fillSubstepsInSteps(const ApiWrap::StartInfo &info) {
 
 void ControllerObject::cancelExportFast() {
 	_api.cancelExportFast();
+	saveCheckpoint(true);
 	setState(CancelledState());
 }
 
+void ControllerObject::prepareCheckpoint(const QString &folder) {
+	if (_settings.onlySinglePeer()) {
+		return;
+	}
+	if (auto existing = Checkpoint::Read(_settings.path)) {
+		// Output::NormalizePath returns the folder with a checkpoint only
+		// if it is an unfinished export with the same settings.
+		_checkpoint = std::move(existing);
+		return;
+	}
+	_checkpoint.emplace();
+	_checkpoint->format = int(_settings.format);
+	_checkpoint->types = uint32(_settings.types);
+	if (!_settings.incremental) {
+		return;
+	}
+	const auto found = Checkpoint::FindLatest(folder, true);
+	if (found.isEmpty()) {
+		return;
+	} else if (const auto previous = Checkpoint::Read(found)) {
+		_checkpoint->sinceChats = previous->chats;
+		_checkpoint->chats = previous->chats;
+
+		// Files of the previous exports are reused instead of loading
+		// the same media again, they are referenced relative to this one.
+		const auto current = QDir(_settings.path);
+		for (const auto &[key, file] : previous->files) {
+			auto &reused = _checkpoint->files[key];
+			reused = file;
+			reused.relativePath = current.relativeFilePath(
+				QDir::cleanPath(found + file.relativePath));
+		}
+	}
+}
+
+Output::Result ControllerObject::saveCheckpoint(bool force) {
+	if (!_checkpoint || !_writer) {
+		return Output::Result::Success();
+	}
+	const auto now = crl::now();
+	if (!force && now < _checkpointSaved + kCheckpointSaveDelay) {
+		return Output::Result::Success();
+	}
+	_checkpointSaved = now;
+	return _checkpoint->write(_settings.path);
+}
+
+void ControllerObject::skipUnchangedDialogs() {
+	if (!_checkpoint || _checkpoint->sinceChats.empty()) {
+		return;
+	}
+	const auto unchanged = [&](const Data::DialogInfo &info) {
+		const auto since = _checkpoint->since(info.peerId);
+		return (info.topMessageId > 0)
+			&& (info.topMessageId <= since.lastMessageId);
+	};
+	auto &chats = _dialogsInfo.chats;
+	chats.erase(ranges::remove_if(chats, unchanged), end(chats));
+}
+
 void ControllerObject::exportNext() {
 	if (++_stepIndex >= _steps.size()) {
 		if (ioCatchError(_writer->finish())) {
 			return;
 		}
+		if (_checkpoint) {
+			_checkpoint->finished = true;
+			if (ioCatchError(saveCheckpoint(true))) {
+				return;
+			}
+		}
 		_api.finishExport([=] {
 			setFinishedState();
 		});
@@ -354,13 +461,16 @@ void ControllerObject::exportNext() {
 
 void ControllerObject::initialize() {
 	setState(stateInitializing());
-	_api.startExport(_settings, &_stats, [=](ApiWrap::StartInfo info) {
+	const auto checkpoint = _checkpoint ? &*_checkpoint : nullptr;
+	const auto done = [=](ApiWrap::StartInfo info) {
 		initialized(info);
-	});
+	};
+	_api.startExport(_settings, &_stats, checkpoint, done);
 }
 
 void ControllerObject::initialized(const ApiWrap::StartInfo &info) {
-	if (ioCatchError(_writer->start(_settings, _environment, &_stats))) {
+	if (ioCatchError(_writer->start(_settings, _environment, &_stats))
+		|| ioCatchError(saveCheckpoint(true))) {
 		return;
 	}
 	fillSubstepsInSteps(info);
@@ -376,6 +486,7 @@ void ControllerObject::collectDialogsList() {
 		return true;
 	}, [=](Data::DialogsInfo &&result) {
 		_dialogsInfo = std::move(result);
+		skipUnchangedDialogs();
 		exportNext();
 	});
 }
@@ -452,39 +563,20 @@ void ControllerObject::exportDialogs() {
 		return;
 	}
 
-	exportNextDialog();
+	exportNextDialogs();
 }
 
-void ControllerObject::exportNextDialog() {
-	const auto index = ++_dialogIndex;
-	const auto info = _dialogsInfo.item(index);
-	if (info) {
-		_api.requestMessages(*info, [=](const Data::DialogInfo &info) {
-			if (ioCatchError(_writer->writeDialogStart(info))) {
-				return false;
-			}
-			_messagesWritten = 0;
-			_messagesCount = ranges::accumulate(
-				info.messagesCountPerSplit,
-				0);
-			setState(stateDialogs(DownloadProgress()));
-			return true;
-		}, [=](DownloadProgress progress) {
-			setState(stateDialogs(progress));
-			return true;
-		}, [=](Data::MessagesSlice &&result) {
-			if (ioCatchError(_writer->writeDialogSlice(result))) {
-				return false;
-			}
-			_messagesWritten += result.list.size();
-			setState(stateDialogs(DownloadProgress()));
-			return true;
-		}, [=] {
-			if (ioCatchError(_writer->writeDialogEnd())) {
-				return;
-			}
-			exportNextDialog();
-		});
+void ControllerObject::exportNextDialogs() {
+	// Finished chats waiting to be written after the first one
+	// don't occupy the parallel export slots.
+	const auto limit = _settings.onlySinglePeer() ? 1 : kDialogsInParallel;
+	const auto exporting = [&] {
+		return ranges::count(_dialogs, false, &DialogExport::finished);
+	};
+	while (exporting() < limit && _dialogsInfo.item(_dialogIndex + 1)) {
+		exportDialog(++_dialogIndex);
+	}
+	if (!_dialogs.empty()) {
 		return;
 	}
 	if (ioCatchError(_writer->writeDialogsEnd())) {
@@ -493,6 +585,80 @@ void ControllerObject::exportNextDialog() {
 	exportNext();
 }
 
+void ControllerObject::exportDialog(int index) {
+	const auto info = _dialogsInfo.item(index);
+	Assert(info != nullptr);
+
+	// Only the first chat in the list is written by the main writer,
+	// the others have their own ones until they're added to it.
+	_dialogs.push_back({ .index = index });
+	if (_dialogs.size() > 1) {
+		_dialogs.back().writer = _writer->createDialogWriter();
+	}
+
+	_api.requestMessages(*info, [=](const Data::DialogInfo &info) {
+		auto &dialog = dialogExport(index);
+		if (ioCatchError(dialogWriter(dialog)->writeDialogStart(info))) {
+			return false;
+		}
+		dialog.messagesCount = ranges::accumulate(
+			info.messagesCountPerSplit,
+			0);
+		setState(stateDialogs(index, DownloadProgress()));
+		return true;
+	}, [=](DownloadProgress progress) {
+		setState(stateDialogs(index, progress));
+		return true;
+	}, [=](Data::MessagesSlice &&result) {
+		auto &dialog = dialogExport(index);
+		if (ioCatchError(dialogWriter(dialog)->writeDialogSlice(result))
+			|| ioCatchError(saveCheckpoint(false))) {
+			return false;
+		}
+		dialog.messagesWritten += result.list.size();
+		setState(stateDialogs(index, DownloadProgress()));
+		return true;
+	}, [=] {
+		auto &dialog = dialogExport(index);
+		if (ioCatchError(dialogWriter(dialog)->writeDialogEnd())) {
+			return;
+		}
+		dialog.finished = true;
+		if (writeFinishedDialogs()) {
+			exportNextDialogs();
+		}
+	});
+}
+
+bool ControllerObject::writeFinishedDialogs() {
+	while (!_dialogs.empty() && _dialogs.front().finished) {
+		const auto &dialog = _dialogs.front();
+		if (dialog.writer
+			&& ioCatchError(_writer->writeDialogPart(dialog.writer.get()))) {
+			return false;
+		}
+		_dialogs.pop_front();
+	}
+	return true;
+}
+
+auto ControllerObject::dialogExport(int index) -> DialogExport& {
+	const auto i = ranges::find(_dialogs, index, &DialogExport::index);
+	Assert(i != end(_dialogs));
+	return *i;
+}
+
+auto ControllerObject::dialogExport(int index) const -> const DialogExport& {
+	const auto i = ranges::find(_dialogs, index, &DialogExport::index);
+	Assert(i != end(_dialogs));
+	return *i;
+}
+
+not_null<Output::AbstractWriter*> ControllerObject::dialogWriter(
+		const DialogExport &dialog) const {
+	return dialog.writer ? dialog.writer.get() : _writer.get();
+}
+
 template <typename Callback>
 ProcessingState ControllerObject::prepareState(
 		Step step,
@@ -557,13 +723,14 @@ ProcessingState ControllerObject::stateOtherData() const {
 }
 
 ProcessingState ControllerObject::stateDialogs(
+		int index,
 		const DownloadProgress &progress) const {
 	const auto step = Step::Dialogs;
 	return prepareState(step, [&](ProcessingState &result) {
 		fillMessagesState(
 			result,
 			_dialogsInfo,
-			_dialogIndex,
+			index,
 			progress);
 	});
 }
@@ -576,16 +743,28 @@ void ControllerObject::fillMessagesState(
 	const auto dialog = info.item(index);
 	Assert(dialog != nullptr);
 
+	const auto &exported = dialogExport(index);
 	result.entityIndex = index;
 	result.entityCount = info.chats.size() + info.left.size();
 	result.entityName = dialog->name;
-	result.entityType = (dialog->type == Data::DialogInfo::Type::Self)
-		? ProcessingState::EntityType::SavedMessages
-		: (dialog->type == Data::DialogInfo::Type::Replies)
-		? ProcessingState::EntityType::RepliesMessages
-		: ProcessingState::EntityType::Chat;
-	result.itemIndex = _messagesWritten + progress.itemIndex;
-	result.itemCount = std::max(_messagesCount, result.itemIndex);
+	result.entityType = ComputeEntityType(*dialog);
+	result.itemIndex = exported.messagesWritten + progress.itemIndex;
+	result.itemCount = std::max(exported.messagesCount, result.itemIndex);
+	for (const auto &other : _dialogs) {
+		if (other.index == index || other.finished) {
+			continue;
+		}
+		const auto otherDialog = info.item(other.index);
+		Assert(otherDialog != nullptr);
+
+		result.otherEntities.push_back({
+			.type = ComputeEntityType(*otherDialog),
+			.name = otherDialog->name,
+			.index = other.index,
+			.itemIndex = other.messagesWritten,
+			.itemCount = other.messagesCount,
+		});
+	}
 	result.bytesType = ProcessingState::FileType::File; // TODO
 	result.bytesRandomId = progress.randomId;
 	if (!progress.path.isEmpty()) {
@@ -74,6 +74,16 @@ struct ProcessingState {
 	int itemIndex = 0;
 	int itemCount = 0;
 
+	// Other chats that are exported at the same time.
+	struct Entity {
+		EntityType type = EntityType::Other;
+		QString name;
+		int index = 0;
+		int itemIndex = 0;
+		int itemCount = 0;
+	};
+	std::vector<Entity> otherEntities;
+
 	uint64 bytesRandomId = 0;
 	FileType bytesType = FileType::None;
 	QString bytesName;
@@ -37,7 +37,9 @@ bool Settings::validate() const {
 		return false;
 	} else if ((fullChats & MustNotBeFull) != 0) {
 		return false;
-	} else if (format != Format::Html && format != Format::Json) {
+	} else if (format != Format::Html
+		&& format != Format::Json
+		&& format != Format::Ndjson) {
 		return false;
 	} else if (!media.validate()) {
 		return false;
@@ -73,6 +73,9 @@ struct Settings {
 	bool forceSubPath = false;
 	Output::Format format = Output::Format();
 
+	// Gzip the JSON output files, HTML pages are never compressed.
+	bool compress = false;
+
 	Types types = DefaultTypes();
 	Types fullChats = DefaultFullChats();
 	MediaSettings media;
@@ -81,6 +84,10 @@ struct Settings {
 	TimeId singlePeerFrom = 0;
 	TimeId singlePeerTill = 0;
 
+	// Export only the messages sent after the last finished export
+	// to the same folder, see Export::Checkpoint.
+	bool incremental = false;
+
 	TimeId availableAt = 0;
 
 	bool onlySinglePeer() const {
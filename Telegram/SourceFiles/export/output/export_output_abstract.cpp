@@ -11,12 +11,33 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "export/output/export_output_json.h"
 #include "export/output/export_output_stats.h"
 #include "export/output/export_output_result.h"
+#include "export/export_checkpoint.h"
 
 #include <QtCore/QDir>
 #include <QtCore/QDate>
 
 namespace Export {
 namespace Output {
+namespace {
+
+[[nodiscard]] QString UnfinishedExportPath(
+		const Settings &settings,
+		const QString &folder) {
+	if (settings.onlySinglePeer()) {
+		return QString();
+	}
+	const auto found = Checkpoint::FindLatest(folder, false);
+	const auto checkpoint = found.isEmpty()
+		? std::nullopt
+		: Checkpoint::Read(found);
+	return (checkpoint
+		&& checkpoint->format == int(settings.format)
+		&& checkpoint->types == uint32(settings.types))
+		? found
+		: QString();
+}
+
+} // namespace
 
 QString NormalizePath(const Settings &settings) {
 	QDir folder(settings.path);
@@ -25,6 +46,10 @@ QString NormalizePath(const Settings &settings) {
 	if (!folder.exists() && !settings.forceSubPath) {
 		return result;
 	}
+	const auto resume = UnfinishedExportPath(settings, result);
+	if (!resume.isEmpty()) {
+		return resume;
+	}
 	const auto mode = QDir::AllEntries | QDir::NoDotAndDotDot;
 	const auto list = folder.entryInfoList(mode);
 	if (list.isEmpty() && !settings.forceSubPath) {
@@ -49,7 +74,8 @@ QString NormalizePath(const Settings &settings) {
 std::unique_ptr<AbstractWriter> CreateWriter(Format format) {
 	switch (format) {
 	case Format::Html: return std::make_unique<HtmlWriter>();
-	case Format::Json: return std::make_unique<JsonWriter>();
+	case Format::Json: return std::make_unique<JsonWriter>(Format::Json);
+	case Format::Ndjson: return std::make_unique<JsonWriter>(Format::Ndjson);
 	}
 	Unexpected("Format in Export::Output::CreateWriter.");
 }
@@ -35,6 +35,7 @@ class Stats;
 enum class Format {
 	Html,
 	Json,
+	Ndjson,
 };
 
 class AbstractWriter {
@@ -73,6 +74,13 @@ public:
 	[[nodiscard]] virtual Result writeDialogEnd() = 0;
 	[[nodiscard]] virtual Result writeDialogsEnd() = 0;
 
+	// A chat can be written by a separate writer while this one writes
+	// the other chats, its entry is added later by writeDialogPart().
+	[[nodiscard]] virtual std::unique_ptr<AbstractWriter>
+		createDialogWriter() = 0;
+	[[nodiscard]] virtual Result writeDialogPart(
+		not_null<AbstractWriter*> writer) = 0;
+
 	[[nodiscard]] virtual Result finish() = 0;
 
 	[[nodiscard]] virtual QString mainFilePath() = 0;
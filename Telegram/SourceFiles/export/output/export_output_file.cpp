@@ -16,12 +16,61 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <gsl/gsl_util>
 
+#include <zlib.h>
+#include <filesystem>
+
 namespace Export {
 namespace Output {
+namespace {
+
+constexpr auto kCompressChunk = 256 * 1024;
+
+} // namespace
+
+struct File::Compressor {
+	Compressor();
+	~Compressor();
+
+	z_stream stream = z_stream();
+	bool valid = false;
+	bool finished = false;
 
-File::File(const QString &path, Stats *stats) : _path(path), _stats(stats) {
+	// Output of a block that was already consumed by deflate,
+	// but wasn't written because of an error.
+	QByteArray pending;
+	QByteArray pendingInput;
+	bool pendingFinish = false;
+	bool hasPending = false;
+};
+
+File::Compressor::Compressor() {
+	constexpr auto kGzipWindowBits = 15 + 16;
+	constexpr auto kMemLevel = 8;
+	valid = (deflateInit2(
+		&stream,
+		Z_DEFAULT_COMPRESSION,
+		Z_DEFLATED,
+		kGzipWindowBits,
+		kMemLevel,
+		Z_DEFAULT_STRATEGY) == Z_OK);
 }
 
+File::Compressor::~Compressor() {
+	if (valid) {
+		deflateEnd(&stream);
+	}
+}
+
+File::File(const QString &path, Stats *stats, Compression compression)
+: _path(path)
+, _stats(stats)
+, _compressor((compression == Compression::Gzip)
+	? std::make_unique<Compressor>()
+	: nullptr) {
+}
+
+File::~File() = default;
+
 int File::size() const {
 	return _offset;
 }
@@ -31,6 +80,20 @@ bool File::empty() const {
 }
 
 Result File::writeBlock(const QByteArray &block) {
+	return _compressor
+		? writeCompressed(block, false)
+		: writeRaw(block);
+}
+
+Result File::close() {
+	const auto result = _compressor
+		? writeCompressed(QByteArray(), true)
+		: Result::Success();
+	_file.reset();
+	return result;
+}
+
+Result File::writeRaw(const QByteArray &block) {
 	const auto result = writeBlockAttempt(block);
 	if (!result) {
 		_file.reset();
@@ -38,6 +101,64 @@ Result File::writeBlock(const QByteArray &block) {
 	return result;
 }
 
+Result File::writeCompressed(const QByteArray &block, bool finish) {
+	Expects(_compressor != nullptr);
+
+	auto &compressor = *_compressor;
+	if (!compressor.valid) {
+		return fatalError();
+	} else if (compressor.hasPending) {
+		// Write the output of the failed block first. If the same block
+		// is written again, it is not fed to deflate for the second time.
+		const auto retry = (compressor.pendingFinish == finish)
+			&& (compressor.pendingInput == block);
+		if (const auto result = writeRaw(compressor.pending); !result) {
+			return result;
+		}
+		compressor.hasPending = false;
+		compressor.pending = QByteArray();
+		compressor.pendingInput = QByteArray();
+		if (retry) {
+			return Result::Success();
+		}
+	}
+	if (compressor.finished) {
+		// Nothing can be written to the gzip stream after its end.
+		Expects(finish);
+
+		return Result::Success();
+	}
+	auto &stream = compressor.stream;
+	stream.next_in = reinterpret_cast<Bytef*>(
+		const_cast<char*>(block.constData()));
+	stream.avail_in = block.size();
+
+	auto compressed = QByteArray();
+	do {
+		const auto offset = compressed.size();
+		compressed.resize(offset + kCompressChunk);
+		stream.next_out = reinterpret_cast<Bytef*>(
+			compressed.data() + offset);
+		stream.avail_out = kCompressChunk;
+		const auto code = deflate(&stream, finish ? Z_FINISH : Z_NO_FLUSH);
+		if (code == Z_STREAM_ERROR) {
+			return fatalError();
+		}
+		compressed.resize(offset + kCompressChunk - stream.avail_out);
+	} while (stream.avail_out == 0);
+	compressor.finished = finish;
+
+	// Empty blocks still create the file, like without compression.
+	const auto result = writeRaw(compressed);
+	if (!result) {
+		compressor.hasPending = true;
+		compressor.pending = std::move(compressed);
+		compressor.pendingInput = block;
+		compressor.pendingFinish = finish;
+	}
+	return result;
+}
+
 Result File::writeBlockAttempt(const QByteArray &block) {
 	if (_stats && !_inStats) {
 		_inStats = true;
@@ -136,5 +257,25 @@ Result File::Copy(
 	return File(path, stats).writeBlock(bytes);
 }
 
+bool File::Link(const QString &existing, const QString &path) {
+	const auto folder = QFileInfo(path).absoluteDir();
+	if (!folder.exists() && !folder.mkpath(folder.absolutePath())) {
+		return false;
+	}
+	auto error = std::error_code();
+#ifdef Q_OS_WIN
+	std::filesystem::create_hard_link(
+		existing.toStdWString(),
+		path.toStdWString(),
+		error);
+#else // Q_OS_WIN
+	std::filesystem::create_hard_link(
+		QFile::encodeName(existing).toStdString(),
+		QFile::encodeName(path).toStdString(),
+		error);
+#endif // Q_OS_WIN
+	return !error;
+}
+
 } // namespace Output
 } // namespace File
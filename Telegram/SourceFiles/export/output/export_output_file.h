@@ -19,15 +19,31 @@ namespace Output {
 struct Result;
 class Stats;
 
+enum class Compression {
+	None,
+	Gzip,
+};
+
 class File {
 public:
-	File(const QString &path, Stats *stats);
+	File(
+		const QString &path,
+		Stats *stats,
+		Compression compression = Compression::None);
+	~File();
 
 	[[nodiscard]] int size() const;
 	[[nodiscard]] bool empty() const;
 
+	// If writing a block failed it may be written again, the compressed
+	// output of the failed attempt is retried then.
 	[[nodiscard]] Result writeBlock(const QByteArray &block);
 
+	// Writes the end of the compressed stream, if there is one,
+	// and closes the file until the next written block.
+	// Compressed files can't be written to after they were closed.
+	[[nodiscard]] Result close();
+
 	[[nodiscard]] static QString PrepareRelativePath(
 		const QString &folder,
 		const QString &suggested);
@@ -37,9 +53,20 @@ public:
 		const QString &path,
 		Stats *stats);
 
+	// Returns false if the file system doesn't support hard links.
+	[[nodiscard]] static bool Link(
+		const QString &existing,
+		const QString &path);
+
 private:
+	struct Compressor;
+
 	[[nodiscard]] Result reopen();
+	[[nodiscard]] Result writeRaw(const QByteArray &block);
 	[[nodiscard]] Result writeBlockAttempt(const QByteArray &block);
+	[[nodiscard]] Result writeCompressed(
+		const QByteArray &block,
+		bool finish);
 
 	[[nodiscard]] Result error() const;
 	[[nodiscard]] Result fatalError() const;
@@ -51,6 +78,8 @@ private:
 	Stats *_stats = nullptr;
 	bool _inStats = false;
 
+	std::unique_ptr<Compressor> _compressor;
+
 };
 
 } // namespace Output
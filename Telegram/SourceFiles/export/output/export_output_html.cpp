@@ -2485,7 +2485,7 @@ Result HtmlWriter::writeEmptySinglePeer() {
 }
 
 Result HtmlWriter::writeDialogEnd() {
-	Expects(_settings.onlySinglePeer() || _chats != nullptr);
+	Expects(_settings.onlySinglePeer() || _dialogPart || _chats != nullptr);
 	Expects(_chat != nullptr);
 
 	if (const auto result = writeEmptySinglePeer(); !result) {
@@ -2494,9 +2494,35 @@ Result HtmlWriter::writeDialogEnd() {
 
 	if (const auto closed = base::take(_chat)->close(); !closed) {
 		return closed;
-	} else if (_settings.onlySinglePeer()) {
+	} else if (_settings.onlySinglePeer() || _dialogPart) {
 		return Result::Success();
 	}
+	return writeDialogEntry(_dialog, _messagesCount);
+}
+
+std::unique_ptr<AbstractWriter> HtmlWriter::createDialogWriter() {
+	auto result = std::make_unique<HtmlWriter>();
+	result->_settings = base::duplicate(_settings);
+	result->_environment = _environment;
+	result->_stats = _stats;
+	result->_dialogsRelativePath = _dialogsRelativePath;
+	result->_dialogPart = true;
+	return result;
+}
+
+Result HtmlWriter::writeDialogPart(not_null<AbstractWriter*> writer) {
+	Expects(writer->format() == Format::Html);
+
+	// Chat pages are already written, only the list entry is left.
+	const auto part = static_cast<HtmlWriter*>(writer.get());
+	Assert(part->_dialogPart && part->_chat == nullptr);
+	return writeDialogEntry(part->_dialog, part->_messagesCount);
+}
+
+Result HtmlWriter::writeDialogEntry(
+		const Data::DialogInfo &dialog,
+		int messagesCount) {
+	Expects(_chats != nullptr);
 
 	using Type = Data::DialogInfo::Type;
 	const auto TypeString = [](Type type) {
@@ -2555,26 +2581,26 @@ Result HtmlWriter::writeDialogEnd() {
 			+ (outgoing ? " outgoing messages" : " messages");
 	};
 	auto userpic = UserpicData{
-		((_dialog.type == Type::Self || _dialog.type == Type::Replies)
+		((dialog.type == Type::Self || dialog.type == Type::Replies)
 			? kSavedMessagesColorIndex
-			: Data::PeerColorIndex(_dialog.peerId)),
+			: Data::PeerColorIndex(dialog.peerId)),
 		kEntryUserpicSize
 	};
-	userpic.firstName = NameString(_dialog);
-	userpic.lastName = LastNameString(_dialog);
+	userpic.firstName = NameString(dialog);
+	userpic.lastName = LastNameString(dialog);
 
-	const auto result = validateDialogsMode(_dialog.isLeftChannel);
+	const auto result = validateDialogsMode(dialog.isLeftChannel);
 	if (!result) {
 		return result;
 	}
 
 	return _chats->writeBlock(_chats->pushListEntry(
 		userpic,
-		ComposeName(userpic, DeletedString(_dialog.type)),
-		CountString(_messagesCount, _dialog.onlyMyMessages),
-		TypeString(_dialog.type),
-		(_messagesCount > 0
-			? (_dialog.relativePath + "messages.html")
+		ComposeName(userpic, DeletedString(dialog.type)),
+		CountString(messagesCount, dialog.onlyMyMessages),
+		TypeString(dialog.type),
+		(messagesCount > 0
+			? (dialog.relativePath + "messages.html")
 			: QString())));
 }
 
@@ -71,6 +71,9 @@ public:
 	Result writeDialogEnd() override;
 	Result writeDialogsEnd() override;
 
+	std::unique_ptr<AbstractWriter> createDialogWriter() override;
+	Result writeDialogPart(not_null<AbstractWriter*> writer) override;
+
 	Result finish() override;
 
 	QString mainFilePath() override;
@@ -106,6 +109,9 @@ private:
 	[[nodiscard]] Result writeWebSessions(const Data::SessionsList &data);
 
 	[[nodiscard]] Result validateDialogsMode(bool isLeftChannel);
+	[[nodiscard]] Result writeDialogEntry(
+		const Data::DialogInfo &dialog,
+		int messagesCount);
 	[[nodiscard]] Result writeDialogOpening(int index);
 	[[nodiscard]] Result switchToNextChatFile(int index);
 	[[nodiscard]] Result writeEmptySinglePeer();
@@ -161,6 +167,9 @@ private:
 	std::vector<int> _lastMessageIdsPerFile;
 	bool _chatFileEmpty = false;
 
+	// Writes a single chat, see createDialogWriter().
+	bool _dialogPart = false;
+
 };
 
 } // namespace Output
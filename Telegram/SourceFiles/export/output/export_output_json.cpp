@@ -17,61 +17,142 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonValue>
 
+#include <charconv>
+
 namespace Export {
 namespace Output {
 namespace {
 
 using Context = details::JsonContext;
 
-QByteArray SerializeString(const QByteArray &value) {
-	const auto size = value.size();
-	const auto begin = value.data();
-	const auto end = begin + size;
+constexpr auto kFlushSize = 1024 * 1024;
+constexpr auto kDialogPartFile = "chat.json.part";
 
-	auto result = QByteArray();
-	result.reserve(2 + size * 4);
-	result.append('"');
-	for (auto p = begin; p != end; ++p) {
+// Bytes that can't be copied to the output as is.
+constexpr auto kEscapeTable = [] {
+	auto result = std::array<bool, 256>();
+	for (auto i = 0; i != 32; ++i) {
+		result[i] = true;
+	}
+	result[uchar('"')] = true;
+	result[uchar('\\')] = true;
+	result[0xE2] = true; // Line and paragraph separators.
+	return result;
+}();
+
+void AppendString(QByteArray &to, const char *data, int size) {
+	const auto end = data + size;
+
+	// Copy runs of bytes that don't need escaping in one append.
+	auto run = data;
+	to.append('"');
+	for (auto p = data; p != end; ++p) {
 		const auto ch = *p;
-		if (ch == '\n') {
-			result.append("\\n", 2);
+		if (!kEscapeTable[uchar(ch)]) {
+			continue;
+		}
+		const auto separator = (ch == char(0xE2))
+			&& (p + 2 < end)
+			&& (*(p + 1) == char(0x80))
+			&& (*(p + 2) == char(0xA8) || *(p + 2) == char(0xA9));
+		if (ch == char(0xE2) && !separator) {
+			continue;
+		}
+		to.append(run, int(p - run));
+		if (separator) {
+			to.append((*(p + 2) == char(0xA8)) ? "\\u2028" : "\\u2029", 6);
+			p += 2;
+		} else if (ch == '\n') {
+			to.append("\\n", 2);
 		} else if (ch == '\r') {
-			result.append("\\r", 2);
+			to.append("\\r", 2);
 		} else if (ch == '\t') {
-			result.append("\\t", 2);
+			to.append("\\t", 2);
 		} else if (ch == '"') {
-			result.append("\\\"", 2);
+			to.append("\\\"", 2);
 		} else if (ch == '\\') {
-			result.append("\\\\", 2);
-		} else if (ch >= 0 && ch < 32) {
-			result.append("\\x", 2).append('0' + (ch >> 4));
+			to.append("\\\\", 2);
+		} else {
+			to.append("\\x", 2).append(char('0' + (ch >> 4)));
 			const auto left = (ch & 0x0F);
 			if (left >= 10) {
-				result.append('A' + (left - 10));
-			} else {
-				result.append('0' + left);
-			}
-		} else if (ch == char(0xE2)
-			&& (p + 2 < end)
-			&& *(p + 1) == char(0x80)) {
-			if (*(p + 2) == char(0xA8)) { // Line separator.
-				result.append("\\u2028", 6);
-			} else if (*(p + 2) == char(0xA9)) { // Paragraph separator.
-				result.append("\\u2029", 6);
+				to.append(char('A' + (left - 10)));
 			} else {
-				result.append(ch);
+				to.append(char('0' + left));
 			}
-		} else {
-			result.append(ch);
 		}
+		run = p + 1;
+	}
+	to.append(run, int(end - run));
+	to.append('"');
+}
+
+void AppendString(QByteArray &to, const QByteArray &value) {
+	AppendString(to, value.constData(), value.size());
+}
+
+void AppendString(QByteArray &to, std::string_view value) {
+	AppendString(to, value.data(), int(value.size()));
+}
+
+void AppendString(QByteArray &to, const char *value) {
+	AppendString(to, std::string_view(value));
+}
+
+template <typename Integer>
+void AppendNumber(QByteArray &to, Integer value) {
+	static_assert(std::is_integral_v<Integer>);
+
+	char buffer[24];
+	const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+	to.append(buffer, int(result.ptr - buffer));
+}
+
+void AppendDigits(QByteArray &to, int value, int count) {
+	char buffer[4];
+	for (auto i = count; i != 0;) {
+		buffer[--i] = char('0' + (value % 10));
+		value /= 10;
+	}
+	to.append(buffer, count);
+}
+
+void AppendDate(QByteArray &to, TimeId date) {
+	const auto value = QDateTime::fromSecsSinceEpoch(date);
+	const auto day = value.date();
+	const auto time = value.time();
+	if (day.year() < 0 || day.year() > 9999) {
+		AppendString(to, value.toString(Qt::ISODate).toUtf8());
+		return;
 	}
-	result.append('"');
+
+	// Same as QDateTime::toString(Qt::ISODate) for the local time.
+	to.append('"');
+	AppendDigits(to, day.year(), 4);
+	to.append('-');
+	AppendDigits(to, day.month(), 2);
+	to.append('-');
+	AppendDigits(to, day.day(), 2);
+	to.append('T');
+	AppendDigits(to, time.hour(), 2);
+	to.append(':');
+	AppendDigits(to, time.minute(), 2);
+	to.append(':');
+	AppendDigits(to, time.second(), 2);
+	to.append('"');
+}
+
+QByteArray SerializeString(const QByteArray &value) {
+	auto result = QByteArray();
+	result.reserve(value.size() + 2);
+	AppendString(result, value);
 	return result;
 }
 
 QByteArray SerializeDate(TimeId date) {
-	return SerializeString(
-		QDateTime::fromSecsSinceEpoch(date).toString(Qt::ISODate).toUtf8());
+	auto result = QByteArray();
+	AppendDate(result, date);
+	return result;
 }
 
 QByteArray StringAllowEmpty(const Data::Utf8String &data) {
@@ -82,22 +163,19 @@ QByteArray StringAllowNull(const Data::Utf8String &data) {
 	return data.isEmpty() ? QByteArray("null") : SerializeString(data);
 }
 
-QByteArray Indentation(int size) {
-	return QByteArray(size, ' ');
-}
-
-QByteArray Indentation(const Context &context) {
-	return Indentation(context.nesting.size());
+void AppendLineStart(QByteArray &to, const Context &context, int indent) {
+	if (!context.singleLine) {
+		to.append('\n').append(indent, ' ');
+	}
 }
 
 QByteArray SerializeObject(
 		Context &context,
 		const std::vector<std::pair<QByteArray, QByteArray>> &values) {
-	const auto indent = Indentation(context);
+	const auto indent = int(context.nesting.size());
 
 	context.nesting.push_back(Context::kObject);
 	const auto guard = gsl::finally([&] { context.nesting.pop_back(); });
-	const auto next = '\n' + Indentation(context);
 
 	auto first = true;
 	auto result = QByteArray();
@@ -111,18 +189,19 @@ QByteArray SerializeObject(
 		} else {
 			result.append(',');
 		}
-		result.append(next).append(SerializeString(key)).append(": ", 2);
-		result.append(value);
+		AppendLineStart(result, context, indent + 1);
+		AppendString(result, key);
+		result.append(": ", 2).append(value);
 	}
-	result.append('\n').append(indent).append("}");
+	AppendLineStart(result, context, indent);
+	result.append('}');
 	return result;
 }
 
 QByteArray SerializeArray(
 		Context &context,
 		const std::vector<QByteArray> &values) {
-	const auto indent = Indentation(context.nesting.size());
-	const auto next = '\n' + Indentation(context.nesting.size() + 1);
+	const auto indent = int(context.nesting.size());
 
 	auto first = true;
 	auto result = QByteArray();
@@ -133,9 +212,11 @@ QByteArray SerializeArray(
 		} else {
 			result.append(',');
 		}
-		result.append(next).append(value);
+		AppendLineStart(result, context, indent + 1);
+		result.append(value);
 	}
-	result.append('\n').append(indent).append("]");
+	AppendLineStart(result, context, indent);
+	result.append(']');
 	return result;
 }
 
@@ -215,18 +296,64 @@ QByteArray FormatFilePath(const Data::File &file) {
 	return file.relativePath.toUtf8();
 }
 
-QByteArray SerializeMessage(
+// Same output as SerializeObject, but written right to the buffer.
+class ObjectAppender final {
+public:
+	ObjectAppender(QByteArray &to, Context &context)
+	: _to(to)
+	, _context(context)
+	, _indent(context.nesting.size()) {
+		_context.nesting.push_back(Context::kObject);
+		_to.append('{');
+	}
+
+	// The value must be appended to the result right after that.
+	[[nodiscard]] QByteArray &key(std::string_view key) {
+		if (_first) {
+			_first = false;
+		} else {
+			_to.append(',');
+		}
+		AppendLineStart(_to, _context, _indent + 1);
+		AppendString(_to, key);
+		_to.append(": ", 2);
+		return _to;
+	}
+
+	void push(std::string_view key, const QByteArray &value) {
+		if (!value.isEmpty()) {
+			this->key(key).append(value);
+		}
+	}
+
+	void finish() {
+		_context.nesting.pop_back();
+		AppendLineStart(_to, _context, _indent);
+		_to.append('}');
+	}
+
+private:
+	QByteArray &_to;
+	Context &_context;
+	int _indent = 0;
+	bool _first = true;
+
+};
+
+void AppendMessage(
+		QByteArray &to,
 		Context &context,
 		const Data::Message &message,
 		const std::map<PeerId, Data::Peer> &peers,
 		const QString &internalLinksDomain) {
 	using namespace Data;
 
+	auto object = ObjectAppender(to, context);
+	AppendNumber(object.key("id"), message.id);
 	if (v::is<UnsupportedMedia>(message.media.content)) {
-		return SerializeObject(context, {
-			{ "id", Data::NumberToString(message.id) },
-			{ "type", SerializeString("unsupported") }
-		});
+		AppendString(object.key("type"), "unsupported");
+		object.finish();
+		return;
 	}
 
 	const auto peer = [&](PeerId peerId) -> const Peer& {
@@ -244,59 +371,41 @@ QByteArray SerializeMessage(
 		return empty;
 	};
 
-	auto values = std::vector<std::pair<QByteArray, QByteArray>>{
-	{ "id", NumberToString(message.id) },
-	{
-		"type",
-		SerializeString(!v::is_null(message.action.content)
-			? "service"
-			: "message")
-	},
-	{ "date", SerializeDate(message.date) },
-	};
-	context.nesting.push_back(Context::kObject);
-	const auto serialized = [&] {
-		context.nesting.pop_back();
-		return SerializeObject(context, values);
-	};
+	AppendString(
+		object.key("type"),
+		(!v::is_null(message.action.content) ? "service" : "message"));
+	AppendDate(object.key("date"), message.date);
 
 	const auto pushBare = [&](
-			const QByteArray &key,
+			std::string_view key,
 			const QByteArray &value) {
-		if (!value.isEmpty()) {
-			values.emplace_back(key, value);
-		}
+		object.push(key, value);
 	};
 	if (message.edited) {
-		pushBare("edited", SerializeDate(message.edited));
+		AppendDate(object.key("edited"), message.edited);
 	}
 
-	const auto push = [&](const QByteArray &key, const auto &value) {
-		if constexpr (std::is_arithmetic_v<std::decay_t<decltype(value)>>) {
+	const auto push = [&](std::string_view key, const auto &value) {
+		using Type = std::decay_t<decltype(value)>;
+		if constexpr (std::is_integral_v<Type>) {
+			AppendNumber(object.key(key), value);
+		} else if constexpr (std::is_arithmetic_v<Type>) {
 			pushBare(key, Data::NumberToString(value));
-		} else if constexpr (std::is_same_v<
-				std::decay_t<decltype(value)>,
-				PeerId>) {
-			if (const auto chat = peerToChat(value)) {
-				pushBare(
-					key,
-					SerializeString("chat"
-						+ Data::NumberToString(chat.bare)));
-			} else if (const auto channel = peerToChannel(value)) {
-				pushBare(
-					key,
-					SerializeString("channel"
-						+ Data::NumberToString(channel.bare)));
-			} else {
-				pushBare(
-					key,
-					SerializeString("user"
-						+ Data::NumberToString(peerToUser(value).bare)));
-			}
+		} else if constexpr (std::is_same_v<Type, PeerId>) {
+			const auto chat = peerToChat(value);
+			const auto channel = peerToChannel(value);
+			auto &to = object.key(key);
+			to.append(chat ? "\"chat" : channel ? "\"channel" : "\"user");
+			AppendNumber(to, chat
+				? chat.bare
+				: channel
+				? channel.bare
+				: peerToUser(value).bare);
+			to.append('"');
 		} else {
 			const auto wrapped = QByteArray(value);
 			if (!wrapped.isEmpty()) {
-				pushBare(key, SerializeString(wrapped));
+				AppendString(object.key(key), wrapped);
 			}
 		}
 	};
@@ -306,14 +415,14 @@ QByteArray SerializeMessage(
 	const auto wrapUserName = [&](UserId userId) {
 		return StringAllowNull(user(userId).name());
 	};
-	const auto pushFrom = [&](const QByteArray &label = "from") {
+	const auto pushFrom = [&](std::string_view label = "from") {
 		if (message.fromId) {
 			pushBare(label, wrapPeerName(message.fromId));
-			push(label + "_id", message.fromId);
+			push(std::string(label) + "_id", message.fromId);
 		}
 	};
 	const auto pushReplyToMsgId = [&](
-			const QByteArray &label = "reply_to_message_id") {
+			std::string_view label = "reply_to_message_id") {
 		if (message.replyToMsgId) {
 			push(label, message.replyToMsgId);
 			if (message.replyToPeerId) {
@@ -323,7 +432,7 @@ QByteArray SerializeMessage(
 	};
 	const auto pushUserNames = [&](
 			const std::vector<UserId> &data,
-			const QByteArray &label = "members") {
+			std::string_view label = "members") {
 		auto list = std::vector<QByteArray>();
 		for (const auto &userId : data) {
 			list.push_back(wrapUserName(userId));
@@ -337,7 +446,7 @@ QByteArray SerializeMessage(
 		push("action", action);
 	};
 	const auto pushTTL = [&](
-			const QByteArray &label = "self_destruct_period_seconds") {
+			std::string_view label = "self_destruct_period_seconds") {
 		if (const auto ttl = message.media.ttl) {
 			push(label, ttl);
 		}
@@ -346,7 +455,7 @@ QByteArray SerializeMessage(
 	using SkipReason = Data::File::SkipReason;
 	const auto pushPath = [&](
 			const Data::File &file,
-			const QByteArray &label,
+			std::string_view label,
 			const QByteArray &name = QByteArray()) {
 		Expects(!file.relativePath.isEmpty()
 			|| file.skipReason != SkipReason::None);
@@ -670,13 +779,23 @@ QByteArray SerializeMessage(
 		Unexpected("Unsupported message.");
 	}, [](v::null_t) {});
 
-	pushBare("text", SerializeText(context, message.text));
-
-	return serialized();
+	const auto &text = message.text;
+	if (text.size() == 1 && text.front().type == TextPart::Type::Text) {
+		AppendString(object.key("text"), text.front().text);
+	} else {
+		pushBare("text", SerializeText(context, text));
+	}
+	object.finish();
 }
 
 } // namespace
 
+JsonWriter::JsonWriter(Format format) : _format(format) {
+	Expects(format == Format::Json || format == Format::Ndjson);
+
+	_context.singleLine = (format == Format::Ndjson);
+}
+
 Result JsonWriter::start(
 		const Settings &settings,
 		const Environment &environment,
@@ -688,34 +807,57 @@ Result JsonWriter::start(
 	_environment = environment;
 	_stats = stats;
 	_output = fileWithRelativePath(mainFileRelativePath());
+	_buffer.reserve(kFlushSize);
 	if (_settings.onlySinglePeer()) {
-		return Result::Success();
+		return _context.singleLine
+			? write(pushNesting(Context::kObject))
+			: Result::Success();
 	}
 	auto block = pushNesting(Context::kObject);
 	block.append(prepareObjectItemStart("about"));
 	block.append(SerializeString(_environment.aboutTelegram));
-	return _output->writeBlock(block);
+	return write(block);
 }
 
 QByteArray JsonWriter::pushNesting(Context::Type type) {
 	Expects(_output != nullptr);
 
+	// The root object of the JSON lines is written as separate lines.
+	const auto root = _context.singleLine && _context.nesting.empty();
+
 	_context.nesting.push_back(type);
 	_currentNestingHadItem = false;
-	return (type == Context::kObject ? "{" : "[");
+	return root ? "" : (type == Context::kObject ? "{" : "[");
 }
 
 QByteArray JsonWriter::prepareObjectItemStart(const QByteArray &key) {
 	const auto guard = gsl::finally([&] { _currentNestingHadItem = true; });
-	return (_currentNestingHadItem ? ",\n" : "\n")
-		+ Indentation(_context)
-		+ SerializeString(key)
-		+ ": ";
+	auto result = QByteArray();
+	if (_context.singleLine && _context.nesting.size() == 1) {
+		result.append(_currentNestingHadItem ? "}\n{" : "{");
+	} else {
+		if (_currentNestingHadItem) {
+			result.append(',');
+		}
+		AppendLineStart(result, _context, _context.nesting.size());
+	}
+	AppendString(result, key);
+	result.append(": ", 2);
+	return result;
 }
 
 QByteArray JsonWriter::prepareArrayItemStart() {
-	const auto guard = gsl::finally([&] { _currentNestingHadItem = true; });
-	return (_currentNestingHadItem ? ",\n" : "\n") + Indentation(_context);
+	auto result = QByteArray();
+	appendArrayItemStart(result);
+	return result;
+}
+
+void JsonWriter::appendArrayItemStart(QByteArray &to) {
+	if (_currentNestingHadItem) {
+		to.append(',');
+	}
+	AppendLineStart(to, _context, _context.nesting.size());
+	_currentNestingHadItem = true;
 }
 
 QByteArray JsonWriter::popNesting() {
@@ -725,17 +867,24 @@ QByteArray JsonWriter::popNesting() {
 	const auto type = Context::Type(_context.nesting.back());
 	_context.nesting.pop_back();
 
-	_currentNestingHadItem = true;
-	return '\n'
-		+ Indentation(_context)
-		+ (type == Context::kObject ? '}' : ']');
+	const auto hadItem = std::exchange(_currentNestingHadItem, true);
+	auto result = QByteArray();
+	if (_context.singleLine && _context.nesting.empty()) {
+		if (hadItem) {
+			result.append("}\n");
+		}
+		return result;
+	}
+	AppendLineStart(result, _context, _context.nesting.size());
+	result.append(type == Context::kObject ? '}' : ']');
+	return result;
 }
 
 Result JsonWriter::writePersonal(const Data::PersonalInfo &data) {
 	Expects(_output != nullptr);
 
 	const auto &info = data.user.info;
-	return _output->writeBlock(
+	return write(
 		prepareObjectItemStart("personal_information")
 		+ SerializeObject(_context, {
 		{ "user_id", Data::NumberToString(data.user.bareId) },
@@ -764,7 +913,7 @@ Result JsonWriter::writeUserpicsStart(const Data::UserpicsInfo &data) {
 	Expects(_output != nullptr);
 
 	auto block = prepareObjectItemStart("profile_pictures");
-	return _output->writeBlock(block + pushNesting(Context::kArray));
+	return write(block + pushNesting(Context::kArray));
 }
 
 Result JsonWriter::writeUserpicsSlice(const Data::UserpicsSlice &data) {
@@ -803,13 +952,13 @@ Result JsonWriter::writeUserpicsSlice(const Data::UserpicsSlice &data) {
 			},
 		}));
 	}
-	return _output->writeBlock(block);
+	return write(block);
 }
 
 Result JsonWriter::writeUserpicsEnd() {
 	Expects(_output != nullptr);
 
-	return _output->writeBlock(popNesting());
+	return write(popNesting());
 }
 
 Result JsonWriter::writeContactsList(const Data::ContactsList &data) {
@@ -862,7 +1011,7 @@ Result JsonWriter::writeSavedContacts(const Data::ContactsList &data) {
 		}
 	}
 	block.append(popNesting());
-	return _output->writeBlock(block + popNesting());
+	return write(block + popNesting());
 }
 
 Result JsonWriter::writeFrequentContacts(const Data::ContactsList &data) {
@@ -906,7 +1055,7 @@ Result JsonWriter::writeFrequentContacts(const Data::ContactsList &data) {
 	writeList(data.inlineBots, "inline_bots");
 	writeList(data.phoneCalls, "calls");
 	block.append(popNesting());
-	return _output->writeBlock(block + popNesting());
+	return write(block + popNesting());
 }
 
 Result JsonWriter::writeSessionsList(const Data::SessionsList &data) {
@@ -988,7 +1137,7 @@ Result JsonWriter::writeOtherData(const Data::File &data) {
 	} else {
 		pushArray(document.array());
 	}
-	return _output->writeBlock(block);
+	return write(block);
 }
 
 Result JsonWriter::writeSessions(const Data::SessionsList &data) {
@@ -1022,7 +1171,7 @@ Result JsonWriter::writeSessions(const Data::SessionsList &data) {
 		}));
 	}
 	block.append(popNesting());
-	return _output->writeBlock(block + popNesting());
+	return write(block + popNesting());
 }
 
 Result JsonWriter::writeWebSessions(const Data::SessionsList &data) {
@@ -1048,7 +1197,7 @@ Result JsonWriter::writeWebSessions(const Data::SessionsList &data) {
 		}));
 	}
 	block.append(popNesting());
-	return _output->writeBlock(block + popNesting());
+	return write(block + popNesting());
 }
 
 Result JsonWriter::writeDialogsStart(const Data::DialogsInfo &data) {
@@ -1056,9 +1205,16 @@ Result JsonWriter::writeDialogsStart(const Data::DialogsInfo &data) {
 }
 
 Result JsonWriter::writeDialogStart(const Data::DialogInfo &data) {
-	Expects(_output != nullptr);
-
-	if (!_settings.onlySinglePeer()) {
+	Expects(_output != nullptr || _dialogPart);
+
+	if (_dialogPart) {
+		// The chat entry is collected in a temporary file.
+		_partLeftChannel = data.isLeftChannel;
+		_partRelativePath = data.relativePath + kDialogPartFile;
+		_output = std::make_unique<File>(
+			pathWithRelativePath(_partRelativePath),
+			nullptr);
+	} else if (!_settings.onlySinglePeer()) {
 		const auto result = validateDialogsMode(data.isLeftChannel);
 		if (!result) {
 			return result;
@@ -1082,7 +1238,14 @@ Result JsonWriter::writeDialogStart(const Data::DialogInfo &data) {
 		Unexpected("Dialog type in TypeString.");
 	};
 
-	auto block = _settings.onlySinglePeer()
+	if (_context.singleLine) {
+		return writeDialogLine(
+			data,
+			TypeString(data.type),
+			(data.type != Type::Self && data.type != Type::Replies));
+	}
+
+	auto block = (_settings.onlySinglePeer() || _dialogPart)
 		? QByteArray()
 		: prepareArrayItemStart();
 	block.append(pushNesting(Context::kObject));
@@ -1096,7 +1259,40 @@ Result JsonWriter::writeDialogStart(const Data::DialogInfo &data) {
 		+ Data::NumberToString(Data::PeerToBareId(data.peerId)));
 	block.append(prepareObjectItemStart("messages"));
 	block.append(pushNesting(Context::kArray));
-	return _output->writeBlock(block);
+	return write(block);
+}
+
+Result JsonWriter::writeDialogLine(
+		const Data::DialogInfo &data,
+		const QByteArray &type,
+		bool withName) {
+	Expects(_chatOutput == nullptr);
+
+	const auto messages = data.relativePath
+		+ "messages.ndjson"
+		+ fileNameSuffix();
+	auto values = std::vector<std::pair<QByteArray, QByteArray>>();
+	if (withName) {
+		values.emplace_back("name", StringAllowNull(data.name));
+	}
+	values.emplace_back("type", StringAllowNull(type));
+	values.emplace_back(
+		"id",
+		Data::NumberToString(Data::PeerToBareId(data.peerId)));
+	values.emplace_back("messages", SerializeString(messages.toUtf8()));
+
+	const auto key = data.isLeftChannel ? "left_chat" : "chat";
+	auto block = _dialogPart ? QByteArray() : prepareObjectItemStart(key);
+	block.append(SerializeObject(_context, values));
+	if (const auto result = write(block); !result) {
+		return result;
+	} else if (const auto result = flush(); !result) {
+		return result;
+	}
+
+	// Create the file even if the chat doesn't have messages.
+	_chatOutput = fileWithRelativePath(messages);
+	return _chatOutput->writeBlock(QByteArray());
 }
 
 Result JsonWriter::validateDialogsMode(bool isLeftChannel) {
@@ -1120,26 +1316,118 @@ Result JsonWriter::validateDialogsMode(bool isLeftChannel) {
 
 Result JsonWriter::writeDialogSlice(const Data::MessagesSlice &data) {
 	Expects(_output != nullptr);
+	Expects(!_context.singleLine || _chatOutput != nullptr);
 
-	auto block = QByteArray();
 	for (const auto &message : data.list) {
 		if (Data::SkipMessageByDate(message, _settings)) {
 			continue;
 		}
-		block.append(prepareArrayItemStart() + SerializeMessage(
+		if (!_context.singleLine) {
+			appendArrayItemStart(_buffer);
+		}
+		AppendMessage(
+			_buffer,
 			_context,
 			message,
 			data.peers,
-			_environment.internalLinksDomain));
+			_environment.internalLinksDomain);
+		if (_context.singleLine) {
+			_buffer.append('\n');
+		}
 	}
-	return block.isEmpty() ? Result::Success() : _output->writeBlock(block);
+	return (_buffer.size() >= kFlushSize) ? flush() : Result::Success();
 }
 
 Result JsonWriter::writeDialogEnd() {
 	Expects(_output != nullptr);
 
-	auto block = popNesting();
-	return _output->writeBlock(block + popNesting());
+	if (_context.singleLine) {
+		Assert(_chatOutput != nullptr);
+
+		const auto guard = gsl::finally([&] { _chatOutput = nullptr; });
+		if (const auto result = flush(); !result) {
+			return result;
+		} else if (const auto result = _chatOutput->close(); !result) {
+			return result;
+		}
+	} else {
+		auto block = popNesting();
+		if (const auto result = write(block + popNesting()); !result) {
+			return result;
+		} else if (const auto result = flush(); !result) {
+			return result;
+		}
+	}
+	if (!_dialogPart) {
+		return Result::Success();
+	}
+	const auto result = _output->close();
+
+	// A finished part may wait for the chats before it for a long time,
+	// keep only the path of the written file until it is appended.
+	_output = nullptr;
+	_buffer = QByteArray();
+	return result;
+}
+
+std::unique_ptr<AbstractWriter> JsonWriter::createDialogWriter() {
+	auto result = std::make_unique<JsonWriter>(_format);
+	result->_settings = base::duplicate(_settings);
+	result->_environment = _environment;
+	result->_stats = _stats;
+	result->_dialogPart = true;
+	result->_buffer.reserve(kFlushSize);
+
+	// The entry is added inside of the chats list of the main file.
+	result->_context.nesting = _context.singleLine
+		? std::vector<Context::Type>{ Context::kObject }
+		: std::vector<Context::Type>{
+			Context::kObject,
+			Context::kObject,
+			Context::kArray,
+		};
+	return result;
+}
+
+Result JsonWriter::writeDialogPart(not_null<AbstractWriter*> writer) {
+	Expects(_output != nullptr);
+	Expects(writer->format() == _format);
+
+	const auto part = static_cast<JsonWriter*>(writer.get());
+	Assert(part->_dialogPart && !part->_partRelativePath.isEmpty());
+
+	const auto left = part->_partLeftChannel;
+	if (const auto result = validateDialogsMode(left); !result) {
+		return result;
+	}
+	const auto start = _context.singleLine
+		? prepareObjectItemStart(left ? "left_chat" : "chat")
+		: prepareArrayItemStart();
+	if (const auto result = write(start); !result) {
+		return result;
+	}
+	return appendFile(part->_partRelativePath);
+}
+
+Result JsonWriter::appendFile(const QString &relativePath) {
+	const auto path = pathWithRelativePath(relativePath);
+	auto file = QFile(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return Result(Result::Type::Error, path);
+	}
+	while (!file.atEnd()) {
+		const auto block = file.read(kFlushSize);
+		if (block.isEmpty()) {
+			return Result(Result::Type::Error, path);
+		} else if (const auto result = write(block); !result) {
+			return result;
+		}
+	}
+	file.close();
+	if (!file.remove()) {
+		return Result(Result::Type::Error, path);
+	}
+	return Result::Success();
 }
 
 Result JsonWriter::writeDialogsEnd() {
@@ -1154,31 +1442,59 @@ Result JsonWriter::writeChatsStart(
 		const QByteArray &about) {
 	Expects(_output != nullptr);
 
+	if (_context.singleLine) {
+		return Result::Success();
+	}
 	auto block = prepareObjectItemStart(listName);
 	block.append(pushNesting(Context::kObject));
 	block.append(prepareObjectItemStart("about"));
 	block.append(SerializeString(about));
 	block.append(prepareObjectItemStart("list"));
-	return _output->writeBlock(block + pushNesting(Context::kArray));
+	return write(block + pushNesting(Context::kArray));
 }
 
 Result JsonWriter::writeChatsEnd() {
 	Expects(_output != nullptr);
 
+	if (_context.singleLine) {
+		return Result::Success();
+	}
 	auto block = popNesting();
-	return _output->writeBlock(block + popNesting());
+	return write(block + popNesting());
 }
 
 Result JsonWriter::finish() {
 	Expects(_output != nullptr);
 
-	if (_settings.onlySinglePeer()) {
-		Assert(_context.nesting.empty());
-		return Result::Success();
+	if (!_settings.onlySinglePeer() || _context.singleLine) {
+		if (const auto result = write(popNesting()); !result) {
+			return result;
+		}
 	}
-	auto block = popNesting();
 	Assert(_context.nesting.empty());
-	return _output->writeBlock(block);
+	if (const auto result = flush(); !result) {
+		return result;
+	}
+	return _output->close();
+}
+
+Result JsonWriter::write(const QByteArray &block) {
+	_buffer.append(block);
+	return (_buffer.size() >= kFlushSize) ? flush() : Result::Success();
+}
+
+Result JsonWriter::flush() {
+	Expects(_output != nullptr);
+
+	if (_buffer.isEmpty()) {
+		return Result::Success();
+	}
+	const auto output = _chatOutput ? _chatOutput.get() : _output.get();
+	const auto result = output->writeBlock(_buffer);
+
+	// Keep the reserved capacity for the next blocks.
+	_buffer.resize(0);
+	return result;
 }
 
 QString JsonWriter::mainFilePath() {
@@ -1186,7 +1502,12 @@ QString JsonWriter::mainFilePath() {
 }
 
 QString JsonWriter::mainFileRelativePath() const {
-	return "result.json";
+	return (_context.singleLine ? "result.ndjson" : "result.json")
+		+ fileNameSuffix();
+}
+
+QString JsonWriter::fileNameSuffix() const {
+	return _settings.compress ? ".gz" : QString();
 }
 
 QString JsonWriter::pathWithRelativePath(const QString &path) const {
@@ -1195,7 +1516,10 @@ QString JsonWriter::pathWithRelativePath(const QString &path) const {
 
 std::unique_ptr<File> JsonWriter::fileWithRelativePath(
 		const QString &path) const {
-	return std::make_unique<File>(pathWithRelativePath(path), _stats);
+	return std::make_unique<File>(
+		pathWithRelativePath(path),
+		_stats,
+		(_settings.compress ? Compression::Gzip : Compression::None));
 }
 
 } // namespace Output
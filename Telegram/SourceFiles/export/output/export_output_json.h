@@ -23,14 +23,22 @@ struct JsonContext {
 
 	// Always fun to use std::vector<bool>.
 	std::vector<Type> nesting;
+
+	// No line breaks and indentation, for the JSON lines format.
+	bool singleLine = false;
 };
 
 } // namespace details
 
+// Writes either one result.json document or, in the JSON lines format,
+// one line for each top level item in result.ndjson and a separate
+// messages.ndjson file for each chat with one line for each message.
 class JsonWriter : public AbstractWriter {
 public:
+	explicit JsonWriter(Format format);
+
 	Format format() override {
-		return Format::Json;
+		return _format;
 	}
 
 	Result start(
@@ -56,6 +64,9 @@ public:
 	Result writeDialogEnd() override;
 	Result writeDialogsEnd() override;
 
+	std::unique_ptr<AbstractWriter> createDialogWriter() override;
+	Result writeDialogPart(not_null<AbstractWriter*> writer) override;
+
 	Result finish() override;
 
 	QString mainFilePath() override;
@@ -71,9 +82,11 @@ private:
 	[[nodiscard]] QByteArray pushNesting(Context::Type type);
 	[[nodiscard]] QByteArray prepareObjectItemStart(const QByteArray &key);
 	[[nodiscard]] QByteArray prepareArrayItemStart();
+	void appendArrayItemStart(QByteArray &to);
 	[[nodiscard]] QByteArray popNesting();
 
 	[[nodiscard]] QString mainFileRelativePath() const;
+	[[nodiscard]] QString fileNameSuffix() const;
 	[[nodiscard]] QString pathWithRelativePath(const QString &path) const;
 	[[nodiscard]] std::unique_ptr<File> fileWithRelativePath(
 		const QString &path) const;
@@ -84,12 +97,23 @@ private:
 	[[nodiscard]] Result writeSessions(const Data::SessionsList &data);
 	[[nodiscard]] Result writeWebSessions(const Data::SessionsList &data);
 
+	[[nodiscard]] Result writeDialogLine(
+		const Data::DialogInfo &data,
+		const QByteArray &type,
+		bool withName);
 	[[nodiscard]] Result validateDialogsMode(bool isLeftChannel);
 	[[nodiscard]] Result writeChatsStart(
 		const QByteArray &listName,
 		const QByteArray &about);
 	[[nodiscard]] Result writeChatsEnd();
+	[[nodiscard]] Result appendFile(const QString &relativePath);
 
+	// Blocks are collected in the buffer and written to the current file
+	// when it is large enough or when a chat is finished.
+	[[nodiscard]] Result write(const QByteArray &block);
+	[[nodiscard]] Result flush();
+
+	const Format _format = Format::Json;
 	Settings _settings;
 	Environment _environment;
 	Stats *_stats = nullptr;
@@ -99,6 +123,13 @@ private:
 	DialogsMode _dialogsMode = DialogsMode::None;
 
 	std::unique_ptr<File> _output;
+	std::unique_ptr<File> _chatOutput;
+	QByteArray _buffer;
+
+	// Writes a single chat, see createDialogWriter().
+	bool _dialogPart = false;
+	bool _partLeftChannel = false;
+	QString _partRelativePath;
 
 };
 
@@ -30,9 +30,22 @@ Content ContentFromState(
 			uint64 randomId = 0) {
 		result.rows.push_back({ id, label, info, progress, randomId });
 	};
+	// Several chats can be exported at the same time,
+	// the main progress is defined by the first one of them.
+	auto entities = state.otherEntities;
+	entities.push_back({
+		.type = state.entityType,
+		.name = state.entityName,
+		.index = state.entityIndex,
+		.itemIndex = state.itemIndex,
+		.itemCount = state.itemCount,
+	});
+	ranges::sort(entities, std::less<>(), &ProcessingState::Entity::index);
+	const auto entityIndex = entities.front().index;
+
 	const auto pushMain = [&](const QString &label) {
 		const auto info = (state.entityCount > 0)
-			? (QString::number(state.entityIndex + 1)
+			? (QString::number(entityIndex + 1)
 				+ " / "
 				+ QString::number(state.entityCount))
 			: QString();
@@ -51,9 +64,9 @@ Content ContentFromState(
 				: 0.;
 		};
 		const auto addProgress = (state.entityCount == 1
-			&& !state.entityIndex)
+			&& !entityIndex)
 			? addPart(state.itemIndex, state.itemCount)
-			: addPart(state.entityIndex, state.entityCount);
+			: addPart(entityIndex, state.entityCount);
 		push("main", label, info, doneProgress + addProgress);
 	};
 	const auto pushBytes = [&](
@@ -99,23 +112,26 @@ Content ContentFromState(
 		if (state.entityCount > 1) {
 			pushMain(tr::lng_export_state_chats(tr::now));
 		}
-		push(
-			"chat" + QString::number(state.entityIndex),
-			(state.entityName.isEmpty()
-				? tr::lng_deleted(tr::now)
-				: (state.entityType == ProcessingState::EntityType::Chat)
-				? state.entityName
-				: (state.entityType == ProcessingState::EntityType::SavedMessages)
-				? tr::lng_saved_messages(tr::now)
-				: tr::lng_replies_messages(tr::now)),
-			(state.itemCount > 0
-				? (QString::number(state.itemIndex)
-					+ " / "
-					+ QString::number(state.itemCount))
-				: QString()),
-			(state.itemCount > 0
-				? (state.itemIndex / float64(state.itemCount))
-				: 0.));
+		for (const auto &entity : entities) {
+			push(
+				"chat" + QString::number(entity.index),
+				(entity.name.isEmpty()
+					? tr::lng_deleted(tr::now)
+					: (entity.type == ProcessingState::EntityType::Chat)
+					? entity.name
+					: (entity.type
+						== ProcessingState::EntityType::SavedMessages)
+					? tr::lng_saved_messages(tr::now)
+					: tr::lng_replies_messages(tr::now)),
+				(entity.itemCount > 0
+					? (QString::number(entity.itemIndex)
+						+ " / "
+						+ QString::number(entity.itemCount))
+					: QString()),
+				(entity.itemCount > 0
+					? (entity.itemIndex / float64(entity.itemCount))
+					: 0.));
+		}
 		pushBytes(
 			("file"
 				+ QString::number(state.entityIndex)
@@ -131,6 +131,8 @@ void ResolveSettings(not_null<Main::Session*> session, Settings &settings) {
 	}
 	if (!settings.onlySinglePeer()) {
 		settings.singlePeerFrom = settings.singlePeerTill = 0;
+	} else {
+		settings.incremental = false;
 	}
 }
 
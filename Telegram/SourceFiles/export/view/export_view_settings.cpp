@@ -75,6 +75,7 @@ void ChooseFormatBox(
 	box->setTitle(tr::lng_export_option_choose_format());
 	addFormatOption(tr::lng_export_option_html(tr::now), Format::Html);
 	addFormatOption(tr::lng_export_option_json(tr::now), Format::Json);
+	addFormatOption(tr::lng_export_option_ndjson(tr::now), Format::Ndjson);
 	box->addButton(tr::lng_settings_save(), [=] { done(group->value()); });
 	box->addButton(tr::lng_cancel(), [=] { box->closeBox(); });
 }
@@ -273,6 +274,56 @@ void SettingsWidget::setupPathAndFormat(
 	addLocationLabel(container);
 	addFormatOption(tr::lng_export_option_html(tr::now), Format::Html);
 	addFormatOption(tr::lng_export_option_json(tr::now), Format::Json);
+	addFormatOption(tr::lng_export_option_ndjson(tr::now), Format::Ndjson);
+	addCompressOption(container);
+	addIncrementalOption(container);
+}
+
+void SettingsWidget::addCompressOption(
+		not_null<Ui::VerticalLayout*> container) {
+	const auto compress = container->add(
+		object_ptr<Ui::SlideWrap<Ui::Checkbox>>(
+			container,
+			object_ptr<Ui::Checkbox>(
+				container,
+				tr::lng_export_option_compress(tr::now),
+				readData().compress,
+				st::defaultBoxCheckbox),
+			st::exportSubSettingPadding));
+
+	compress->entity()->checkedChanges(
+	) | rpl::start_with_next([=](bool checked) {
+		changeData([&](Settings &data) {
+			data.compress = checked;
+		});
+	}, compress->lifetime());
+
+	compress->toggleOn(value() | rpl::map([](const Settings &data) {
+		return (data.format != Format::Html);
+	}) | rpl::distinct_until_changed());
+}
+
+void SettingsWidget::addIncrementalOption(
+		not_null<Ui::VerticalLayout*> container) {
+	const auto checkbox = container->add(
+		object_ptr<Ui::Checkbox>(
+			container,
+			tr::lng_export_option_incremental(tr::now),
+			readData().incremental,
+			st::defaultBoxCheckbox),
+		st::exportSettingPadding);
+	checkbox->checkedChanges(
+	) | rpl::start_with_next([=](bool checked) {
+		changeData([&](Settings &data) {
+			data.incremental = checked;
+		});
+	}, checkbox->lifetime());
+	container->add(
+		object_ptr<Ui::FlatLabel>(
+			container,
+			tr::lng_export_option_incremental_about(tr::now),
+			st::exportAboutOptionLabel),
+		st::exportAboutOptionPadding);
 }
 
 void SettingsWidget::addLocationLabel(
@@ -341,7 +392,11 @@ void SettingsWidget::addFormatAndLocationLabel(
 		return data.format;
 	}) | rpl::distinct_until_changed(
 	) | rpl::map([](Format format) {
-		const auto text = (format == Format::Html) ? "HTML" : "JSON";
+		const auto text = (format == Format::Html)
+			? "HTML"
+			: (format == Format::Json)
+			? "JSON"
+			: "NDJSON";
 		return Ui::Text::Link(text, u"internal:edit_format"_q);
 	});
 	const auto label = container->add(
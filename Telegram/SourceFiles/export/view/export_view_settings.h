@@ -82,6 +82,10 @@ private:
 		const QString &text,
 		MediaType type);
 	void addSizeSlider(not_null<Ui::VerticalLayout*> container);
+	void addCompressOption(
+		not_null<Ui::VerticalLayout*> container);
+	void addIncrementalOption(
+		not_null<Ui::VerticalLayout*> container);
 	void addLocationLabel(
 		not_null<Ui::VerticalLayout*> container);
 	void addFormatAndLocationLabel(
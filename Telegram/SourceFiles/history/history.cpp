@@ -71,6 +71,7 @@ History::History(not_null<Data::Session*> owner, PeerId peerId)
 , peer(owner->peer(peerId))
 , cloudDraftTextCache(st::dialogsTextWidthMin)
 , _delegateMixin(HistoryInner::DelegateMixin())
+, _allocator(new HistoryAllocator())
 , _mute(owner->notifyIsMuted(peer))
 , _chatListNameSortKey(owner->nameSortKey(peer->name))
 , _sendActionPainter(this) {
@@ -488,6 +489,63 @@ void History::destroyMessagesByDates(TimeId minDate, TimeId maxDate) {
 	}
 }
 
+int History::unloadMessages(const base::flat_set<FullMsgId> &keep) {
+	Expects(blocks.empty());
+
+	const auto notified = [&](not_null<HistoryItem*> item) {
+		return ranges::contains(
+			_notifications,
+			item,
+			&ItemNotification::item);
+	};
+	const auto kept = [&](not_null<HistoryItem*> item) {
+		return !item->isRegular()
+			|| item->mainView()
+			|| item->isPinned()
+			|| item->unread()
+			|| item->isUnreadMention()
+			|| item->hasUnreadReaction()
+			|| item->groupId()
+			|| item->ttlDestroyAt()
+			|| (item == _joinedMessage)
+			|| (_lastMessage && item == *_lastMessage)
+			|| (_lastServerMessage && item == *_lastServerMessage)
+			|| (_chatListMessage && item == *_chatListMessage)
+			|| notified(item)
+			|| keep.contains(item->fullId())
+			|| !owner().canUnloadMessage(item);
+	};
+	auto unload = std::vector<not_null<HistoryItem*>>();
+	for (const auto &message : _messages) {
+		if (!kept(message.get())) {
+			unload.push_back(message.get());
+		}
+	}
+	if (unload.empty()) {
+		return 0;
+	}
+
+	// Shared media slices may point to the unloaded messages.
+	clearSharedMedia();
+	for (const auto item : unload) {
+		// Unlike destroyMessage() we don't cancel the document loading,
+		// it may be a download started by the user.
+		owner().unregisterUnloadedMessage(item);
+
+		// Shown notifications are not in _notifications anymore,
+		// but the popups may still point to the item.
+		Core::App().notifications().clearFromItem(item);
+
+		auto hack = std::unique_ptr<HistoryItem>(item.get());
+		const auto i = _messages.find(hack);
+		hack.release();
+
+		Assert(i != end(_messages));
+		_messages.erase(i);
+	}
+	return int(unload.size());
+}
+
 void History::unpinAllMessages() {
 	session().storage().remove(
 		Storage::SharedMediaRemoveAll(
@@ -2769,7 +2827,7 @@ HistoryItem *History::lastEditableMessage() const {
 	return nullptr;
 }
 
-void History::resizeToWidth(int newWidth) {
+void History::resizeToWidth(int newWidth, int eagerHeight) {
 	const auto resizeAllItems = (_width != newWidth);
 
 	if (!resizeAllItems && !hasPendingResizedItems()) {
@@ -2777,15 +2835,114 @@ void History::resizeToWidth(int newWidth) {
 	}
 	_flags &= ~(Flag::HasPendingResizedItems);
 
+	const auto lazy = resizeAllItems && (_width > 0) && (eagerHeight > 0);
 	_width = newWidth;
-	int y = 0;
+	if (lazy) {
+		resizeItemsAroundScrollTop(eagerHeight);
+		_flags |= Flag::HasLazyResizedItems;
+	} else if (resizeAllItems) {
+		_flags &= ~Flag::HasLazyResizedItems;
+	}
+	countBlocksGeometry(resizeAllItems && !lazy);
+}
+
+void History::countBlocksGeometry(bool resizeAllItems) {
+	auto y = 0;
 	for (const auto &block : blocks) {
 		block->setY(y);
-		y += block->resizeGetHeight(newWidth, resizeAllItems);
+		y += block->resizeGetHeight(_width, resizeAllItems);
 	}
 	_height = y;
 }
 
+void History::resizeItemsAroundScrollTop(int eagerHeight) {
+	if (isEmpty()) {
+		return;
+	}
+	const auto anchor = scrollTopItem
+		? scrollTopItem
+		: blocks.back()->messages.back().get();
+	auto below = 0;
+	for (auto view = anchor
+		; view && below < eagerHeight
+		; view = view->nextInBlocks()) {
+		below += view->resizeGetHeight(_width);
+	}
+	auto above = 0;
+	for (auto view = anchor->previousInBlocks()
+		; view && above < eagerHeight
+		; view = view->previousInBlocks()) {
+		above += view->resizeGetHeight(_width);
+	}
+}
+
+bool History::hasLazyResizedItems() const {
+	return _flags & Flag::HasLazyResizedItems;
+}
+
+bool History::resizeLazyItems(int top, int bottom) {
+	if (!hasLazyResizedItems()) {
+		return false;
+	}
+	auto changed = false;
+	for (const auto &block : blocks) {
+		const auto blockTop = block->y();
+		if (blockTop >= bottom) {
+			break;
+		} else if (blockTop + block->height() <= top) {
+			continue;
+		}
+		for (const auto &message : block->messages) {
+			const auto messageTop = blockTop + message->y();
+			if (messageTop >= bottom) {
+				break;
+			} else if (messageTop + message->height() <= top
+				|| message->width() == _width) {
+				continue;
+			}
+			const auto was = message->height();
+			if (message->resizeGetHeight(_width) != was) {
+				changed = true;
+			}
+		}
+	}
+	if (changed) {
+		countBlocksGeometry(false);
+	}
+	return changed;
+}
+
+bool History::resizeLazyItems(crl::time till) {
+	if (!hasLazyResizedItems()) {
+		return false;
+	}
+	auto changed = false;
+	const auto finish = [&] {
+		if (changed) {
+			countBlocksGeometry(false);
+		}
+		return changed;
+	};
+
+	// The bottom part of the history is the one most likely to be shown.
+	for (const auto &block : ranges::views::reverse(blocks)) {
+		for (const auto &message : ranges::views::reverse(block->messages)) {
+			if (message->width() == _width) {
+				continue;
+			}
+			const auto was = message->height();
+			if (message->resizeGetHeight(_width) != was) {
+				changed = true;
+			}
+			if (crl::now() >= till) {
+				return finish();
+			}
+		}
+	}
+	_flags &= ~Flag::HasLazyResizedItems;
+	return finish();
+}
+
 void History::forceFullResize() {
 	_width = 0;
 	_flags |= Flag::HasPendingResizedItems;
@@ -3243,7 +3400,14 @@ bool History::switchPinnedHidden(bool hidden) {
 	return result;
 }
 
-History::~History() = default;
+not_null<HistoryAllocator*> History::allocator() const {
+	return _allocator;
+}
+
+History::~History() {
+	// Messages are destroyed after this, the allocator will follow them.
+	_allocator->detach();
+}
 
 HistoryBlock::HistoryBlock(not_null<History*> history)
 : _history(history) {
@@ -13,6 +13,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "dialogs/dialogs_entry.h"
 #include "dialogs/ui/dialogs_message_view.h"
 #include "history/view/history_view_send_action.h"
+#include "history/history_allocator.h"
 #include "base/observer.h"
 #include "base/timer.h"
 #include "base/variant.h"
@@ -145,26 +146,37 @@ public:
 
 	void applyGroupAdminChanges(const base::flat_set<UserId> &changes);
 
+	// Messages and their main views are allocated in it.
+	[[nodiscard]] not_null<HistoryAllocator*> allocator() const;
+
 	template <typename ...Args>
 	not_null<HistoryMessage*> makeMessage(Args &&...args) {
 		return static_cast<HistoryMessage*>(
 			insertItem(
-				std::make_unique<HistoryMessage>(
-					this,
-					std::forward<Args>(args)...)).get());
+				std::unique_ptr<HistoryItem>(new (_allocator.get())
+					HistoryMessage(
+						this,
+						std::forward<Args>(args)...))).get());
 	}
 
 	template <typename ...Args>
 	not_null<HistoryService*> makeServiceMessage(Args &&...args) {
 		return static_cast<HistoryService*>(
 			insertItem(
-				std::make_unique<HistoryService>(
-					this,
-					std::forward<Args>(args)...)).get());
+				std::unique_ptr<HistoryItem>(new (_allocator.get())
+					HistoryService(
+						this,
+						std::forward<Args>(args)...))).get());
 	}
 	void destroyMessage(not_null<HistoryItem*> item);
 	void destroyMessagesByDates(TimeId minDate, TimeId maxDate);
 
+	// Forgets the loaded messages that can be requested again, keeping
+	// the ones that the chat list, the unread state, other messages or
+	// forward drafts ('keep') refer to. Nobody is notified about them as
+	// about deleted ones. Returns the count of the unloaded messages.
+	int unloadMessages(const base::flat_set<FullMsgId> &keep);
+
 	void unpinAllMessages();
 
 	not_null<HistoryItem*> addNewMessage(
@@ -325,10 +337,19 @@ public:
 	MsgId msgIdForRead() const;
 	HistoryItem *lastEditableMessage() const;
 
-	void resizeToWidth(int newWidth);
+	// After a width change only the messages in 'eagerHeight' around
+	// the scroll top item are resized right away if 'eagerHeight' is
+	// positive, the rest keep their previous heights as estimates
+	// until they're laid out by resizeLazyItems().
+	void resizeToWidth(int newWidth, int eagerHeight = 0);
 	void forceFullResize();
 	int height() const;
 
+	// Both return true if some of the message heights have changed.
+	[[nodiscard]] bool hasLazyResizedItems() const;
+	bool resizeLazyItems(int top, int bottom);
+	bool resizeLazyItems(crl::time till);
+
 	void itemRemoved(not_null<HistoryItem*> item);
 	void itemVanished(not_null<HistoryItem*> item);
 
@@ -499,6 +520,7 @@ private:
 	enum class Flag {
 		HasPendingResizedItems = (1 << 0),
 		UnreadThingsKnown = (1 << 1),
+		HasLazyResizedItems = (1 << 2),
 	};
 	using Flags = base::flags<Flag>;
 	friend inline constexpr auto is_flag_type(Flag) {
@@ -511,6 +533,9 @@ private:
 	// scrollTopOffset is undefined
 	void getNextScrollTopItem(HistoryBlock *block, int32 i);
 
+	void countBlocksGeometry(bool resizeAllItems);
+	void resizeItemsAroundScrollTop(int eagerHeight);
+
 	// helper method for countScrollState(int top)
 	[[nodiscard]] Element *findScrollTopItem(int top) const;
 
@@ -611,6 +636,7 @@ private:
 	void setFolderPointer(Data::Folder *folder);
 
 	const std::unique_ptr<HistoryMainElementDelegateMixin> _delegateMixin;
+	const not_null<HistoryAllocator*> _allocator;
 
 	Flags _flags = 0;
 	bool _mute = false;
@@ -0,0 +1,195 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "history/history_allocator.h"
+
+#include <cstddef>
+
+namespace {
+
+constexpr auto kAlignment = std::size_t(alignof(std::max_align_t));
+constexpr auto kChunkSize = std::size_t(64 * 1024);
+constexpr auto kMinSlotsInChunk = 16;
+
+[[nodiscard]] constexpr std::size_t Aligned(std::size_t size) {
+	return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+// Each slot starts with a pointer to its chunk, nullptr for the heap,
+// while the slot is free the same place holds the next free slot.
+constexpr auto kHeaderSize = Aligned(sizeof(void*));
+
+HistoryAllocator::Stats Total;
+
+} // namespace
+
+struct HistoryAllocator::Chunk {
+	not_null<HistoryAllocator*> owner;
+	int slotSize = 0;
+	int slotsCount = 0;
+	int used = 0;
+	int fresh = 0; // Slots in the end that were never allocated.
+	void *freeList = nullptr;
+	Chunk *previous = nullptr;
+	Chunk *next = nullptr;
+
+	[[nodiscard]] char *slots() {
+		return reinterpret_cast<char*>(this) + Aligned(sizeof(Chunk));
+	}
+};
+
+HistoryAllocator::~HistoryAllocator() {
+	Expects(!_stats.alive);
+	Expects(!_stats.chunks);
+}
+
+void *HistoryAllocator::Allocate(
+		HistoryAllocator *allocator,
+		std::size_t size) {
+	++Total.allocations;
+	++Total.alive;
+	if (allocator) {
+		return allocator->allocate(size);
+	}
+	const auto memory = static_cast<char*>(
+		::operator new(kHeaderSize + size));
+	*reinterpret_cast<Chunk**>(memory) = nullptr;
+	return memory + kHeaderSize;
+}
+
+void HistoryAllocator::Free(void *pointer) {
+	if (!pointer) {
+		return;
+	}
+	++Total.deallocations;
+	--Total.alive;
+	const auto slot = static_cast<char*>(pointer) - kHeaderSize;
+	if (const auto chunk = *reinterpret_cast<Chunk**>(slot)) {
+		chunk->owner->free(chunk, slot);
+	} else {
+		::operator delete(slot);
+	}
+}
+
+void HistoryAllocator::detach() {
+	Expects(!_detached);
+
+	_detached = true;
+	if (!_stats.alive) {
+		delete this;
+	}
+}
+
+const HistoryAllocator::Stats &HistoryAllocator::stats() const {
+	return _stats;
+}
+
+const HistoryAllocator::Stats &HistoryAllocator::TotalStats() {
+	return Total;
+}
+
+void *HistoryAllocator::allocate(std::size_t size) {
+	Expects(!_detached);
+
+	const auto slotSize = int(kHeaderSize + Aligned(size));
+	auto &sizeClass = _classes[slotSize];
+	if (!sizeClass.available) {
+		link(sizeClass, createChunk(slotSize));
+	}
+	const auto chunk = sizeClass.available;
+	auto slot = static_cast<char*>(chunk->freeList);
+	if (slot) {
+		chunk->freeList = *reinterpret_cast<void**>(slot);
+	} else {
+		Assert(chunk->fresh < chunk->slotsCount);
+		slot = chunk->slots() + std::size_t(chunk->fresh++) * slotSize;
+	}
+	if (++chunk->used == chunk->slotsCount) {
+		unlink(sizeClass, chunk);
+	}
+	*reinterpret_cast<Chunk**>(slot) = chunk;
+
+	++_stats.allocations;
+	++_stats.alive;
+	return slot + kHeaderSize;
+}
+
+void HistoryAllocator::free(not_null<Chunk*> chunk, void *slot) {
+	auto &sizeClass = _classes[chunk->slotSize];
+	const auto wasFull = (chunk->used == chunk->slotsCount);
+	if (!--chunk->used) {
+		if (!wasFull) {
+			unlink(sizeClass, chunk);
+		}
+		destroyChunk(chunk);
+	} else {
+		*reinterpret_cast<void**>(slot) = chunk->freeList;
+		chunk->freeList = slot;
+		if (wasFull) {
+			link(sizeClass, chunk);
+		}
+	}
+
+	++_stats.deallocations;
+	if (!--_stats.alive && _detached) {
+		delete this;
+	}
+}
+
+auto HistoryAllocator::createChunk(int slotSize) -> not_null<Chunk*> {
+	const auto slotsCount = std::max(
+		int((kChunkSize - Aligned(sizeof(Chunk))) / slotSize),
+		kMinSlotsInChunk);
+	const auto bytes = Aligned(sizeof(Chunk))
+		+ std::size_t(slotsCount) * slotSize;
+	const auto result = new (::operator new(bytes)) Chunk{
+		.owner = this,
+		.slotSize = slotSize,
+		.slotsCount = slotsCount,
+	};
+	++_stats.chunks;
+	_stats.bytes += bytes;
+	++Total.chunks;
+	Total.bytes += bytes;
+	return result;
+}
+
+void HistoryAllocator::destroyChunk(not_null<Chunk*> chunk) {
+	const auto bytes = Aligned(sizeof(Chunk))
+		+ std::size_t(chunk->slotsCount) * chunk->slotSize;
+	--_stats.chunks;
+	_stats.bytes -= bytes;
+	--Total.chunks;
+	Total.bytes -= bytes;
+	chunk->~Chunk();
+	::operator delete(chunk.get());
+}
+
+void HistoryAllocator::link(
+		SizeClass &sizeClass,
+		not_null<Chunk*> chunk) {
+	chunk->previous = nullptr;
+	chunk->next = sizeClass.available;
+	if (chunk->next) {
+		chunk->next->previous = chunk;
+	}
+	sizeClass.available = chunk;
+}
+
+void HistoryAllocator::unlink(
+		SizeClass &sizeClass,
+		not_null<Chunk*> chunk) {
+	if (chunk->previous) {
+		chunk->previous->next = chunk->next;
+	} else {
+		sizeClass.available = chunk->next;
+	}
+	if (chunk->next) {
+		chunk->next->previous = chunk->previous;
+	}
+	chunk->previous = chunk->next = nullptr;
+}
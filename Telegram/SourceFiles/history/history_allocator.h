@@ -0,0 +1,84 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+// Slab allocator for the messages of a History and their views.
+//
+// Objects of the same size share chunks of memory, freed slots are reused
+// by the next objects and a chunk goes back to the heap as soon as it is
+// empty, so unloading a history releases its memory in big pieces instead
+// of leaving a heap fragmented by hundreds of thousands of small blocks.
+class HistoryAllocator final {
+public:
+	struct Stats {
+		int64 allocations = 0;
+		int64 deallocations = 0;
+		int64 alive = 0;
+		int64 chunks = 0;
+		int64 bytes = 0;
+	};
+
+	HistoryAllocator() = default;
+	HistoryAllocator(const HistoryAllocator &other) = delete;
+	HistoryAllocator &operator=(const HistoryAllocator &other) = delete;
+
+	// Uses the usual heap if 'allocator' is nullptr.
+	[[nodiscard]] static void *Allocate(
+		HistoryAllocator *allocator,
+		std::size_t size);
+	static void Free(void *pointer);
+
+	// The allocator deletes itself after the last object is freed.
+	void detach();
+
+	[[nodiscard]] const Stats &stats() const;
+
+	// Sums of all the allocators, heap objects are counted here as well.
+	[[nodiscard]] static const Stats &TotalStats();
+
+private:
+	struct Chunk;
+	struct SizeClass {
+		Chunk *available = nullptr;
+	};
+
+	~HistoryAllocator();
+
+	[[nodiscard]] void *allocate(std::size_t size);
+	void free(not_null<Chunk*> chunk, void *slot);
+	[[nodiscard]] not_null<Chunk*> createChunk(int slotSize);
+	void destroyChunk(not_null<Chunk*> chunk);
+	void link(SizeClass &sizeClass, not_null<Chunk*> chunk);
+	void unlink(SizeClass &sizeClass, not_null<Chunk*> chunk);
+
+	base::flat_map<int, SizeClass> _classes;
+	Stats _stats;
+	bool _detached = false;
+
+};
+
+// Base for the classes that can be created in a HistoryAllocator by
+// new (allocator) Type(...), the usual new-expression uses the heap.
+class HistoryAllocated {
+public:
+	[[nodiscard]] static void *operator new(std::size_t size) {
+		return HistoryAllocator::Allocate(nullptr, size);
+	}
+	[[nodiscard]] static void *operator new(
+			std::size_t size,
+			HistoryAllocator *allocator) {
+		return HistoryAllocator::Allocate(allocator, size);
+	}
+	static void operator delete(void *pointer) {
+		HistoryAllocator::Free(pointer);
+	}
+	static void operator delete(void *pointer, HistoryAllocator *) {
+		HistoryAllocator::Free(pointer);
+	}
+
+};
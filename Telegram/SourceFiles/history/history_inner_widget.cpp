@@ -97,6 +97,7 @@ namespace {
 constexpr auto kScrollDateHideTimeout = 1000;
 constexpr auto kUnloadHeavyPartsPages = 2;
 constexpr auto kClearUserpicsAfter = 50;
+constexpr auto kEagerResizeScreens = 2;
 
 // Helper binary search for an item in a list that is not completely
 // above the given top of the visible area or below the given bottom of the visible area
@@ -139,18 +140,16 @@ public:
 	std::unique_ptr<Element> elementCreate(
 			not_null<HistoryMessage*> message,
 			Element *replacing = nullptr) override {
-		return std::make_unique<HistoryView::Message>(
-			this,
-			message,
-			replacing);
+		const auto allocator = message->history()->allocator();
+		return std::unique_ptr<Element>(new (allocator.get())
+			HistoryView::Message(this, message, replacing));
 	}
 	std::unique_ptr<HistoryView::Element> elementCreate(
 			not_null<HistoryService*> message,
 			Element *replacing = nullptr) override {
-		return std::make_unique<HistoryView::Service>(
-			this,
-			message,
-			replacing);
+		const auto allocator = message->history()->allocator();
+		return std::unique_ptr<Element>(new (allocator.get())
+			HistoryView::Service(this, message, replacing));
 	}
 	bool elementUnderCursor(
 			not_null<const Element*> view) override {
@@ -2600,9 +2599,10 @@ void HistoryInner::recountHistoryGeometry() {
 		accumulate_max(oldHistoryPaddingTop, st::msgMargin.top() + st::msgMargin.bottom() + st::msgPadding.top() + st::msgPadding.bottom() + st::msgNameFont->height + st::botDescSkip + _botAbout->height);
 	}
 
-	_history->resizeToWidth(_contentWidth);
+	const auto eagerHeight = visibleHeight * kEagerResizeScreens;
+	_history->resizeToWidth(_contentWidth, eagerHeight);
 	if (_migrated) {
-		_migrated->resizeToWidth(_contentWidth);
+		_migrated->resizeToWidth(_contentWidth, eagerHeight);
 	}
 
 	// With migrated history we perhaps do not need to display
@@ -3810,6 +3810,37 @@ bool HistoryInner::hasPendingResizedItems() const {
 		|| (_migrated && _migrated->hasPendingResizedItems());
 }
 
+bool HistoryInner::hasLazyResizedItems() const {
+	return _history->hasLazyResizedItems()
+		|| (_migrated && _migrated->hasLazyResizedItems());
+}
+
+bool HistoryInner::resizeVisibleLazyItems(int top, int bottom) {
+	if (hasPendingResizedItems()) {
+		return false;
+	}
+	auto changed = false;
+	if (const auto htop = historyTop(); htop >= 0) {
+		if (_history->resizeLazyItems(top - htop, bottom - htop)) {
+			changed = true;
+		}
+	}
+	if (const auto mtop = migratedTop(); mtop >= 0) {
+		if (_migrated->resizeLazyItems(top - mtop, bottom - mtop)) {
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+bool HistoryInner::resizeLazyItems(crl::time till) {
+	if (hasPendingResizedItems()) {
+		return false;
+	}
+	const auto changed = _history->resizeLazyItems(till);
+	return (_migrated && _migrated->resizeLazyItems(till)) || changed;
+}
+
 void HistoryInner::deleteAsGroup(FullMsgId itemId) {
 	if (const auto item = session().data().message(itemId)) {
 		const auto group = session().data().groups().find(item);
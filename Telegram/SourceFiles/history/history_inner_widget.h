@@ -102,6 +102,12 @@ public:
 	void recountHistoryGeometry();
 	void updateSize();
 
+	// Lay out the messages left with the previous width after a resize,
+	// both return true if the history geometry should be updated.
+	[[nodiscard]] bool hasLazyResizedItems() const;
+	bool resizeVisibleLazyItems(int top, int bottom);
+	bool resizeLazyItems(crl::time till);
+
 	void repaintItem(const HistoryItem *item);
 	void repaintItem(const Element *view);
 
@@ -13,6 +13,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_media_types.h"
 #include "history/history_item_edition.h"
 #include "history/history_item_reply_markup.h"
+#include "history/history_allocator.h"
 
 #include <any>
 
@@ -75,7 +76,9 @@ class History;
 	MTPDmessageService::Flags flags,
 	MessageFlags localFlags);
 
-class HistoryItem : public RuntimeComposer<HistoryItem> {
+class HistoryItem
+	: public RuntimeComposer<HistoryItem>
+	, public HistoryAllocated {
 public:
 	static not_null<HistoryItem*> Create(
 		not_null<History*> history,
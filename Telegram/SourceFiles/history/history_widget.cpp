@@ -169,6 +169,9 @@ constexpr auto kMessagesPerPage = 50;
 constexpr auto kPreloadHeightsCount = 3; // when 3 screens to scroll left make a preload request
 constexpr auto kScrollToVoiceAfterScrolledMs = 1000;
 constexpr auto kSkipRepaintWhileScrollMs = 100;
+constexpr auto kResizeLazyItemsDelay = crl::time(200);
+constexpr auto kResizeLazyItemsInterval = crl::time(16);
+constexpr auto kResizeLazyItemsDuration = crl::time(8);
 constexpr auto kShowMembersDropdownTimeoutMs = 300;
 constexpr auto kDisplayEditTimeWarningMs = 300 * 1000;
 constexpr auto kFullDayInMs = 86400 * 1000;
@@ -310,6 +313,7 @@ HistoryWidget::HistoryWidget(
 	controller->chatStyle()->value(lifetime(), st::historyScroll),
 	false)
 , _updateHistoryItems([=] { updateHistoryItemsByTimer(); })
+, _resizeLazyItemsTimer([=] { resizeLazyItemsByTimer(); })
 , _historyDown(
 	_scroll,
 	controller->chatStyle()->value(lifetime(), st::historyToDown))
@@ -2421,6 +2425,7 @@ void HistoryWidget::showHistory(
 		updateTopBarChooseForReport();
 
 		_updateHistoryItems.cancel();
+		_resizeLazyItemsTimer.cancel();
 
 		setupPinnedTracker();
 		setupGroupCallBar();
@@ -2525,10 +2530,12 @@ void HistoryWidget::setHistory(History *history) {
 		const auto wasMigrated = base::take(_migrated);
 		unloadHeavyViewParts(wasHistory);
 		unloadHeavyViewParts(wasMigrated);
+		_messagesHold.destroy();
 	}
 	if (history) {
 		_history = history;
 		_migrated = _history ? _history->migrateFrom() : nullptr;
+		_messagesHold = Data::HoldMessages(_history, _migrated);
 		registerDraftSource();
 	}
 }
@@ -3555,6 +3562,19 @@ void HistoryWidget::visibleAreaUpdated() {
 		const auto scrollBottom = scrollTop + _scroll->height();
 		_list->visibleAreaUpdated(scrollTop, scrollBottom);
 		controller()->floatPlayerAreaUpdated();
+		if (!_resizingVisibleLazyItems
+			&& _list->resizeVisibleLazyItems(scrollTop, scrollBottom)) {
+			// The shown messages got their real heights after a resize,
+			// keep the scroll position anchored to the same message.
+			// Scrolling calls this method again, don't resize twice.
+			_resizingVisibleLazyItems = true;
+			updateListSize();
+			synteticScrollToY(std::clamp(
+				_list->historyScrollTop(),
+				0,
+				_scroll->scrollTopMax()));
+			_resizingVisibleLazyItems = false;
+		}
 	}
 }
 
@@ -5299,6 +5319,19 @@ void HistoryWidget::updateHistoryItemsByTimer() {
 	}
 }
 
+void HistoryWidget::resizeLazyItemsByTimer() {
+	if (!_list || !_historyInited || _scroll->isHidden()) {
+		return;
+	}
+	const auto till = crl::now() + kResizeLazyItemsDuration;
+	if (_list->resizeLazyItems(till)) {
+		updateHistoryGeometry();
+	}
+	if (_list->hasLazyResizedItems()) {
+		_resizeLazyItemsTimer.callOnce(kResizeLazyItemsInterval);
+	}
+}
+
 void HistoryWidget::handlePendingHistoryUpdate() {
 	if (hasPendingResizedItems() || _updateHistoryGeometryRequired) {
 		updateHistoryGeometry();
@@ -5654,6 +5687,9 @@ void HistoryWidget::updateListSize() {
 	Expects(_list != nullptr);
 
 	_list->recountHistoryGeometry();
+	if (_list->hasLazyResizedItems()) {
+		_resizeLazyItemsTimer.callOnce(kResizeLazyItemsDelay);
+	}
 	auto washidden = _scroll->isHidden();
 	if (washidden) {
 		_scroll->show();
@@ -6236,6 +6272,7 @@ void HistoryWidget::handlePeerMigration() {
 			channel);
 	} else {
 		_migrated = _history->migrateFrom();
+		_messagesHold = Data::HoldMessages(_history, _migrated);
 		_list->notifyMigrateUpdated();
 		setupPinnedTracker();
 		setupGroupCallBar();
@@ -372,6 +372,7 @@ private:
 
 	void handleScroll();
 	void updateHistoryItemsByTimer();
+	void resizeLazyItemsByTimer();
 
 	[[nodiscard]] Dialogs::EntryState computeDialogsEntryState() const;
 	void refreshTopBarActiveChat();
@@ -704,6 +705,7 @@ private:
 	QPointer<HistoryInner> _list;
 	History *_migrated = nullptr;
 	History *_history = nullptr;
+	rpl::lifetime _messagesHold;
 	// Initial updateHistoryGeometry() was called.
 	bool _historyInited = false;
 	// If updateListSize() was called without updateHistoryGeometry().
@@ -712,6 +714,8 @@ private:
 	int _lastScrollTop = 0; // gifs optimization
 	crl::time _lastScrolled = 0;
 	base::Timer _updateHistoryItems;
+	base::Timer _resizeLazyItemsTimer;
+	bool _resizingVisibleLazyItems = false;
 
 	crl::time _lastUserScrolled = 0;
 	bool _synteticScrollEvent = false;
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "history/view/history_view_object.h"
+#include "history/history_allocator.h"
 #include "base/runtime_composer.h"
 #include "base/flags.h"
 
@@ -240,7 +241,8 @@ struct ReactionAnimationArgs {
 class Element
 	: public Object
 	, public RuntimeComposer<Element>
-	, public ClickHandlerHost {
+	, public ClickHandlerHost
+	, public HistoryAllocated {
 public:
 	Element(
 		not_null<ElementDelegate*> delegate,
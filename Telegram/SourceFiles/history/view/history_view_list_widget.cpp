@@ -67,6 +67,10 @@ constexpr auto kPreloadIfLessThanScreens = 2;
 constexpr auto kPreloadedScreensCountFull
 	= kPreloadedScreensCount + 1 + kPreloadedScreensCount;
 constexpr auto kClearUserpicsAfter = 50;
+constexpr auto kEagerResizeScreens = 2;
+constexpr auto kResizeLazyItemsDelay = crl::time(200);
+constexpr auto kResizeLazyItemsInterval = crl::time(16);
+constexpr auto kResizeLazyItemsDuration = crl::time(8);
 
 } // namespace
 
@@ -280,6 +284,7 @@ ListWidget::ListWidget(
 , _highlightTimer([this] { updateHighlightedMessage(); }) {
 	setMouseTracking(true);
 	_scrollDateHideTimer.setCallback([this] { scrollDateHideByTimer(); });
+	_resizeLazyItemsTimer.setCallback([this] { resizeLazyItemsByTimer(); });
 	session().data().viewRepaintRequest(
 	) | rpl::start_with_next([this](auto view) {
 		if (view->delegate() == this) {
@@ -788,6 +793,14 @@ void ListWidget::visibleTopBottomUpdated(
 		checkUnreadBarCreation();
 	}
 	updateVisibleTopItem();
+	if (!_resizingVisibleLazyItems && resizeVisibleLazyItems()) {
+		// The shown items got their real heights after a resize,
+		// keep the scroll position anchored to the same item.
+		// Restoring it calls this method again, don't resize twice.
+		_resizingVisibleLazyItems = true;
+		updateSize();
+		_resizingVisibleLazyItems = false;
+	}
 	if (scrolledUp) {
 		_scrollDateCheck.call();
 	} else {
@@ -814,6 +827,54 @@ void ListWidget::updateVisibleTopItem() {
 	}
 }
 
+bool ListWidget::resizeVisibleLazyItems() {
+	if (!_hasLazyResizedItems || _items.empty()) {
+		return false;
+	}
+	auto changed = false;
+	const auto from = findItemIndexByY(_visibleTop);
+	for (auto i = from, count = int(_items.size()); i != count; ++i) {
+		const auto view = _items[i];
+		if (itemTop(view) >= _visibleBottom) {
+			break;
+		} else if (view->width() == _itemsWidth) {
+			continue;
+		}
+		const auto was = view->height();
+		if (view->resizeGetHeight(_itemsWidth) != was) {
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+void ListWidget::resizeLazyItemsByTimer() {
+	const auto till = crl::now() + kResizeLazyItemsDuration;
+	auto changed = false;
+
+	// The items near the bottom are the most likely to be shown.
+	for (const auto &view : ranges::views::reverse(_items)) {
+		if (view->width() == _itemsWidth) {
+			continue;
+		}
+		const auto was = view->height();
+		if (view->resizeGetHeight(_itemsWidth) != was) {
+			changed = true;
+		}
+		if (crl::now() >= till) {
+			if (changed) {
+				updateSize();
+			}
+			_resizeLazyItemsTimer.callOnce(kResizeLazyItemsInterval);
+			return;
+		}
+	}
+	_hasLazyResizedItems = false;
+	if (changed) {
+		updateSize();
+	}
+}
+
 bool ListWidget::displayScrollDate() const {
 	return (_visibleTop <= height() - 2 * (_visibleBottom - _visibleTop));
 }
@@ -1622,15 +1683,40 @@ int ListWidget::resizeGetHeight(int newWidth) {
 	update();
 
 	const auto resizeAllItems = (_itemsWidth != newWidth);
+
+	// After a width change only the items near the visible area are
+	// resized right away, the rest keep their previous heights until
+	// they're shown or laid out by resizeLazyItemsByTimer().
+	const auto lazy = resizeAllItems
+		&& (_itemsWidth > 0)
+		&& (_visibleTop < _visibleBottom);
+	const auto eagerHeight = (_visibleBottom - _visibleTop)
+		* kEagerResizeScreens;
+	const auto eagerTop = _visibleTop - eagerHeight;
+	const auto eagerBottom = _visibleBottom + eagerHeight;
+	const auto eager = [&](not_null<Element*> view, int wasTop) {
+		return !lazy
+			|| ((wasTop < eagerBottom)
+				&& (wasTop + view->height() > eagerTop));
+	};
 	auto newHeight = 0;
 	for (auto &view : _items) {
+		const auto wasTop = itemTop(view);
 		view->setY(newHeight);
-		if (view->pendingResize() || resizeAllItems) {
+		if (view->pendingResize()
+			|| (resizeAllItems && eager(view, wasTop))) {
 			newHeight += view->resizeGetHeight(newWidth);
 		} else {
 			newHeight += view->height();
 		}
 	}
+	if (lazy) {
+		_hasLazyResizedItems = true;
+		_resizeLazyItemsTimer.callOnce(kResizeLazyItemsDelay);
+	} else if (resizeAllItems) {
+		_hasLazyResizedItems = false;
+		_resizeLazyItemsTimer.cancel();
+	}
 	if (newHeight > 0) {
 		_itemAverageHeight = std::max(
 			itemMinimalHeight(),
@@ -412,6 +412,8 @@ private:
 
 	void checkMoveToOtherViewer();
 	void updateVisibleTopItem();
+	bool resizeVisibleLazyItems();
+	void resizeLazyItemsByTimer();
 	void updateItemsGeometry();
 	void updateSize();
 	void refreshAttachmentsFromTill(int from, int till);
@@ -549,6 +551,9 @@ private:
 	int _itemsTop = 0;
 	int _itemsWidth = 0;
 	int _itemsHeight = 0;
+	bool _hasLazyResizedItems = false;
+	bool _resizingVisibleLazyItems = false;
+	base::Timer _resizeLazyItemsTimer;
 	int _itemAverageHeight = 0;
 	base::flat_set<not_null<Element*>> _itemRevealPending;
 	base::flat_map<
@@ -35,6 +35,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/file_utilities.h"
 #include "main/main_session.h"
 #include "data/data_session.h"
+#include "data/data_histories.h"
 #include "data/data_user.h"
 #include "data/data_chat.h"
 #include "data/data_channel.h"
@@ -105,6 +106,8 @@ PinnedWidget::PinnedWidget(
 , _scrollDown(
 		_scroll.get(),
 		controller->chatStyle()->value(lifetime(), st::historyToDown)) {
+	lifetime().add(_history->owner().histories().holdMessages(_history));
+
 	controller->chatStyle()->paletteChanged(
 	) | rpl::start_with_next([=] {
 		_scroll->updateBars();
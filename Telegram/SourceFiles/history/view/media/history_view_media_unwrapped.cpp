@@ -31,7 +31,7 @@ constexpr auto kMaxForwardedBarLines = 4;
 auto UnwrappedMedia::Content::stickerTakeLottie(
 	not_null<DocumentData*> data,
 	const Lottie::ColorReplacements *replacements)
--> std::unique_ptr<Lottie::SinglePlayer> {
+-> std::shared_ptr<Lottie::SinglePlayer> {
 	return nullptr;
 }
 
@@ -465,7 +465,7 @@ QPoint UnwrappedMedia::resolveCustomInfoRightBottom() const {
 	return QPoint(fullRight - skipx, fullBottom - skipy);
 }
 
-std::unique_ptr<Lottie::SinglePlayer> UnwrappedMedia::stickerTakeLottie(
+std::shared_ptr<Lottie::SinglePlayer> UnwrappedMedia::stickerTakeLottie(
 		not_null<DocumentData*> data,
 		const Lottie::ColorReplacements *replacements) {
 	return _content->stickerTakeLottie(data, replacements);
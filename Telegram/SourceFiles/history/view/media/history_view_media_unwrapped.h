@@ -37,7 +37,7 @@ public:
 		}
 		virtual void stickerClearLoopPlayed() {
 		}
-		virtual std::unique_ptr<Lottie::SinglePlayer> stickerTakeLottie(
+		virtual std::shared_ptr<Lottie::SinglePlayer> stickerTakeLottie(
 			not_null<DocumentData*> data,
 			const Lottie::ColorReplacements *replacements);
 		virtual bool hasHeavyPart() const {
@@ -88,7 +88,7 @@ public:
 	void stickerClearLoopPlayed() override {
 		_content->stickerClearLoopPlayed();
 	}
-	std::unique_ptr<Lottie::SinglePlayer> stickerTakeLottie(
+	std::shared_ptr<Lottie::SinglePlayer> stickerTakeLottie(
 		not_null<DocumentData*> data,
 		const Lottie::ColorReplacements *replacements) override;
 
@@ -164,11 +164,10 @@ void Sticker::paintLottie(
 		Painter &p,
 		const PaintContext &context,
 		const QRect &r) {
+	// The player can be shared with other views of the same sticker,
+	// so the selection overlay is applied here instead of the request.
 	auto request = Lottie::FrameRequest();
 	request.box = _size * cIntRetinaFactor();
-	if (context.selected() && !_nextLastDiceFrame) {
-		request.colored = context.st->msgStickerOverlay()->c;
-	}
 	const auto frame = _lottie
 		? _lottie->frameInfo(request)
 		: Lottie::Animation::FrameInfo();
@@ -179,11 +178,16 @@ void Sticker::paintLottie(
 	const auto &image = _lastDiceFrame.isNull()
 		? frame.image
 		: _lastDiceFrame;
-	const auto prepared = (!_lastDiceFrame.isNull() && context.selected())
-		? Images::Colored(
-			base::duplicate(image),
+	const auto prepared = (context.selected() && !image.isNull())
+		? selectedFrame(
+			image,
+			_lastDiceFrame.isNull() ? frame.index : -1,
 			context.st->msgStickerOverlay()->c)
 		: image;
+	if (!context.selected() && !_selectedFrame.isNull()) {
+		_selectedFrame = QImage();
+		_selectedFrameIndex = -1;
+	}
 	const auto size = prepared.size() / cIntRetinaFactor();
 	p.drawImage(
 		QRect(
@@ -222,6 +226,21 @@ void Sticker::paintLottie(
 	}
 }
 
+const QImage &Sticker::selectedFrame(
+		const QImage &image,
+		int index,
+		const QColor &color) {
+	// Repaints of the same frame reuse the colored copy.
+	if (_selectedFrameIndex != index
+		|| _selectedFrameColor != color
+		|| _selectedFrame.size() != image.size()) {
+		_selectedFrame = Images::Colored(base::duplicate(image), color);
+		_selectedFrameIndex = index;
+		_selectedFrameColor = color;
+	}
+	return _selectedFrame;
+}
+
 bool Sticker::paintPixmap(
 		Painter &p,
 		const PaintContext &context,
@@ -356,12 +375,22 @@ void Sticker::setDiceIndex(const QString &emoji, int index) {
 void Sticker::setupLottie() {
 	Expects(_dataMedia != nullptr);
 
-	_lottie = ChatHelpers::LottiePlayerFromDocument(
-		_dataMedia.get(),
-		_replacements,
-		ChatHelpers::StickerLottieSize::MessageHistory,
-		size() * cIntRetinaFactor(),
-		Lottie::Quality::High);
+	const auto looped = (_diceIndex < 0)
+		&& !isEmojiSticker()
+		&& Core::App().settings().loopAnimatedStickers();
+	_lottie = looped
+		? ChatHelpers::SharedLottiePlayer(
+			_dataMedia.get(),
+			_replacements,
+			ChatHelpers::StickerLottieSize::MessageHistory,
+			size() * cIntRetinaFactor(),
+			Lottie::Quality::High)
+		: ChatHelpers::LottiePlayerFromDocument(
+			_dataMedia.get(),
+			_replacements,
+			ChatHelpers::StickerLottieSize::MessageHistory,
+			size() * cIntRetinaFactor(),
+			Lottie::Quality::High);
 	lottieCreated();
 }
 
@@ -377,7 +406,11 @@ void Sticker::lottieCreated() {
 		}, [&](const Lottie::DisplayFrameRequest &request) {
 			_parent->history()->owner().requestViewRepaint(_parent);
 		});
-	}, _lifetime);
+	}, _lottieLifetime);
+	if (_lottie->ready()) {
+		// The shared player could be ready before we subscribed.
+		_parent->history()->owner().requestViewRepaint(_parent);
+	}
 }
 
 bool Sticker::hasHeavyPart() const {
@@ -397,16 +430,21 @@ void Sticker::unloadLottie() {
 		_nextLastDiceFrame = false;
 		_lottieOncePlayed = false;
 	}
+	_lottieLifetime.destroy();
 	_lottie = nullptr;
+	_selectedFrame = QImage();
+	_selectedFrameIndex = -1;
 	_parent->checkHeavyPart();
 }
 
-std::unique_ptr<Lottie::SinglePlayer> Sticker::stickerTakeLottie(
+std::shared_ptr<Lottie::SinglePlayer> Sticker::stickerTakeLottie(
 		not_null<DocumentData*> data,
 		const Lottie::ColorReplacements *replacements) {
-	return (data == _data && replacements == _replacements)
-		? std::move(_lottie)
-		: nullptr;
+	if (data != _data || replacements != _replacements) {
+		return nullptr;
+	}
+	_lottieLifetime.destroy();
+	return std::move(_lottie);
 }
 
 } // namespace HistoryView
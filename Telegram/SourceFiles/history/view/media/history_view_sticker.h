@@ -53,7 +53,7 @@ public:
 	void stickerClearLoopPlayed() override {
 		_lottieOncePlayed = false;
 	}
-	std::unique_ptr<Lottie::SinglePlayer> stickerTakeLottie(
+	std::shared_ptr<Lottie::SinglePlayer> stickerTakeLottie(
 		not_null<DocumentData*> data,
 		const Lottie::ColorReplacements *replacements) override;
 
@@ -86,6 +86,10 @@ public:
 private:
 	[[nodiscard]] bool isEmojiSticker() const;
 	void paintLottie(Painter &p, const PaintContext &context, const QRect &r);
+	[[nodiscard]] const QImage &selectedFrame(
+		const QImage &image,
+		int index,
+		const QColor &color);
 	bool paintPixmap(Painter &p, const PaintContext &context, const QRect &r);
 	void paintPath(Painter &p, const PaintContext &context, const QRect &r);
 	[[nodiscard]] QPixmap paintedPixmap(const PaintContext &context) const;
@@ -101,11 +105,15 @@ private:
 	const not_null<Element*> _parent;
 	const not_null<DocumentData*> _data;
 	const Lottie::ColorReplacements *_replacements = nullptr;
-	std::unique_ptr<Lottie::SinglePlayer> _lottie;
+	std::shared_ptr<Lottie::SinglePlayer> _lottie;
+	rpl::lifetime _lottieLifetime; // Player can be shared with other views.
 	mutable std::shared_ptr<Data::DocumentMedia> _dataMedia;
 	ClickHandlerPtr _link;
 	QSize _size;
 	QImage _lastDiceFrame;
+	QImage _selectedFrame;
+	QColor _selectedFrameColor;
+	int _selectedFrameIndex = -1;
 	QString _diceEmoji;
 	int _diceIndex = -1;
 	mutable int _frameIndex = -1;
@@ -113,8 +121,6 @@ private:
 	mutable bool _lottieOncePlayed = false;
 	mutable bool _nextLastDiceFrame = false;
 
-	rpl::lifetime _lifetime;
-
 };
 
 } // namespace HistoryView
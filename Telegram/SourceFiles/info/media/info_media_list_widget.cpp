@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_peer_values.h"
 #include "data/data_document.h"
 #include "data/data_session.h"
+#include "data/data_histories.h"
 #include "data/data_file_click_handler.h"
 #include "data/data_file_origin.h"
 #include "history/history_item.h"
@@ -701,6 +702,11 @@ ListWidget::ListWidget(
 		[=] { scrollDateHide(); })) {
 	setMouseTracking(true);
 	start();
+
+	// Shared media slices refer to the loaded messages.
+	lifetime().add(Data::HoldMessages(
+		_peer->owner().history(_peer),
+		_migrated ? _migrated->owner().history(_migrated).get() : nullptr));
 }
 
 Main::Session &ListWidget::session() const {
@@ -376,6 +376,10 @@ const std::map<QString, Definition, std::greater<QString>> DefinitionMap {
 		.type = SettingType::IntSetting,
 		.defaultValue = 0,
 		.limitHandler = IntLimitMin(0) }},
+	{ "messages_memory_budget", {
+		.type = SettingType::IntSetting,
+		.defaultValue = 64,
+		.limitHandler = IntLimit(16, 4096, 64), }},
 	{ "recent_stickers_limit", {
 		.type = SettingType::IntSetting,
 		.defaultValue = 20,
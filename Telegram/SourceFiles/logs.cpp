@@ -13,9 +13,16 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/launcher.h"
 #include "mtproto/facade.h"
 
+#include <thread>
+#include <mutex>
+
 namespace {
 
+constexpr auto kQueueSize = 16384;
+constexpr auto kWriteInterval = std::chrono::milliseconds(50);
+
 std::atomic<int> ThreadCounter/* = 0*/;
+std::atomic<int> EntryCounter/* = 0*/;
 thread_local bool WritingEntryFlag/* = false*/;
 
 class WritingEntryScope final {
@@ -28,6 +35,42 @@ public:
 	}
 };
 
+// Formatting the date is done once a second in each thread.
+struct Timestamps {
+	time_t time = -1;
+	char main[32] = { 0 };
+	char debug[16] = { 0 };
+};
+thread_local Timestamps CachedTimestamps;
+
+const Timestamps &TimestampsAt(time_t time) {
+	auto &result = CachedTimestamps;
+	if (result.time != time) {
+		struct tm tm;
+		mylocaltime(&tm, &time);
+
+		result.time = time;
+		std::snprintf(
+			result.main,
+			sizeof(result.main),
+			"[%04d.%02d.%02d %02d:%02d:%02d] ",
+			tm.tm_year + 1900,
+			tm.tm_mon + 1,
+			tm.tm_mday,
+			tm.tm_hour,
+			tm.tm_min,
+			tm.tm_sec);
+		std::snprintf(
+			result.debug,
+			sizeof(result.debug),
+			"%02d:%02d:%02d",
+			tm.tm_hour,
+			tm.tm_min,
+			tm.tm_sec);
+	}
+	return result;
+}
+
 } // namespace
 
 enum LogDataType {
@@ -64,13 +107,139 @@ QString _logsFilePath(LogDataType type, const QString &postfix = QString()) {
 int32 LogsStartIndexChosen = -1;
 QString _logsEntryStart() {
 	static thread_local auto threadId = ThreadCounter++;
-	static auto index = 0;
 
-	const auto tm = QDateTime::currentDateTime();
-
-	return QString("[%1 %2-%3]").arg(tm.toString("hh:mm:ss.zzz"), QString("%1").arg(threadId, 2, 10, QChar('0'))).arg(++index, 7, 10, QChar('0'));
+	const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+	const auto &timestamps = TimestampsAt(time_t(now / 1000));
+
+	char result[64];
+	std::snprintf(
+		result,
+		sizeof(result),
+		"[%s.%03d %02d-%07d]",
+		timestamps.debug,
+		int(now % 1000),
+		threadId,
+		++EntryCounter);
+	return QString::fromLatin1(result);
 }
 
+// Bounded lock-free queue of the entries waiting for the logs thread.
+//
+// Any thread can push or pop, each slot sequence tells whether the slot
+// is free for the push at some position or ready for the pop from it.
+class LogsQueue final {
+public:
+	LogsQueue() {
+		for (auto i = 0; i != kQueueSize; ++i) {
+			_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	[[nodiscard]] bool push(LogDataType type, QByteArray &&data) {
+		auto position = _pushPosition.load(std::memory_order_relaxed);
+		while (true) {
+			auto &slot = _slots[position % kQueueSize];
+			const auto sequence = slot.sequence.load(
+				std::memory_order_acquire);
+			const auto difference = int64(sequence) - int64(position);
+			if (difference < 0) {
+				return false;
+			} else if (difference > 0) {
+				position = _pushPosition.load(std::memory_order_relaxed);
+			} else if (_pushPosition.compare_exchange_weak(
+					position,
+					position + 1,
+					std::memory_order_relaxed)) {
+				slot.type = type;
+				slot.data = std::move(data);
+				slot.sequence.store(
+					position + 1,
+					std::memory_order_release);
+				return true;
+			}
+		}
+	}
+
+	// Only one thread reads at a time, the entries are passed in place
+	// and their slots stay taken until release() is called. This way
+	// the crash handler still finds everything not flushed to the disk.
+	template <typename Callback>
+	[[nodiscard]] uint64 read(Callback &&callback) {
+		const auto from = _popPosition.load(std::memory_order_relaxed);
+		auto position = from;
+		while (position - from < uint64(kQueueSize)) {
+			const auto &slot = _slots[position % kQueueSize];
+			const auto sequence = slot.sequence.load(
+				std::memory_order_acquire);
+			if (sequence != position + 1) {
+				break;
+			}
+			callback(slot.type, slot.data);
+			++position;
+		}
+		return position - from;
+	}
+
+	void release(uint64 count) {
+		auto position = _popPosition.load(std::memory_order_relaxed);
+		for (; count != 0; --count) {
+			auto &slot = _slots[position % kQueueSize];
+			slot.data = QByteArray();
+
+			// The crash handler could have taken the rest already.
+			if (!_popPosition.compare_exchange_strong(
+					position,
+					position + 1,
+					std::memory_order_relaxed)) {
+				return;
+			}
+			slot.sequence.store(
+				position + kQueueSize,
+				std::memory_order_release);
+			++position;
+		}
+	}
+
+	// Used in the crash handler, so it doesn't allocate or free memory.
+	// The taken slots are never released and their data is not moved,
+	// the callback gets it in place.
+	template <typename Callback>
+	void takeWithoutRelease(Callback &&callback) {
+		auto position = _popPosition.load(std::memory_order_relaxed);
+		while (true) {
+			auto &slot = _slots[position % kQueueSize];
+			const auto sequence = slot.sequence.load(
+				std::memory_order_acquire);
+			const auto difference = int64(sequence)
+				- int64(position + 1);
+			if (difference < 0) {
+				return;
+			} else if (difference > 0) {
+				position = _popPosition.load(std::memory_order_relaxed);
+			} else if (_popPosition.compare_exchange_weak(
+					position,
+					position + 1,
+					std::memory_order_relaxed)) {
+				callback(slot.type, slot.data.constData());
+				++position;
+			}
+		}
+	}
+
+private:
+	struct Slot {
+		std::atomic<uint64> sequence = 0;
+		LogDataType type = LogDataMain;
+		QByteArray data;
+	};
+
+	std::array<Slot, kQueueSize> _slots;
+	std::atomic<uint64> _pushPosition = 0;
+	std::atomic<uint64> _popPosition = 0;
+
+};
+
 class LogsDataFields {
 public:
 
@@ -111,7 +280,7 @@ public:
 		return QString();
 	}
 
-	void write(LogDataType type, const QString &msg) {
+	void write(LogDataType type, const QByteArray &msg) {
 		QMutexLocker lock(_logsMutex(type));
 		WritingEntryScope scope;
 
@@ -122,8 +291,17 @@ public:
 		if (!file || !file->isOpen()) {
 			return;
 		}
-		file->write(msg.toUtf8());
-		file->flush();
+		file->write(msg);
+	}
+
+	void flush(LogDataType type) {
+		QMutexLocker lock(_logsMutex(type));
+		WritingEntryScope scope;
+
+		const auto file = files[type].get();
+		if (file && file->isOpen()) {
+			file->flush();
+		}
 	}
 
 private:
@@ -254,6 +432,69 @@ NEW LOGGING INSTANCE STARTED!!!\n\
 
 LogsDataFields *LogsData = 0;
 
+LogsQueue Queue;
+std::atomic<int> DroppedEntries/* = 0*/;
+
+// Entries are written to files and files are flushed in a separate thread,
+// the other threads only put them to the queue or drop them if it is full.
+std::thread *WriterThread = nullptr;
+std::atomic<bool> WriterStopping/* = false*/;
+std::mutex WriterMutex;
+
+void _logsWritePending() {
+	auto lock = std::unique_lock(WriterMutex);
+	if (!LogsData) {
+		return;
+	}
+	auto written = std::array<bool, LogDataCount>();
+	const auto read = Queue.read([&](
+			LogDataType type,
+			const QByteArray &data) {
+		LogsData->write(type, data);
+		written[type] = true;
+	});
+	if (const auto dropped = DroppedEntries.exchange(0)) {
+		const auto &timestamps = TimestampsAt(time(nullptr));
+		LogsData->write(
+			LogDataMain,
+			(timestamps.main
+				+ QString("Logs: %1 entries dropped, queue is full.\n"
+				).arg(dropped)).toUtf8());
+		written[LogDataMain] = true;
+	}
+	for (auto i = 0; i != LogDataCount; ++i) {
+		if (written[i]) {
+			LogsData->flush(LogDataType(i));
+		}
+	}
+	Queue.release(read);
+}
+
+void _logsStartWriter() {
+	if (WriterThread) {
+		return;
+	}
+	WriterStopping = false;
+	WriterThread = new std::thread([] {
+		while (true) {
+			const auto stopping = WriterStopping.load();
+			_logsWritePending();
+			if (stopping) {
+				break;
+			}
+			std::this_thread::sleep_for(kWriteInterval);
+		}
+	});
+}
+
+void _logsStopWriter() {
+	if (WriterThread) {
+		WriterStopping = true;
+		WriterThread->join();
+		delete base::take(WriterThread);
+	}
+}
+
 using LogsInMemoryList = QList<QPair<LogDataType, QString>>;
 LogsInMemoryList *LogsInMemory = 0;
 LogsInMemoryList *DeletedLogsInMemory = SharedMemoryLocation<LogsInMemoryList, 0>();
@@ -263,7 +504,9 @@ QString LogsBeforeSingleInstanceChecked; // LogsInMemory already dumped in LogsD
 void _logsWrite(LogDataType type, const QString &msg) {
 	if (LogsData && (type == LogDataMain || LogsStartIndexChosen < 0)) {
 		if (type == LogDataMain || Logs::DebugEnabled()) {
-			LogsData->write(type, msg);
+			if (!Queue.push(type, msg.toUtf8())) {
+				++DroppedEntries;
+			}
 		}
 	} else if (LogsInMemory != DeletedLogsInMemory) {
 		if (!LogsInMemory) {
@@ -424,6 +667,8 @@ void start(not_null<Core::Launcher*> launcher) {
 	if (!LogsData->openMain()) {
 		delete LogsData;
 		LogsData = nullptr;
+	} else {
+		_logsStartWriter();
 	}
 
 	LOG(("Launched version: %1, install beta: %2, %3: %4, debug mode: %5"
@@ -466,6 +711,7 @@ void start(not_null<Core::Launcher*> launcher) {
 }
 
 void finish() {
+	_logsStopWriter();
 	delete LogsData;
 	LogsData = 0;
 
@@ -486,9 +732,16 @@ bool started() {
 bool instanceChecked() {
 	if (!LogsData) return false;
 
-	if (!LogsData->instanceChecked()) {
+	auto checked = false;
+	{
+		_logsWritePending();
+		auto lock = std::unique_lock(WriterMutex);
+		checked = LogsData->instanceChecked();
+	}
+	if (!checked) {
 		LogsBeforeSingleInstanceChecked = Logs::full();
 
+		_logsStopWriter();
 		delete LogsData;
 		LogsData = 0;
 		LOG(("FATAL: Could not move logging to '%1'!").arg(_logsFilePath(LogDataMain)));
@@ -531,24 +784,15 @@ void multipleInstances() {
 void closeMain() {
 	LOG(("Explicitly closing main log and finishing crash handlers."));
 	if (LogsData) {
+		_logsWritePending();
+		auto lock = std::unique_lock(WriterMutex);
 		LogsData->closeMain();
 	}
 }
 
 void writeMain(const QString &v) {
-	time_t t = time(NULL);
-	struct tm tm;
-	mylocaltime(&tm, &t);
-
-	const auto msg = QString("[%1.%2.%3 %4:%5:%6] %7\n"
-	).arg(tm.tm_year + 1900
-	).arg(tm.tm_mon + 1, 2, 10, QChar('0')
-	).arg(tm.tm_mday, 2, 10, QChar('0')
-	).arg(tm.tm_hour, 2, 10, QChar('0')
-	).arg(tm.tm_min, 2, 10, QChar('0')
-	).arg(tm.tm_sec, 2, 10, QChar('0')
-	).arg(v);
-	_logsWrite(LogDataMain, msg);
+	const auto &timestamps = TimestampsAt(time(nullptr));
+	_logsWrite(LogDataMain, QLatin1String(timestamps.main) + v + '\n');
 
 	writeDebug(v);
 }
@@ -612,8 +856,24 @@ void writeMtp(int32 dc, const QString &v) {
 	_logsWrite(LogDataMtp, msg);
 }
 
+void takeUnwritten(void (*callback)(const char *kind, const char *entry)) {
+	Queue.takeWithoutRelease([&](LogDataType type, const char *entry) {
+		const auto kind = [&] {
+			switch (type) {
+			case LogDataMain: return "main";
+			case LogDataDebug: return "debug";
+			case LogDataTcp: return "tcp";
+			case LogDataMtp: return "mtp";
+			}
+			return "unknown";
+		}();
+		callback(kind, entry);
+	});
+}
+
 QString full() {
 	if (LogsData) {
+		_logsWritePending();
 		return LogsData->full();
 	}
 	if (!LogsInMemory || LogsInMemory == DeletedLogsInMemory) {
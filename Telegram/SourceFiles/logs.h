@@ -37,6 +37,11 @@ void writeMtp(int32 dc, const QString &v);
 
 QString full();
 
+// Passes the log entries of all kinds that are not flushed to the files
+// yet, so that the crash handler could put them to the crash report.
+// Doesn't allocate memory, but leaves the log queue unusable.
+void takeUnwritten(void (*callback)(const char *kind, const char *entry));
+
 inline const char *b(bool v) {
 	return v ? "[TRUE]" : "[FALSE]";
 }
@@ -287,6 +287,77 @@ bool SupportsSpeedControl() {
 		&& (alGetEnumValue("AL_EFFECTSLOT_EFFECT") != 0);
 }
 
+template <typename Value, typename Amplitude>
+uint16 MaxAmplitudeOf(gsl::span<const Value> values, Amplitude amplitude) {
+	// Independent accumulators let the compiler vectorize the loop.
+	constexpr auto kLanes = 16;
+	auto lanes = std::array<int, kLanes>{ 0 };
+	const auto data = values.data();
+	const auto size = int64(values.size());
+	auto i = int64(0);
+	for (; i + kLanes <= size; i += kLanes) {
+		for (auto j = 0; j != kLanes; ++j) {
+			lanes[j] = std::max(lanes[j], amplitude(data[i + j]));
+		}
+	}
+	auto result = *ranges::max_element(lanes);
+	for (; i != size; ++i) {
+		result = std::max(result, amplitude(data[i]));
+	}
+	return uint16(result);
+}
+
+uint16 MaxAmplitude(gsl::span<const uchar> samples) {
+	const auto result = MaxAmplitudeOf(samples, [](uchar sample) {
+		return std::abs(int(sample) - 0x80);
+	});
+	return uint16(result * 0x100);
+}
+
+uint16 MaxAmplitude(gsl::span<const int16> samples) {
+	return MaxAmplitudeOf(samples, [](int16 sample) {
+		return std::abs(int(sample));
+	});
+}
+
+uint16 MaxAmplitude(gsl::span<const uint16> amplitudes) {
+	return MaxAmplitudeOf(amplitudes, [](uint16 amplitude) {
+		return int(amplitude);
+	});
+}
+
+PeaksCounter::PeaksCounter(int64 total, int peaksCount)
+: _total(total)
+, _step(peaksCount) {
+	Expects(_total > 0);
+	Expects(_step > 0);
+
+	_peaks.reserve(peaksCount);
+}
+
+QVector<uint16> PeaksCounter::finish() {
+	if (_sum > 0 && _peaks.size() < _step) {
+		_peaks.push_back(base::take(_peak));
+	}
+	return std::move(_peaks);
+}
+
+VoiceWaveform WaveformFromPeaks(const QVector<uint16> &peaks) {
+	if (peaks.isEmpty()) {
+		return VoiceWaveform();
+	}
+	const auto sum = std::accumulate(peaks.cbegin(), peaks.cend(), 0LL);
+	const auto peak = qMax(int32(sum * 1.8 / peaks.size()), 2500);
+
+	auto result = VoiceWaveform(peaks.size());
+	for (auto i = 0, l = int(peaks.size()); i != l; ++i) {
+		result[i] = char(qMin(
+			31U,
+			uint32(qMin(int32(peaks[i]), peak)) * 31 / peak));
+	}
+	return result;
+}
+
 } // namespace Audio
 
 namespace Player {
@@ -1731,25 +1802,14 @@ public:
 		buffer.reserve(kWaveformCounterBufferSize);
 		int64 countbytes = sampleSize() * samplesCount();
 		int64 processed = 0;
-		int64 sumbytes = 0;
 		if (samplesCount() < Media::Player::kWaveformSamplesCount) {
 			return false;
 		}
 
-		QVector<uint16> peaks;
-		peaks.reserve(Media::Player::kWaveformSamplesCount);
-
+		auto counter = Media::Audio::PeaksCounter(
+			countbytes,
+			Media::Player::kWaveformSamplesCount);
 		auto fmt = format();
-		auto peak = uint16(0);
-		auto callback = [&](uint16 sample) {
-			accumulate_max(peak, sample);
-			sumbytes += Media::Player::kWaveformSamplesCount;
-			if (sumbytes >= countbytes) {
-				sumbytes -= countbytes;
-				peaks.push_back(peak);
-				peak = 0;
-			}
-		};
 		while (processed < countbytes) {
 			buffer.resize(0);
 
@@ -1762,31 +1822,18 @@ public:
 				continue;
 			}
 
+			using namespace Media::Audio;
 			auto sampleBytes = bytes::make_span(buffer);
 			if (fmt == AL_FORMAT_MONO8 || fmt == AL_FORMAT_STEREO8) {
-				Media::Audio::IterateSamples<uchar>(sampleBytes, callback);
+				counter.add(SamplesSpan<uchar>(sampleBytes));
 			} else if (fmt == AL_FORMAT_MONO16 || fmt == AL_FORMAT_STEREO16) {
-				Media::Audio::IterateSamples<int16>(sampleBytes, callback);
+				counter.add(SamplesSpan<int16>(sampleBytes));
 			}
 			processed += sampleSize() * samples;
 		}
-		if (sumbytes > 0 && peaks.size() < Media::Player::kWaveformSamplesCount) {
-			peaks.push_back(peak);
-		}
-
-		if (peaks.isEmpty()) {
-			return false;
-		}
 
-		auto sum = std::accumulate(peaks.cbegin(), peaks.cend(), 0LL);
-		peak = qMax(int32(sum * 1.8 / peaks.size()), 2500);
-
-		result.resize(peaks.size());
-		for (int32 i = 0, l = peaks.size(); i != l; ++i) {
-			result[i] = char(qMin(31U, uint32(qMin(peaks.at(i), peak)) * 31 / peak));
-		}
-
-		return true;
+		result = Media::Audio::WaveformFromPeaks(counter.finish());
+		return !result.isEmpty();
 	}
 
 	const VoiceWaveform &waveform() const {
@@ -415,5 +415,54 @@ void IterateSamples(bytes::const_span bytes, Callback &&callback) {
 	}
 }
 
+// Thread: Any. The same as max of ReadOneSample() over all the samples.
+[[nodiscard]] uint16 MaxAmplitude(gsl::span<const uchar> samples);
+[[nodiscard]] uint16 MaxAmplitude(gsl::span<const int16> samples);
+[[nodiscard]] uint16 MaxAmplitude(gsl::span<const uint16> amplitudes);
+
+template <typename SampleType>
+[[nodiscard]] gsl::span<const SampleType> SamplesSpan(bytes::const_span bytes) {
+	return gsl::make_span(
+		reinterpret_cast<const SampleType*>(bytes.data()),
+		bytes.size() / sizeof(SampleType));
+}
+
+// Thread: Any.
+// Splits 'total' samples into 'peaksCount' parts, finding their peaks.
+// Samples are reduced in runs between the parts bounds, not one by one.
+class PeaksCounter final {
+public:
+	PeaksCounter(int64 total, int peaksCount);
+
+	template <typename SampleType>
+	void add(gsl::span<const SampleType> samples) {
+		while (!samples.empty()) {
+			const auto left = std::max(
+				(_total - _sum + _step - 1) / _step,
+				int64(1));
+			const auto count = std::min(int64(samples.size()), left);
+			accumulate_max(_peak, MaxAmplitude(samples.subspan(0, count)));
+			samples = samples.subspan(count);
+			_sum += count * _step;
+			if (_sum >= _total) {
+				_sum -= _total;
+				_peaks.push_back(base::take(_peak));
+			}
+		}
+	}
+	[[nodiscard]] QVector<uint16> finish();
+
+private:
+	const int64 _total = 0;
+	const int64 _step = 0;
+	int64 _sum = 0;
+	uint16 _peak = 0;
+	QVector<uint16> _peaks;
+
+};
+
+// Thread: Any. Normalizes the peaks to 5 bit waveform values.
+[[nodiscard]] VoiceWaveform WaveformFromPeaks(const QVector<uint16> &peaks);
+
 } // namespace Audio
 } // namespace Media
@@ -170,7 +170,7 @@ struct Instance::Inner::Private {
 	int64 waveformMod = 0;
 	int64 waveformEach = (kCaptureFrequency / 100);
 	uint16 waveformPeak = 0;
-	QVector<uchar> waveform;
+	QVector<uint16> waveform;
 
 	static int _read_data(void *opaque, uint8_t *buf, int buf_size) {
 		auto l = reinterpret_cast<Private*>(opaque);
@@ -455,32 +455,13 @@ void Instance::Inner::stop(Fn<void(Result&&)> callback) {
 	VoiceWaveform waveform;
 	qint32 samples = d->fullSamples;
 	if (needResult && samples && !d->waveform.isEmpty()) {
-		int64 count = d->waveform.size(), sum = 0;
+		const auto count = int64(d->waveform.size());
 		if (count >= Player::kWaveformSamplesCount) {
-			QVector<uint16> peaks;
-			peaks.reserve(Player::kWaveformSamplesCount);
-
-			uint16 peak = 0;
-			for (int32 i = 0; i < count; ++i) {
-				uint16 sample = uint16(d->waveform.at(i)) * 256;
-				if (peak < sample) {
-					peak = sample;
-				}
-				sum += Player::kWaveformSamplesCount;
-				if (sum >= count) {
-					sum -= count;
-					peaks.push_back(peak);
-					peak = 0;
-				}
-			}
-
-			auto sum = std::accumulate(peaks.cbegin(), peaks.cend(), 0LL);
-			peak = qMax(int32(sum * 1.8 / peaks.size()), 2500);
-
-			waveform.resize(peaks.size());
-			for (int32 i = 0, l = peaks.size(); i != l; ++i) {
-				waveform[i] = char(qMin(31U, uint32(qMin(peaks.at(i), peak)) * 31 / peak));
-			}
+			auto counter = Audio::PeaksCounter(
+				count,
+				Player::kWaveformSamplesCount);
+			counter.add(gsl::make_span(std::as_const(d->waveform)));
+			waveform = Audio::WaveformFromPeaks(counter.finish());
 		}
 	}
 	if (hadDevice) {
@@ -643,14 +624,23 @@ bool Instance::Inner::processFrame(int32 offset, int32 framesize) {
 	}
 
 	d->waveform.reserve(d->waveform.size() + (samplesCnt / d->waveformEach) + 1);
-	for (short *ptr = srcSamplesDataChannel, *end = ptr + samplesCnt; ptr != end; ++ptr) {
-		uint16 value = qAbs(*ptr);
-		if (d->waveformPeak < value) {
-			d->waveformPeak = value;
-		}
-		if (++d->waveformMod == d->waveformEach) {
+	auto waveformSamples = gsl::make_span(
+		reinterpret_cast<const int16*>(srcSamplesDataChannel),
+		samplesCnt);
+	while (!waveformSamples.empty()) {
+		const auto count = std::min(
+			int64(waveformSamples.size()),
+			d->waveformEach - d->waveformMod);
+		accumulate_max(
+			d->waveformPeak,
+			Audio::MaxAmplitude(waveformSamples.subspan(0, count)));
+		waveformSamples = waveformSamples.subspan(count);
+		d->waveformMod += count;
+		if (d->waveformMod == d->waveformEach) {
 			d->waveformMod -= d->waveformEach;
-			d->waveform.push_back(uchar(d->waveformPeak / 256));
+
+			// Keep only the high byte, like it was always stored.
+			d->waveform.push_back(uint16(d->waveformPeak & 0xFF00));
 			d->waveformPeak = 0;
 		}
 	}
@@ -173,12 +173,19 @@ ReaderImplementation::ReadResult FFMpegReaderImplementation::readFramesTill(crl:
 		return readResult;
 	}
 	readResult = readNextFrame();
+	if (readResult == ReadResult::Success) {
+		++_skippedFrames;
+	}
 	if (_frameTime <= frameMs) {
 		_frameTime = frameMs + 5; // keep up
 	}
 	return readResult;
 }
 
+int FFMpegReaderImplementation::takeSkippedFrames() {
+	return base::take(_skippedFrames);
+}
+
 crl::time FFMpegReaderImplementation::frameRealTime() const {
 	return _frameMs;
 }
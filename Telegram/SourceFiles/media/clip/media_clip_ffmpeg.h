@@ -29,6 +29,7 @@ public:
 	FFMpegReaderImplementation(Core::FileLocation *location, QByteArray *data);
 
 	ReadResult readFramesTill(crl::time frameMs, crl::time systemMs) override;
+	int takeSkippedFrames() override;
 
 	crl::time frameRealTime() const override;
 	crl::time framePresentationTime() const override;
@@ -107,6 +108,7 @@ private:
 
 	crl::time _frameTime = 0;
 	crl::time _frameTimeCorrection = 0;
+	int _skippedFrames = 0;
 
 };
 
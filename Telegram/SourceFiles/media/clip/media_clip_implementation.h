@@ -37,6 +37,9 @@ public:
 	// Read frames till current frame will have presentation time > frameMs, systemMs = crl::now().
 	virtual ReadResult readFramesTill(crl::time frameMs, crl::time systemMs) = 0;
 
+	// Count of frames read, but skipped to keep up, since the last call.
+	virtual int takeSkippedFrames() = 0;
+
 	// Get current frame real and presentation time.
 	virtual crl::time frameRealTime() const = 0;
 	virtual crl::time framePresentationTime() const = 0;
@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "media/clip/media_clip_ffmpeg.h"
 #include "media/clip/media_clip_check_streaming.h"
+#include "media/streaming/media_streaming_statistics.h"
 #include "core/file_location.h"
 #include "base/random.h"
 #include "base/invoke_queued.h"
@@ -530,6 +531,8 @@ public:
 
 	ProcessResult finishProcess(crl::time ms) {
 		auto frameMs = _seekPositionMs + ms - _animationStarted;
+		const auto delay = ms - _nextFrameWhen;
+		const auto decodeStarted = crl::profile();
 		auto readResult = _implementation->readFramesTill(frameMs, ms);
 		if (readResult == internal::ReaderImplementation::ReadResult::EndOfFile) {
 			stop();
@@ -538,6 +541,10 @@ public:
 		} else if (readResult == internal::ReaderImplementation::ReadResult::Error) {
 			return error();
 		}
+		_statistics.frameDecoded(crl::profile() - decodeStarted);
+		if (const auto skipped = _implementation->takeSkippedFrames()) {
+			_statistics.framesDropped(skipped);
+		}
 		_nextFramePositionMs = _implementation->frameRealTime();
 		_nextFrameWhen = _animationStarted + _implementation->framePresentationTime();
 		if (_nextFrameWhen > _seekPositionMs) {
@@ -546,9 +553,12 @@ public:
 			_nextFrameWhen = 1;
 		}
 
+		const auto convertStarted = crl::profile();
 		if (!renderFrame()) {
 			return error();
 		}
+		_statistics.frameConverted(crl::profile() - convertStarted);
+		_statistics.frameShown(delay);
 		return ProcessResult::CopyFrame;
 	}
 
@@ -622,6 +632,12 @@ public:
 	~ReaderPrivate() {
 		stop();
 		_data.clear();
+
+		const auto values = _statistics.values();
+		if (values.decoded) {
+			DEBUG_LOG(("Clip Statistics: %1"
+				).arg(Streaming::Statistics::Serialize(values)));
+		}
 	}
 
 private:
@@ -664,6 +680,8 @@ private:
 	bool _started = false;
 	crl::time _videoPausedAtMs = 0;
 
+	Streaming::Statistics _statistics;
+
 	friend class Manager;
 
 };
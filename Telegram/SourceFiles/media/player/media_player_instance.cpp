@@ -8,7 +8,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/player/media_player_instance.h"
 
 #include "data/data_document.h"
+#include "data/data_document_media.h"
 #include "data/data_session.h"
+#include "data/data_histories.h"
 #include "data/data_changes.h"
 #include "data/data_streaming.h"
 #include "data/data_file_click_handler.h"
@@ -51,6 +53,10 @@ constexpr auto kRememberShuffledOrderItems = 16;
 
 constexpr auto kMinLengthForSavePosition = 20 * TimeId(60); // 20 minutes.
 
+// Only this much of the next track is loaded in advance, so that it
+// starts without waiting for the network. It is not decoded ahead.
+constexpr auto kPrefetchNextHeadBytes = 1024 * 1024;
+
 auto VoicePlaybackSpeed() {
 	return std::clamp(Core::App().settings().voicePlaybackSpeed(), 0.6, 1.7);
 }
@@ -69,6 +75,11 @@ struct Instance::Streamed {
 	rpl::lifetime lifetime;
 };
 
+struct Instance::PrefetchedHead {
+	AudioMsgId id;
+	std::shared_ptr<Streaming::Document> shared;
+};
+
 struct Instance::ShuffleData {
 	using UniversalMsgId = MsgId;
 
@@ -219,6 +230,7 @@ void Instance::setCurrent(const AudioMsgId &audioId) {
 		} else {
 			data->history = nullptr;
 			data->migrated = nullptr;
+			data->messagesHold.destroy();
 			data->session = nullptr;
 		}
 		_trackChanged.fire_copy(data->type);
@@ -230,9 +242,15 @@ void Instance::setHistory(not_null<Data*> data, History *history) {
 	if (history) {
 		data->history = history->migrateToOrMe();
 		data->migrated = data->history->migrateFrom();
+
+		// The playlist messages are kept to switch the tracks.
+		data->messagesHold = ::Data::HoldMessages(
+			data->history,
+			data->migrated);
 		setSession(data, &history->session());
 	} else {
 		data->history = data->migrated = nullptr;
+		data->messagesHold.destroy();
 		setSession(data, nullptr);
 	}
 }
@@ -275,6 +293,11 @@ void Instance::clearStreamed(not_null<Data*> data, bool savePosition) {
 	data->isPlaying = false;
 	requestRoundVideoResize();
 	emitUpdate(data->type);
+	if (data->type == AudioMsgId::Type::Song) {
+		// Keep the loaded parts for a while for a quick seek back.
+		const auto document = data->streamed->id.audio();
+		document->owner().streaming().keepAlive(document);
+	}
 	data->streamed = nullptr;
 
 	_roundPlaying = false;
@@ -312,6 +335,7 @@ void Instance::playlistUpdated(not_null<Data*> data) {
 		data->playlistIndex = std::nullopt;
 		data->shuffleData = nullptr;
 	}
+	prefetchNextHead(data);
 	data->playlistChanges.fire({});
 }
 
@@ -545,6 +569,16 @@ bool Instance::moveInPlaylist(
 		return byUniversal(raw->nonPlayedIds[index]);
 	}
 
+	if (const auto item = itemInPlaylist(data, delta)) {
+		return jumpByItem(item);
+	}
+	return false;
+}
+
+HistoryItem *Instance::itemInPlaylist(not_null<Data*> data, int delta) {
+	Expects(data->playlistIndex.has_value());
+
+	const auto repeatAll = (repeat(data) == RepeatMode::All);
 	const auto newIndex = *data->playlistIndex
 		+ (order(data) == OrderMode::Reverse ? -delta : delta);
 	const auto useIndex = (!repeatAll
@@ -556,18 +590,80 @@ bool Instance::moveInPlaylist(
 		: ((newIndex + int(data->playlistSlice->size()))
 			% int(data->playlistSlice->size()));
 	if (const auto item = itemByIndex(data, useIndex)) {
-		return jumpByItem(item);
+		return item;
 	} else if (repeatAll
 		&& data->playlistOtherSlice
 		&& data->playlistOtherSlice->size() > 0) {
 		const auto &other = *data->playlistOtherSlice;
 		if (newIndex < 0 && other.skippedAfter() == 0) {
-			return jumpById(other[other.size() - 1]);
+			return data->history->owner().message(other[other.size() - 1]);
 		} else if (newIndex > 0 && other.skippedBefore() == 0) {
-			return jumpById(other[0]);
+			return data->history->owner().message(other[0]);
 		}
 	}
-	return false;
+	return nullptr;
+}
+
+void Instance::prefetchNextHead(not_null<Data*> data) {
+	if (data->type != AudioMsgId::Type::Song
+		|| !data->streamed
+		|| !data->playlistIndex
+		|| !data->history
+		|| repeat(data) == RepeatMode::One
+		|| order(data) == OrderMode::Shuffle) {
+		return;
+	}
+	const auto item = itemInPlaylist(data, 1);
+	const auto media = item ? item->media() : nullptr;
+	const auto document = media ? media->document() : nullptr;
+	if (!document || !document->isAudioFile()) {
+		return;
+	}
+	const auto id = AudioMsgId(document, item->fullId());
+	if (data->prefetched
+		&& data->prefetched->id.audio() == id.audio()
+		&& data->prefetched->id.contextId() == id.contextId()) {
+		return;
+	}
+	clearPrefetched(data);
+
+	// Open the shared streaming reader of the next track in advance and
+	// load its first bytes. The track is still opened and decoded from
+	// scratch when it starts, so the switch is not gapless.
+	auto &streaming = document->owner().streaming();
+	const auto reader = streaming.sharedReader(document, item->fullId());
+	auto shared = reader
+		? streaming.sharedDocument(document, item->fullId())
+		: nullptr;
+	if (!shared) {
+		return;
+	}
+	if (reader->isRemoteLoader()) {
+		reader->preloadHead(kPrefetchNextHeadBytes);
+	}
+	data->prefetched = std::make_unique<PrefetchedHead>(PrefetchedHead{
+		.id = id,
+		.shared = std::move(shared),
+	});
+}
+
+void Instance::clearPrefetched(not_null<Data*> data) {
+	// The reader stops loading when the last reference is dropped.
+	data->prefetched = nullptr;
+}
+
+std::shared_ptr<Streaming::Document> Instance::takePrefetched(
+		const AudioMsgId &audioId) {
+	const auto data = getData(audioId.type());
+	if (!data
+		|| !data->prefetched
+		|| data->prefetched->id.audio() != audioId.audio()
+		|| data->prefetched->id.contextId() != audioId.contextId()) {
+		return nullptr;
+	}
+
+	// The parts loaded in advance are read by the playing track player.
+	return base::take(data->prefetched)->shared;
 }
 
 void Instance::updatePowerSaveBlocker(
@@ -756,9 +852,12 @@ void Instance::play(const AudioMsgId &audioId) {
 	if (document->isAudioFile()
 		|| document->isVoiceMessage()
 		|| document->isVideoMessage()) {
-		auto shared = document->owner().streaming().sharedDocument(
-			document,
-			audioId.contextId());
+		auto shared = takePrefetched(audioId);
+		if (!shared) {
+			shared = document->owner().streaming().sharedDocument(
+				document,
+				audioId.contextId());
+		}
 		if (!shared) {
 			return;
 		}
@@ -789,6 +888,7 @@ void Instance::playStreamed(
 	Assert(data != nullptr);
 
 	clearStreamed(data, data->current.audio() != audioId.audio());
+	clearPrefetched(data);
 	data->streamed = std::make_unique<Streamed>(
 		audioId,
 		std::move(shared));
@@ -853,6 +953,7 @@ void Instance::stop(AudioMsgId::Type type) {
 
 void Instance::stopAndClear(not_null<Data*> data) {
 	stop(data->type);
+	clearPrefetched(data);
 	*data = Data(data->type, data->overview);
 	_tracksFinished.fire_copy(data->type);
 }
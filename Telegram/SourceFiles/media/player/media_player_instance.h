@@ -172,6 +172,7 @@ private:
 	using SliceKey = SparseIdsMergedSlice::Key;
 	struct Streamed;
 	struct ShuffleData;
+	struct PrefetchedHead;
 	struct Data {
 		Data(AudioMsgId::Type type, SharedMediaType overview);
 		Data(Data &&other);
@@ -194,10 +195,12 @@ private:
 		rpl::event_stream<> playlistChanges;
 		History *history = nullptr;
 		History *migrated = nullptr;
+		rpl::lifetime messagesHold;
 		Main::Session *session = nullptr;
 		bool isPlaying = false;
 		bool resumeOnCallEnd = false;
 		std::unique_ptr<Streamed> streamed;
+		std::unique_ptr<PrefetchedHead> prefetched;
 		std::unique_ptr<ShuffleData> shuffleData;
 		std::unique_ptr<base::PowerSaveBlocker> powerSaveBlocker;
 		std::unique_ptr<base::PowerSaveBlocker> powerSaveBlockerVideo;
@@ -244,6 +247,14 @@ private:
 		not_null<Data*> data,
 		const TrackState &state);
 	HistoryItem *itemByIndex(not_null<Data*> data, int index);
+	HistoryItem *itemInPlaylist(not_null<Data*> data, int delta);
+
+	// Called when the track or the playlist changes. Prefetches the first
+	// megabyte of the next track, nothing is decoded in advance.
+	void prefetchNextHead(not_null<Data*> data);
+	void clearPrefetched(not_null<Data*> data);
+	[[nodiscard]] std::shared_ptr<Streaming::Document> takePrefetched(
+		const AudioMsgId &audioId);
 	void stopAndClear(not_null<Data*> data);
 
 	[[nodiscard]] MsgId computeCurrentUniversalId(
@@ -68,11 +68,15 @@ int File::Context::read(bytes::span buffer) {
 	}
 
 	buffer = buffer.subspan(0, amount);
+	auto waitingStarted = std::optional<crl::profile_time>();
 	while (true) {
 		const auto result = _reader->fill(_offset, buffer, &_semaphore);
 		if (result == Reader::FillState::Success) {
 			break;
-		} else if (result == Reader::FillState::WaitingRemote) {
+		} else if (!waitingStarted) {
+			waitingStarted = crl::profile();
+		}
+		if (result == Reader::FillState::WaitingRemote) {
 			// Perhaps for the correct sleeping in case of enough packets
 			// being read already we require SleepPolicy::Allowed here.
 			// Otherwise if we wait for the remote frequently and
@@ -93,6 +97,9 @@ int File::Context::read(bytes::span buffer) {
 		}
 	}
 
+	if (waitingStarted) {
+		_delegate->fileWaitedForData(crl::profile() - *waitingStarted);
+	}
 	sendFullInCache();
 
 	_offset += amount;
@@ -26,6 +26,7 @@ public:
 		Stream &&audio) = 0;
 	virtual void fileError(Error error) = 0;
 	virtual void fileWaitingForData() = 0;
+	virtual void fileWaitedForData(crl::profile_time duration) = 0;
 	virtual void fileFullInCache(bool fullInCache) = 0;
 
 	virtual void fileProcessEndOfFile() = 0;
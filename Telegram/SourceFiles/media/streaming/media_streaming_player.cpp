@@ -82,6 +82,7 @@ void SaveValidStartInformation(Information &to, Information &&from) {
 
 Player::Player(std::shared_ptr<Reader> reader)
 : _file(std::make_unique<File>(std::move(reader)))
+, _statistics(std::make_shared<Statistics>())
 , _remoteLoader(_file->isRemoteLoader())
 , _renderFrameTimer([=] { checkNextFrameRender(); }) {
 }
@@ -142,6 +143,10 @@ bool Player::markFrameShown() {
 	return _video->markFrameShown();
 }
 
+Statistics::Values Player::statistics() const {
+	return _statistics->values();
+}
+
 void Player::setLoaderPriority(int priority) {
 	_file->setLoaderPriority(priority);
 }
@@ -292,6 +297,7 @@ bool Player::fileReady(int headerSize, Stream &&video, Stream &&audio) {
 			_options,
 			std::move(video),
 			_audioId,
+			_statistics,
 			ready,
 			error);
 	} else if (video.index >= 0) {
@@ -350,6 +356,10 @@ void Player::fileWaitingForData() {
 	}
 }
 
+void Player::fileWaitedForData(crl::profile_time duration) {
+	_statistics->fillWaited(duration);
+}
+
 bool Player::fileProcessPackets(
 		base::flat_map<int, std::vector<FFmpeg::Packet>> &packets) {
 	_waitingForData = false;
@@ -793,6 +803,12 @@ void Player::stop(bool stillActive) {
 	_durationByPackets = 0;
 	_durationByLastAudioPacket = 0;
 	_durationByLastVideoPacket = 0;
+	const auto values = _statistics->values();
+	if (values.decoded || values.fillWaits) {
+		DEBUG_LOG(("Streaming Statistics: %1"
+			).arg(Statistics::Serialize(values)));
+		_statistics = std::make_shared<Statistics>();
+	}
 	const auto header = _information.headerSize;
 	_information = Information();
 	_information.headerSize = header;
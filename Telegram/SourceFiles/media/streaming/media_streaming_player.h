@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "media/streaming/media_streaming_common.h"
 #include "media/streaming/media_streaming_file_delegate.h"
+#include "media/streaming/media_streaming_statistics.h"
 #include "base/weak_ptr.h"
 #include "base/timer.h"
 
@@ -75,6 +76,8 @@ public:
 	void unregisterInstance(not_null<const Instance*> instance);
 	bool markFrameShown();
 
+	[[nodiscard]] Statistics::Values statistics() const;
+
 	void setLoaderPriority(int priority);
 
 	[[nodiscard]] Media::Player::TrackState prepareLegacyState() const;
@@ -103,6 +106,7 @@ private:
 	bool fileReady(int headerSize, Stream &&video, Stream &&audio) override;
 	void fileError(Error error) override;
 	void fileWaitingForData() override;
+	void fileWaitedForData(crl::profile_time duration) override;
 	void fileFullInCache(bool fullInCache) override;
 	bool fileProcessPackets(
 		base::flat_map<int, std::vector<FFmpeg::Packet>> &packets) override;
@@ -166,6 +170,9 @@ private:
 
 	const std::unique_ptr<File> _file;
 
+	// Recreated in stop(), tracks keep the previous one alive.
+	std::shared_ptr<Statistics> _statistics;
+
 	// Immutable while File is active after it is ready.
 	AudioMsgId _audioId;
 	std::unique_ptr<AudioTrack> _audio;
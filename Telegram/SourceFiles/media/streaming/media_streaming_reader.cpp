@@ -905,6 +905,22 @@ void Reader::startStreaming() {
 	refreshLoaderPriority();
 }
 
+void Reader::preloadHead(int till) {
+	Expects(_sleeping == nullptr);
+
+	if (_streamingActive) {
+		// It is being read already, the loading is driven by the reads.
+		return;
+	}
+
+	// The parts are queued as they come and the first fill() takes them.
+	startStreaming();
+	const auto limit = std::min(till, size());
+	for (auto offset = 0; offset < limit; offset += kPartSize) {
+		loadAtOffset(offset);
+	}
+}
+
 void Reader::stopStreaming(bool stillActive) {
 	Expects(_sleeping == nullptr);
 
@@ -69,6 +69,9 @@ public:
 
 	// Main thread.
 	void startStreaming();
+
+	// Main thread, before the reader is used by a player.
+	void preloadHead(int till);
 	void stopStreaming(bool stillActive = false);
 	[[nodiscard]] rpl::producer<LoadedPart> partsForDownloader() const;
 	void loadForDownloader(
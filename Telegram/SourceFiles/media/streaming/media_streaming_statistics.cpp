@@ -0,0 +1,110 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "media/streaming/media_streaming_statistics.h"
+
+namespace Media {
+namespace Streaming {
+namespace {
+
+// Shown frames delayed more than that after their deadline are late.
+constexpr auto kLateFrameDelay = crl::time(8);
+
+[[nodiscard]] QString Average(int64 total, int count, int64 divider) {
+	return count
+		? QString::number(total / float64(count * divider), 'f', 2)
+		: u"-"_q;
+}
+
+} // namespace
+
+void Statistics::frameDecoded(crl::profile_time duration) {
+	_decoded.fetch_add(1, std::memory_order_relaxed);
+	_decodeTime.fetch_add(duration, std::memory_order_relaxed);
+}
+
+void Statistics::frameConverted(crl::profile_time duration) {
+	_converted.fetch_add(1, std::memory_order_relaxed);
+	_convertTime.fetch_add(duration, std::memory_order_relaxed);
+}
+
+void Statistics::frameShown(crl::time delay) {
+	_shown.fetch_add(1, std::memory_order_relaxed);
+	if (delay > kLateFrameDelay) {
+		_late.fetch_add(1, std::memory_order_relaxed);
+		_lateTime.fetch_add(delay, std::memory_order_relaxed);
+	}
+}
+
+void Statistics::framesDropped(int count) {
+	_dropped.fetch_add(count, std::memory_order_relaxed);
+}
+
+void Statistics::bufferUnderrun() {
+	_underruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Statistics::fillWaited(crl::profile_time duration) {
+	_fillWaits.fetch_add(1, std::memory_order_relaxed);
+	_fillWaitTime.fetch_add(duration, std::memory_order_relaxed);
+}
+
+auto Statistics::values() const -> Values {
+	return {
+		.decoded = _decoded.load(std::memory_order_relaxed),
+		.decodeTime = _decodeTime.load(std::memory_order_relaxed),
+		.converted = _converted.load(std::memory_order_relaxed),
+		.convertTime = _convertTime.load(std::memory_order_relaxed),
+		.shown = _shown.load(std::memory_order_relaxed),
+		.late = _late.load(std::memory_order_relaxed),
+		.lateTime = _lateTime.load(std::memory_order_relaxed),
+		.dropped = _dropped.load(std::memory_order_relaxed),
+		.underruns = _underruns.load(std::memory_order_relaxed),
+		.fillWaits = _fillWaits.load(std::memory_order_relaxed),
+		.fillWaitTime = _fillWaitTime.load(std::memory_order_relaxed),
+	};
+}
+
+QString Statistics::Serialize(const Values &values) {
+	return u"decoded=%1 decode_us=%2 converted=%3 convert_us=%4 "
+		"shown=%5 late=%6 late_ms=%7 dropped=%8 underruns=%9 "
+		"fill_waits=%10 fill_wait_us=%11"_q
+		.arg(values.decoded)
+		.arg(values.decodeTime)
+		.arg(values.converted)
+		.arg(values.convertTime)
+		.arg(values.shown)
+		.arg(values.late)
+		.arg(values.lateTime)
+		.arg(values.dropped)
+		.arg(values.underruns)
+		.arg(values.fillWaits)
+		.arg(values.fillWaitTime);
+}
+
+QString Statistics::Format(const Values &values) {
+	return QStringList{
+		u"decode: %1 ms x %2"_q.arg(
+			Average(values.decodeTime, values.decoded, 1000)
+		).arg(values.decoded),
+		u"convert: %1 ms x %2"_q.arg(
+			Average(values.convertTime, values.converted, 1000)
+		).arg(values.converted),
+		u"shown: %1, late: %2 (%3 ms), dropped: %4"_q.arg(
+			values.shown
+		).arg(values.late
+		).arg(Average(values.lateTime, values.late, 1)
+		).arg(values.dropped),
+		u"underruns: %1, data waits: %2 (%3 ms)"_q.arg(
+			values.underruns
+		).arg(values.fillWaits
+		).arg(Average(values.fillWaitTime, values.fillWaits, 1000)),
+	}.join('\n');
+}
+
+} // namespace Streaming
+} // namespace Media
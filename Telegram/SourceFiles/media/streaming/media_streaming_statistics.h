@@ -0,0 +1,67 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <crl/crl_time.h>
+
+namespace Media {
+namespace Streaming {
+
+// Playback counters, written from the reading and decoding threads
+// and read from the main thread. All the methods are thread-safe.
+//
+// Decode, convert and fill wait times are in microseconds,
+// display delays are in milliseconds.
+class Statistics final {
+public:
+	struct Values {
+		int decoded = 0;
+		int64 decodeTime = 0;
+		int converted = 0;
+		int64 convertTime = 0;
+		int shown = 0;
+		int late = 0;
+		int64 lateTime = 0;
+		int dropped = 0;
+		int underruns = 0;
+		int fillWaits = 0;
+		int64 fillWaitTime = 0;
+	};
+
+	void frameDecoded(crl::profile_time duration);
+	void frameConverted(crl::profile_time duration);
+	void frameShown(crl::time delay);
+	void framesDropped(int count = 1);
+	void bufferUnderrun();
+	void fillWaited(crl::profile_time duration);
+
+	[[nodiscard]] Values values() const;
+
+	// Single line of space separated key=value pairs for the logs.
+	[[nodiscard]] static QString Serialize(const Values &values);
+
+	// Several short lines with average values for the debug overlay.
+	[[nodiscard]] static QString Format(const Values &values);
+
+private:
+	std::atomic<int> _decoded = 0;
+	std::atomic<int64> _decodeTime = 0;
+	std::atomic<int> _converted = 0;
+	std::atomic<int64> _convertTime = 0;
+	std::atomic<int> _shown = 0;
+	std::atomic<int> _late = 0;
+	std::atomic<int64> _lateTime = 0;
+	std::atomic<int> _dropped = 0;
+	std::atomic<int> _underruns = 0;
+	std::atomic<int> _fillWaits = 0;
+	std::atomic<int64> _fillWaitTime = 0;
+
+};
+
+} // namespace Streaming
+} // namespace Media
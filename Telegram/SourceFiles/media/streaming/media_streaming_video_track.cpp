@@ -82,6 +82,7 @@ public:
 		not_null<Shared*> shared,
 		Stream &&stream,
 		const AudioMsgId &audioId,
+		std::shared_ptr<Statistics> statistics,
 		FnMut<void(const Information &)> ready,
 		Fn<void(Error)> error);
 
@@ -149,7 +150,9 @@ private:
 
 	Stream _stream;
 	AudioMsgId _audioId;
+	const std::shared_ptr<Statistics> _statistics;
 	bool _readTillEnd = false;
+	bool _underrun = false;
 	FnMut<void(const Information &)> _ready;
 	Fn<void(Error)> _error;
 	crl::time _pausedTime = kTimeUnknown;
@@ -176,6 +179,7 @@ VideoTrackObject::VideoTrackObject(
 	not_null<Shared*> shared,
 	Stream &&stream,
 	const AudioMsgId &audioId,
+	std::shared_ptr<Statistics> statistics,
 	FnMut<void(const Information &)> ready,
 	Fn<void(Error)> error)
 : _weak(std::move(weak))
@@ -183,6 +187,7 @@ VideoTrackObject::VideoTrackObject(
 , _shared(shared)
 , _stream(std::move(stream))
 , _audioId(audioId)
+, _statistics(std::move(statistics))
 , _ready(std::move(ready))
 , _error(std::move(error))
 , _readFramesTimer(_weak, [=] { readFrames(); }) {
@@ -315,6 +320,7 @@ auto VideoTrackObject::readEnoughFrames(crl::time trackTime)
 				|| !VideoTrack::IsStale(frame, trackTime)) {
 				return v::null;
 			}
+			_statistics->framesDropped();
 		}
 	}, [&](Shared::PrepareNextCheck delay) -> ReadEnoughState {
 		return delay;
@@ -348,6 +354,7 @@ crl::time VideoTrackObject::computeDuration() const {
 }
 
 auto VideoTrackObject::readFrame(not_null<Frame*> frame) -> FrameResult {
+	const auto decodeStarted = crl::profile();
 	if (const auto error = ReadNextFrame(_stream)) {
 		if (error.code() == AVERROR_EOF) {
 			if (!_options.loop) {
@@ -365,9 +372,15 @@ auto VideoTrackObject::readFrame(not_null<Frame*> frame) -> FrameResult {
 			return FrameResult::Error;
 		}
 		Assert(_stream.queue.empty());
+		if (!_underrun) {
+			_underrun = true;
+			_statistics->bufferUnderrun();
+		}
 		_waitingForData.fire({});
 		return FrameResult::Waiting;
 	}
+	_underrun = false;
+	_statistics->frameDecoded(crl::profile() - decodeStarted);
 	const auto position = currentFramePosition();
 	if (position == kTimeUnknown) {
 		fail(Error::InvalidData);
@@ -425,6 +438,7 @@ bool VideoTrackObject::requireARGB32() const {
 void VideoTrackObject::rasterizeFrame(not_null<Frame*> frame) {
 	Expects(frame->position != kFinishedPosition);
 
+	const auto convertStarted = crl::profile();
 	fillRequests(frame);
 	frame->format = FrameFormat::None;
 	if (frame->decoded->format == AV_PIX_FMT_YUV420P && !requireARGB32()) {
@@ -467,6 +481,7 @@ void VideoTrackObject::rasterizeFrame(not_null<Frame*> frame) {
 	}
 
 	VideoTrack::PrepareFrameByRequests(frame, _stream.rotation);
+	_statistics->frameConverted(crl::profile() - convertStarted);
 
 	Ensures(VideoTrack::IsRasterized(frame));
 }
@@ -709,6 +724,10 @@ void VideoTrackObject::fail(Error error) {
 	_error(error);
 }
 
+VideoTrack::Shared::Shared(not_null<Statistics*> statistics)
+: _statistics(statistics) {
+}
+
 void VideoTrack::Shared::init(
 		QImage &&cover,
 		bool hasAlpha,
@@ -768,6 +787,7 @@ auto VideoTrack::Shared::prepareState(
 		} else if (IsStale(frame, trackTime)) {
 			std::swap(*frame, *next);
 			next->displayed = kDisplaySkipped;
+			_statistics->framesDropped();
 			return next;
 		} else {
 			if (frame->position - trackTime + 1 <= 0) { // Debugging crash.
@@ -909,6 +929,7 @@ crl::time VideoTrack::Shared::markFrameDisplayed(crl::time now) {
 		Assert(frame->position != kTimeUnknown);
 		if (frame->displayed == kTimeUnknown) {
 			frame->displayed = now;
+			_statistics->frameShown(now - frame->display);
 		}
 		return frame->position;
 	};
@@ -1004,6 +1025,7 @@ VideoTrack::VideoTrack(
 	const PlaybackOptions &options,
 	Stream &&stream,
 	const AudioMsgId &audioId,
+	std::shared_ptr<Statistics> statistics,
 	FnMut<void(const Information &)> ready,
 	Fn<void(Error)> error)
 : _streamIndex(stream.index)
@@ -1011,12 +1033,14 @@ VideoTrack::VideoTrack(
 , _streamDuration(stream.duration)
 , _streamRotation(stream.rotation)
 //, _streamAspect(stream.aspect)
-, _shared(std::make_unique<Shared>())
+, _statistics(std::move(statistics))
+, _shared(std::make_unique<Shared>(_statistics.get()))
 , _wrapped(
 	options,
 	_shared.get(),
 	std::move(stream),
 	audioId,
+	_statistics,
 	std::move(ready),
 	std::move(error)) {
 }
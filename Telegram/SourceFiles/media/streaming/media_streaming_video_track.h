@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "media/streaming/media_streaming_utility.h"
+#include "media/streaming/media_streaming_statistics.h"
 
 #include <crl/crl_object_on_queue.h>
 
@@ -28,6 +29,7 @@ public:
 		const PlaybackOptions &options,
 		Stream &&stream,
 		const AudioMsgId &audioId,
+		std::shared_ptr<Statistics> statistics,
 		FnMut<void(const Information &)> ready,
 		Fn<void(Error)> error);
 
@@ -113,6 +115,8 @@ private:
 			crl::time addedWorldTimeDelay = 0;
 		};
 
+		explicit Shared(not_null<Statistics*> statistics);
+
 		// Called from the wrapped object queue.
 		void init(QImage &&cover, bool hasAlpha, crl::time position);
 		[[nodiscard]] bool initialized() const;
@@ -152,6 +156,8 @@ private:
 		// (_counter % 2) == 0 crl::queue can read _delay.
 		crl::time _delay = kTimeUnknown;
 
+		const not_null<Statistics*> _statistics;
+
 	};
 
 	static void PrepareFrameByRequests(not_null<Frame*> frame, int rotation);
@@ -171,6 +177,7 @@ private:
 	const crl::time _streamDuration = 0;
 	const int _streamRotation = 0;
 	//AVRational _streamAspect = kNormalAspect;
+	const std::shared_ptr<Statistics> _statistics;
 	std::unique_ptr<Shared> _shared;
 
 	using Implementation = VideoTrackObject;
@@ -132,6 +132,8 @@ void OverlayWidget::RendererGL::deinit(
 		not_null<QOpenGLWidget*> widget,
 		QOpenGLFunctions *f) {
 	_textures.destroy(f);
+	_detailCacheKey = 0;
+	_detailSize = QSize();
 	_imageProgram = std::nullopt;
 	_texturedVertexShader = nullptr;
 	_withTransparencyProgram = std::nullopt;
@@ -316,6 +318,36 @@ void OverlayWidget::RendererGL::paintTransformedStaticContent(
 	paintTransformedContent(&*program, geometry);
 }
 
+void OverlayWidget::RendererGL::paintStaticContentDetail(
+		const QImage &image,
+		QRectF rect) {
+	Expects(image.format() == QImage::Format_ARGB32_Premultiplied);
+
+	if (rect.isEmpty()) {
+		return;
+	}
+	_imageProgram->bind();
+
+	_f->glActiveTexture(GL_TEXTURE0);
+	_textures.bind(*_f, 4);
+	const auto cacheKey = image.cacheKey();
+	if (_detailCacheKey != cacheKey) {
+		_detailCacheKey = cacheKey;
+		uploadTexture(
+			Ui::GL::kFormatRGBA,
+			Ui::GL::kFormatRGBA,
+			image.size(),
+			_detailSize,
+			image.bytesPerLine() / 4,
+			image.constBits());
+		_detailSize = image.size();
+	}
+	_imageProgram->setUniformValue("s_texture", GLint(0));
+
+	toggleBlending(true);
+	paintTransformedContent(&*_imageProgram, { rect, 0. });
+}
+
 void OverlayWidget::RendererGL::paintTransformedContent(
 		not_null<QOpenGLShaderProgram*> program,
 		ContentGeometry geometry) {
@@ -47,6 +47,9 @@ private:
 		ContentGeometry geometry,
 		bool semiTransparent,
 		bool fillTransparentBackground) override;
+	void paintStaticContentDetail(
+		const QImage &image,
+		QRectF rect) override;
 	void paintTransformedContent(
 		not_null<QOpenGLShaderProgram*> program,
 		ContentGeometry geometry);
@@ -109,11 +112,13 @@ private:
 	std::optional<QOpenGLShaderProgram> _yuv420Program;
 	std::optional<QOpenGLShaderProgram> _fillProgram;
 	std::optional<QOpenGLShaderProgram> _controlsProgram;
-	Ui::GL::Textures<4> _textures;
+	Ui::GL::Textures<5> _textures;
 	QSize _rgbaSize;
 	QSize _lumaSize;
 	QSize _chromaSize;
+	QSize _detailSize;
 	qint64 _cacheKey = 0;
+	qint64 _detailCacheKey = 0;
 	int _trackFrameIndex = 0;
 	int _streamedIndex = 0;
 
@@ -94,6 +94,16 @@ void OverlayWidget::RendererSW::paintTransformedStaticContent(
 	paintTransformedImage(image, rect, rotation);
 }
 
+void OverlayWidget::RendererSW::paintStaticContentDetail(
+		const QImage &image,
+		QRectF rect) {
+	if (!rect.toAlignedRect().intersects(_clipOuter)) {
+		return;
+	}
+	PainterHighQualityEnabler hq(*_p);
+	_p->drawImage(rect, image);
+}
+
 void OverlayWidget::RendererSW::paintTransformedImage(
 		const QImage &image,
 		QRect rect,
@@ -28,6 +28,9 @@ private:
 		ContentGeometry geometry,
 		bool semiTransparent,
 		bool fillTransparentBackground) override;
+	void paintStaticContentDetail(
+		const QImage &image,
+		QRectF rect) override;
 	void paintTransformedImage(
 		const QImage &image,
 		QRect rect,
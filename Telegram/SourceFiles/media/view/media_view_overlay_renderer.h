@@ -20,6 +20,9 @@ public:
 		ContentGeometry geometry,
 		bool semiTransparent,
 		bool fillTransparentBackground) = 0;
+	virtual void paintStaticContentDetail(
+		const QImage &image,
+		QRectF rect) = 0;
 	virtual void paintRadialLoading(
 		QRect inner,
 		bool radial,
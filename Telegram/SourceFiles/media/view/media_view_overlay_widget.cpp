@@ -21,6 +21,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/crash_reports.h"
 #include "ui/widgets/popup_menu.h"
 #include "ui/widgets/buttons.h"
+#include "ui/widgets/labels.h"
 #include "ui/image/image.h"
 #include "ui/text/text_utilities.h"
 #include "ui/platform/ui_platform_utility.h"
@@ -39,6 +40,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/view/media_view_pip.h"
 #include "media/view/media_view_overlay_raster.h"
 #include "media/view/media_view_overlay_opengl.h"
+#include "media/view/media_view_tiled_image.h"
 #include "media/streaming/media_streaming_instance.h"
 #include "media/streaming/media_streaming_player.h"
 #include "media/player/media_player_instance.h"
@@ -47,6 +49,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/view/media/history_view_media.h"
 #include "data/data_media_types.h"
 #include "data/data_session.h"
+#include "data/data_histories.h"
 #include "data/data_channel.h"
 #include "data/data_chat.h"
 #include "data/data_user.h"
@@ -100,6 +103,7 @@ constexpr auto kMaxZoomLevel = 7; // x8
 constexpr auto kZoomToScreenLevel = 1024;
 constexpr auto kOverlayLoaderPriority = 2;
 constexpr auto kSeekTimeMs = 5 * crl::time(1000);
+constexpr auto kStatisticsUpdateDelay = crl::time(1000);
 
 // macOS OpenGL renderer fails to render larger texture
 // even though it reports that max texture size is 16384.
@@ -231,6 +235,10 @@ struct OverlayWidget::Streamed {
 	PlaybackControls controls;
 	std::unique_ptr<base::PowerSaveBlocker> powerSaveBlocker;
 
+	// Shown only with the debug logs enabled.
+	object_ptr<Ui::FlatLabel> statistics = { nullptr };
+	crl::time statisticsUpdated = 0;
+
 	bool withSound = false;
 	bool pausedBySeek = false;
 	bool resumeOnCallEnd = false;
@@ -652,6 +660,17 @@ void OverlayWidget::setStaticContent(QImage image) {
 	_staticContentTransparent = IsSemitransparent(_staticContent);
 }
 
+void OverlayWidget::setTiledContent(std::unique_ptr<TiledImage> tiled) {
+	_tiledContentLifetime.destroy();
+	_tiledContent = std::move(tiled);
+	if (_tiledContent) {
+		_tiledContent->tileReady(
+		) | rpl::start_with_next([=] {
+			updateContentRect();
+		}, _tiledContentLifetime);
+	}
+}
+
 bool OverlayWidget::contentShown() const {
 	return _photo || documentContentShown();
 }
@@ -2389,6 +2408,7 @@ void OverlayWidget::displayPhoto(not_null<PhotoData*> photo) {
 	refreshMediaViewer();
 
 	_staticContent = QImage();
+	setTiledContent(nullptr);
 	if (_photo->videoCanBePlayed()) {
 		initStreaming();
 	}
@@ -2441,6 +2461,7 @@ void OverlayWidget::displayDocument(
 		bool continueStreaming) {
 	_fullScreenVideo = false;
 	_staticContent = QImage();
+	setTiledContent(nullptr);
 	clearStreaming(_document != doc);
 	destroyThemePreview();
 	assignMediaPointer(doc);
@@ -2482,6 +2503,9 @@ void OverlayWidget::displayDocument(
 						.path = location.name(),
 					}));
 					if (!_staticContent.isNull()) {
+						setTiledContent(TiledImage::Create(
+							{ .path = location.name() },
+							kMaxDisplayImageSize));
 						_touchbarDisplay.fire(TouchBarItemType::Photo);
 					}
 				} else {
@@ -2489,6 +2513,9 @@ void OverlayWidget::displayDocument(
 						.content = _documentMedia->bytes(),
 					}));
 					if (!_staticContent.isNull()) {
+						setTiledContent(TiledImage::Create(
+							{ .content = _documentMedia->bytes() },
+							kMaxDisplayImageSize));
 						_touchbarDisplay.fire(TouchBarItemType::Photo);
 					}
 				}
@@ -2548,8 +2575,8 @@ void OverlayWidget::displayDocument(
 	} else if (_themePreviewShown) {
 		updateThemePreviewGeometry();
 	} else if (!_staticContent.isNull()) {
-		const auto size = style::ConvertScale(
-			flipSizeByRotation(_staticContent.size()));
+		const auto size = style::ConvertScale(flipSizeByRotation(
+			_tiledContent ? _tiledContent->size() : _staticContent.size()));
 		_w = size.width();
 		_h = size.height();
 	} else if (videoShown()) {
@@ -2791,6 +2818,15 @@ bool OverlayWidget::createStreamingObjects() {
 		refreshClipControllerGeometry();
 		_streamed->controls.show();
 	// }
+	if (Logs::DebugEnabled()) {
+		_streamed->statistics.create(
+			_widget,
+			QString(),
+			st::mediaviewStatisticsLabel);
+		_streamed->statistics->setAttribute(Qt::WA_TransparentForMouseEvents);
+		_streamed->statistics->move(st::mediaviewStatisticsPosition);
+		_streamed->statistics->show();
+	}
 	return true;
 }
 
@@ -3288,6 +3324,23 @@ void OverlayWidget::updatePlaybackState() {
 		updatePowerSaveBlocker(state);
 		_touchbarTrackState.fire_copy(state);
 	}
+	updatePlaybackStatistics();
+}
+
+void OverlayWidget::updatePlaybackStatistics() {
+	Expects(_streamed != nullptr);
+
+	const auto label = _streamed->statistics.data();
+	const auto now = crl::now();
+	if (!label
+		|| now < _streamed->statisticsUpdated + kStatisticsUpdateDelay) {
+		return;
+	}
+	_streamed->statisticsUpdated = now;
+	label->setText(Streaming::Statistics::Format(
+		_streamed->instance.player().statistics()));
+	label->resizeToNaturalWidth(width());
+	label->raise();
 }
 
 void OverlayWidget::validatePhotoImage(Image *image, bool blurred) {
@@ -3363,6 +3416,9 @@ void OverlayWidget::paint(not_null<Renderer*> renderer) {
 				contentGeometry(),
 				_staticContentTransparent,
 				fillTransparentBackground);
+			if (_tiledContent) {
+				paintTiledContent(renderer);
+			}
 		}
 		paintRadialLoading(renderer);
 	} else {
@@ -3404,6 +3460,47 @@ void OverlayWidget::checkGroupThumbsAnimation() {
 	}
 }
 
+void OverlayWidget::paintTiledContent(not_null<Renderer*> renderer) {
+	Expects(_tiledContent != nullptr);
+
+	// Tiles are painted only over the settled, not rotated content.
+	const auto geometry = contentGeometry();
+	const auto full = geometry.rect;
+	if (_geometryAnimation.animating()
+		|| int(geometry.rotation) != 0
+		|| full.isEmpty()) {
+		return;
+	}
+	const auto factor = cIntRetinaFactor();
+	if (full.width() * factor <= _staticContent.width()) {
+		// The downscaled image has enough pixels for this zoom.
+		return;
+	}
+	const auto visible = full.intersected(QRectF(0, 0, width(), height()));
+	if (visible.isEmpty()) {
+		return;
+	}
+	const auto original = _tiledContent->size();
+	const auto scale = original.width() / full.width();
+	const auto region = QRectF(
+		(visible.x() - full.x()) * scale,
+		(visible.y() - full.y()) * scale,
+		visible.width() * scale,
+		visible.height() * scale
+	).toAlignedRect().intersected(QRect(QPoint(), original));
+	const auto rect = QRectF(
+		full.x() + region.x() / scale,
+		full.y() + region.y() / scale,
+		region.width() / scale,
+		region.height() / scale);
+	const auto image = _tiledContent->compose(
+		region,
+		(rect.size() * factor).toSize());
+	if (!image.isNull()) {
+		renderer->paintStaticContentDetail(image, rect);
+	}
+}
+
 void OverlayWidget::paintRadialLoading(not_null<Renderer*> renderer) {
 	const auto radial = _radial.animating();
 	if (_streamed) {
@@ -4063,6 +4160,9 @@ void OverlayWidget::setContext(
 		}
 	}
 	_user = _peer ? _peer->asUser() : nullptr;
+
+	// The shown messages and the shared media around them are kept.
+	_messagesHold = Data::HoldMessages(_history, _migrated);
 }
 
 void OverlayWidget::setSession(not_null<Main::Session*> session) {
@@ -4716,6 +4816,7 @@ void OverlayWidget::clearAfterHide() {
 	destroyThemePreview();
 	_radial.stop();
 	_staticContent = QImage();
+	setTiledContent(nullptr);
 	_themePreview = nullptr;
 	_themeApply.destroyDelayed();
 	_themeCancel.destroyDelayed();
@@ -57,6 +57,7 @@ namespace Media::View {
 
 class GroupThumbs;
 class Pip;
+class TiledImage;
 
 class OverlayWidget final
 	: public ClickHandlerHost
@@ -296,6 +297,7 @@ private:
 	void setZoomLevel(int newZoom, bool force = false);
 
 	void updatePlaybackState();
+	void updatePlaybackStatistics();
 	void seekRelativeTime(crl::time time);
 	void restartAtProgress(float64 progress);
 	void restartAtSeekPosition(crl::time position);
@@ -410,6 +412,8 @@ private:
 	[[nodiscard]] bool documentContentShown() const;
 	[[nodiscard]] bool documentBubbleShown() const;
 	void setStaticContent(QImage image);
+	void setTiledContent(std::unique_ptr<TiledImage> tiled);
+	void paintTiledContent(not_null<Renderer*> renderer);
 	[[nodiscard]] bool contentShown() const;
 	[[nodiscard]] bool opaqueContentShown() const;
 	void clearStreaming(bool savePosition = true);
@@ -478,6 +482,8 @@ private:
 	int32 _dragging = 0;
 	QImage _staticContent;
 	bool _staticContentTransparent = false;
+	std::unique_ptr<TiledImage> _tiledContent;
+	rpl::lifetime _tiledContentLifetime;
 	bool _blurred = true;
 
 	ContentGeometry _oldGeometry;
@@ -506,6 +512,7 @@ private:
 
 	History *_migrated = nullptr;
 	History *_history = nullptr; // if conversation photos or files overview
+	rpl::lifetime _messagesHold;
 	PeerData *_peer = nullptr;
 	UserData *_user = nullptr; // if user profile photos overview
 
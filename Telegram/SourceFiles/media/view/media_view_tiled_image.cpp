@@ -0,0 +1,246 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "media/view/media_view_tiled_image.h"
+
+#include <QtCore/QBuffer>
+#include <QtGui/QImageReader>
+
+namespace Media::View {
+namespace {
+
+constexpr auto kTileSize = 512;
+constexpr auto kMaxDecodingTiles = 4;
+constexpr auto kFallbackLevels = 2;
+constexpr auto kCacheLimit = int64(96 * 1024 * 1024);
+
+template <typename Method>
+auto WithReader(const TiledImage::Source &source, Method &&method) {
+	if (source.content.isEmpty()) {
+		auto reader = QImageReader(source.path);
+		return method(reader);
+	}
+	auto buffer = QBuffer();
+	buffer.setData(source.content);
+	buffer.open(QIODevice::ReadOnly);
+	auto reader = QImageReader(&buffer);
+	return method(reader);
+}
+
+[[nodiscard]] QImage DecodeTile(
+		const TiledImage::Source &source,
+		const QByteArray &format,
+		QRect clip,
+		QSize scaled) {
+	return WithReader(source, [&](QImageReader &reader) {
+		reader.setFormat(format);
+		reader.setAutoTransform(false);
+		reader.setClipRect(clip);
+		if (scaled != clip.size()) {
+			reader.setScaledSize(scaled);
+		}
+		auto result = reader.read();
+		if (!result.isNull()
+			&& result.format() != QImage::Format_ARGB32_Premultiplied) {
+			result = std::move(result).convertToFormat(
+				QImage::Format_ARGB32_Premultiplied);
+		}
+		return result;
+	});
+}
+
+} // namespace
+
+std::unique_ptr<TiledImage> TiledImage::Create(
+		Source source,
+		int displayLimit) {
+	auto size = QSize();
+	auto format = QByteArray();
+	const auto supported = WithReader(source, [&](QImageReader &reader) {
+		if (!reader.canRead()
+			|| !reader.supportsOption(QImageIOHandler::ClipRect)
+			|| !reader.supportsOption(QImageIOHandler::ScaledSize)
+			|| (reader.transformation()
+				!= QImageIOHandler::TransformationNone)) {
+			return false;
+		}
+		size = reader.size();
+		format = reader.format();
+		return true;
+	});
+	if (!supported
+		|| size.isEmpty()
+		|| (size.width() <= displayLimit
+			&& size.height() <= displayLimit)) {
+		return nullptr;
+	}
+	return std::make_unique<TiledImage>(
+		std::move(source),
+		size,
+		std::move(format));
+}
+
+TiledImage::TiledImage(Source source, QSize size, QByteArray format)
+: _source(std::move(source))
+, _size(size)
+, _format(std::move(format)) {
+	const auto side = std::max(_size.width(), _size.height());
+	while ((side >> (_levels - 1)) > kTileSize) {
+		++_levels;
+	}
+}
+
+TiledImage::~TiledImage() {
+	*_cancelled = true;
+}
+
+QSize TiledImage::size() const {
+	return _size;
+}
+
+rpl::producer<> TiledImage::tileReady() const {
+	return _tileReady.events();
+}
+
+int TiledImage::chooseLevel(QRect region, QSize target) const {
+	if (region.isEmpty() || target.isEmpty()) {
+		return _levels - 1;
+	}
+	const auto scale = std::max(
+		target.width() / float64(region.width()),
+		target.height() / float64(region.height()));
+	if (scale >= 1.) {
+		return 0;
+	}
+	const auto level = int(std::floor(std::log2(1. / scale)));
+	return std::clamp(level, 0, _levels - 1);
+}
+
+QRect TiledImage::tileRect(Key key) const {
+	const auto side = (kTileSize << key.level);
+	return QRect(
+		key.column * side,
+		key.row * side,
+		side,
+		side).intersected(QRect(QPoint(), _size));
+}
+
+const TiledImage::Tile *TiledImage::lookup(Key key) {
+	const auto i = _tiles.find(key);
+	if (i == end(_tiles)) {
+		return nullptr;
+	}
+	_lru.splice(begin(_lru), _lru, i->second.lru);
+	return &i->second;
+}
+
+QImage TiledImage::compose(QRect region, QSize target) {
+	region = region.intersected(QRect(QPoint(), _size));
+	if (region.isEmpty() || target.isEmpty()) {
+		return QImage();
+	} else if (_composedRegion == region
+		&& _composedTarget == target
+		&& _composedGeneration == _generation) {
+		return _composed;
+	}
+	const auto level = chooseLevel(region, target);
+
+	auto result = QImage(target, QImage::Format_ARGB32_Premultiplied);
+	result.fill(Qt::transparent);
+	{
+		auto p = QPainter(&result);
+		p.setRenderHint(QPainter::SmoothPixmapTransform);
+		p.scale(
+			target.width() / float64(region.width()),
+			target.height() / float64(region.height()));
+		p.translate(-region.topLeft());
+		const auto coarsest = std::min(level + kFallbackLevels, _levels - 1);
+		for (auto i = coarsest; i >= level; --i) {
+			paintLevel(p, i, region, target);
+		}
+	}
+	_composed = std::move(result);
+	_composedRegion = region;
+	_composedTarget = target;
+	_composedGeneration = _generation;
+
+	enforceCacheLimit();
+	return _composed;
+}
+
+void TiledImage::paintLevel(
+		QPainter &p,
+		int level,
+		QRect region,
+		QSize target) {
+	const auto side = (kTileSize << level);
+	const auto fromColumn = region.x() / side;
+	const auto tillColumn = (region.x() + region.width() + side - 1) / side;
+	const auto fromRow = region.y() / side;
+	const auto tillRow = (region.y() + region.height() + side - 1) / side;
+	for (auto row = fromRow; row != tillRow; ++row) {
+		for (auto column = fromColumn; column != tillColumn; ++column) {
+			const auto key = Key{ level, column, row };
+			if (const auto tile = lookup(key)) {
+				p.drawImage(QRectF(tileRect(key)), tile->image);
+			} else if (level == chooseLevel(region, target)) {
+				request(key);
+			}
+		}
+	}
+}
+
+void TiledImage::request(Key key) {
+	if (_requested.contains(key)
+		|| int(_requested.size()) >= kMaxDecodingTiles) {
+		return;
+	}
+	_requested.emplace(key);
+
+	const auto clip = tileRect(key);
+	const auto scaled = QSize(
+		std::max((clip.width() + (1 << key.level) - 1) >> key.level, 1),
+		std::max((clip.height() + (1 << key.level) - 1) >> key.level, 1));
+	const auto weak = base::make_weak(this);
+	const auto cancelled = _cancelled;
+	crl::async([=, source = _source, format = _format] {
+		if (*cancelled) {
+			return;
+		}
+		crl::on_main(weak, [=, image = DecodeTile(
+				source,
+				format,
+				clip,
+				scaled)]() mutable {
+			tileDecoded(key, std::move(image));
+		});
+	});
+}
+
+void TiledImage::tileDecoded(Key key, QImage image) {
+	_requested.remove(key);
+	if (image.isNull()) {
+		return;
+	}
+	_cachedBytes += image.sizeInBytes();
+	_lru.push_front(key);
+	_tiles.emplace(key, Tile{ std::move(image), begin(_lru) });
+	++_generation;
+	_tileReady.fire({});
+}
+
+void TiledImage::enforceCacheLimit() {
+	while (_cachedBytes > kCacheLimit && _lru.size() > 1) {
+		const auto i = _tiles.find(_lru.back());
+		Assert(i != end(_tiles));
+		_cachedBytes -= i->second.image.sizeInBytes();
+		_tiles.erase(i);
+		_lru.pop_back();
+	}
+}
+
+} // namespace Media::View
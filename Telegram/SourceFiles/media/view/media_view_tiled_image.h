@@ -0,0 +1,104 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/weak_ptr.h"
+
+#include <list>
+#include <atomic>
+
+namespace Media::View {
+
+// Multi-resolution tiled access to a very large image.
+//
+// Level 0 is the original resolution, every next level is two times
+// smaller. Only the tiles that intersect the requested region are
+// decoded, each one on a worker thread using the image reader clip rect,
+// and the decoded tiles are kept in a memory-limited LRU cache.
+class TiledImage final : public base::has_weak_ptr {
+public:
+	struct Source {
+		QString path;
+		QByteArray content;
+	};
+
+	// Returns nullptr if the image can't be decoded region by region
+	// or if it is small enough to be shown as a single image.
+	[[nodiscard]] static std::unique_ptr<TiledImage> Create(
+		Source source,
+		int displayLimit);
+
+	TiledImage(Source source, QSize size, QByteArray format);
+	~TiledImage();
+
+	[[nodiscard]] QSize size() const;
+
+	// Composes the 'region' of the original image scaled to 'target'
+	// from the tiles decoded so far and requests the missing ones.
+	// Not yet decoded parts are left transparent. The result is cached,
+	// so the same image (with the same cacheKey()) is returned until
+	// the arguments change or new tiles arrive.
+	[[nodiscard]] QImage compose(QRect region, QSize target);
+
+	[[nodiscard]] rpl::producer<> tileReady() const;
+
+private:
+	struct Key {
+		int level = 0;
+		int column = 0;
+		int row = 0;
+
+		friend inline bool operator<(Key a, Key b) {
+			return std::tie(a.level, a.column, a.row)
+				< std::tie(b.level, b.column, b.row);
+		}
+		friend inline bool operator==(Key a, Key b) {
+			return (a.level == b.level)
+				&& (a.column == b.column)
+				&& (a.row == b.row);
+		}
+	};
+	struct Tile {
+		QImage image;
+		std::list<Key>::iterator lru;
+	};
+
+	[[nodiscard]] int chooseLevel(QRect region, QSize target) const;
+	[[nodiscard]] QRect tileRect(Key key) const;
+	[[nodiscard]] const Tile *lookup(Key key);
+	void request(Key key);
+	void tileDecoded(Key key, QImage image);
+	void paintLevel(QPainter &p, int level, QRect region, QSize target);
+	void enforceCacheLimit();
+
+	const Source _source;
+	const QSize _size;
+	const QByteArray _format;
+	int _levels = 1;
+
+	base::flat_map<Key, Tile> _tiles;
+	base::flat_set<Key> _requested;
+	std::list<Key> _lru;
+	int64 _cachedBytes = 0;
+
+	QRect _composedRegion;
+	QSize _composedTarget;
+	int _composedGeneration = -1;
+	int _generation = 0;
+	QImage _composed;
+
+	rpl::event_stream<> _tileReady;
+
+	// Checked by the worker threads before decoding, the decoded tiles
+	// are delivered through the weak pointer on the main thread.
+	const std::shared_ptr<std::atomic<bool>> _cancelled
+		= std::make_shared<std::atomic<bool>>(false);
+
+};
+
+} // namespace Media::View
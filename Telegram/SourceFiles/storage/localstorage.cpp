@@ -33,6 +33,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <QtCore/QDirIterator>
 
+#include <list>
+
 #ifndef Q_OS_WIN
 #include <unistd.h>
 #endif // Q_OS_WIN
@@ -45,12 +47,12 @@ namespace Local {
 namespace {
 
 constexpr auto kThemeFileSizeLimit = 5 * 1024 * 1024;
-constexpr auto kFileLoaderQueueStopTimeout = crl::time(5000);
 
 constexpr auto kSavedBackgroundFormat = QImage::Format_ARGB32_Premultiplied;
 constexpr auto kWallPaperLegacySerializeTagId = int32(-111);
 constexpr auto kWallPaperSerializeTagId = int32(-112);
 constexpr auto kWallPaperSidesLimit = 10'000;
+constexpr auto kCountedWaveformsLimit = 1024;
 
 const auto kThemeNewPathRelativeTag = qstr("special://new_tag");
 
@@ -61,7 +63,14 @@ using Database = Storage::Cache::Database;
 
 QString _basePath, _userBasePath, _userDbPath;
 
-TaskQueue *_localLoader = nullptr;
+// Waveforms counted from the local files, by document id,
+// the least recently used ones are dropped over the limit.
+struct CountedWaveform {
+	VoiceWaveform waveform;
+	std::list<DocumentId>::iterator lru;
+};
+std::unordered_map<DocumentId, CountedWaveform> _countedWaveforms;
+std::list<DocumentId> _countedWaveformsLru;
 
 QByteArray _settingsSalt;
 
@@ -344,7 +353,6 @@ void sync() {
 }
 
 void finish() {
-	delete base::take(_localLoader);
 	Storage::details::Finish();
 }
 
@@ -355,8 +363,6 @@ void readLangPack();
 void start() {
 	Expects(_basePath.isEmpty());
 
-	_localLoader = new TaskQueue(kFileLoaderQueueStopTimeout);
-
 	_basePath = cWorkingDir() + qsl("tdata/");
 	if (!QDir().exists(_basePath)) QDir().mkpath(_basePath);
 
@@ -791,10 +797,6 @@ void moveLegacyBackground(
 }
 
 void reset() {
-	if (_localLoader) {
-		_localLoader->stop();
-	}
-
 	Window::Theme::Background()->reset();
 	_oldSettingsVersion = 0;
 	Core::App().settings().resetOnLastLogout();
@@ -809,74 +811,109 @@ int32 oldKotatoVersion() {
 	return _oldKotatoVersion;
 }
 
-class CountWaveformTask : public Task {
-public:
-	CountWaveformTask(not_null<Data::DocumentMedia*> media)
-	: _doc(media->owner())
-	, _loc(_doc->location(true))
-	, _data(media->bytes())
-	, _wavemax(0) {
-		if (_data.isEmpty() && !_loc.accessEnable()) {
-			_doc = nullptr;
-		}
-	}
-	void process() override {
-		if (!_doc) return;
+namespace {
 
-		_waveform = audioCountWaveform(_loc, _data);
-		_wavemax = _waveform.empty()
-			? char(0)
-			: *ranges::max_element(_waveform);
+void applyVoiceWaveform(
+		not_null<DocumentData*> document,
+		const VoiceWaveform &waveform) {
+	const auto voice = document->voice();
+	if (!voice) {
+		return;
 	}
-	void finish() override {
-		if (const auto voice = _doc ? _doc->voice() : nullptr) {
-			if (!_waveform.isEmpty()) {
-				voice->waveform = _waveform;
-				voice->wavemax = _wavemax;
-			}
-			if (voice->waveform.isEmpty()) {
-				voice->waveform.resize(1);
-				voice->waveform[0] = -2;
-				voice->wavemax = 0;
-			} else if (voice->waveform[0] < 0) {
-				voice->waveform[0] = -2;
-				voice->wavemax = 0;
-			}
-			_doc->owner().requestDocumentViewRepaint(_doc);
-		}
+	if (!waveform.isEmpty()) {
+		voice->waveform = waveform;
+		voice->wavemax = *ranges::max_element(waveform);
 	}
-	~CountWaveformTask() {
-		if (_data.isEmpty() && _doc) {
-			_loc.accessDisable();
-		}
+	if (voice->waveform.isEmpty()) {
+		voice->waveform.resize(1);
+		voice->waveform[0] = -2;
+		voice->wavemax = 0;
+	} else if (voice->waveform[0] < 0) {
+		voice->waveform[0] = -2;
+		voice->wavemax = 0;
 	}
+	document->owner().requestDocumentViewRepaint(document);
+}
 
-protected:
-	DocumentData *_doc = nullptr;
-	Core::FileLocation _loc;
-	QByteArray _data;
-	VoiceWaveform _waveform;
-	char _wavemax;
+const VoiceWaveform *lookupCountedWaveform(DocumentId id) {
+	const auto i = _countedWaveforms.find(id);
+	if (i == end(_countedWaveforms)) {
+		return nullptr;
+	}
+	_countedWaveformsLru.splice(
+		begin(_countedWaveformsLru),
+		_countedWaveformsLru,
+		i->second.lru);
+	return &i->second.waveform;
+}
 
-};
+void rememberCountedWaveform(DocumentId id, const VoiceWaveform &waveform) {
+	if (lookupCountedWaveform(id)) {
+		_countedWaveforms.find(id)->second.waveform = waveform;
+		return;
+	}
+	if (_countedWaveforms.size() >= kCountedWaveformsLimit) {
+		_countedWaveforms.erase(_countedWaveformsLru.back());
+		_countedWaveformsLru.pop_back();
+	}
+	_countedWaveformsLru.push_front(id);
+	_countedWaveforms.emplace(
+		id,
+		CountedWaveform{ waveform, begin(_countedWaveformsLru) });
+}
+
+} // namespace
 
 void countVoiceWaveform(not_null<Data::DocumentMedia*> media) {
 	const auto document = media->owner();
-	if (const auto voice = document->voice()) {
-		if (_localLoader) {
-			voice->waveform.resize(1 + sizeof(TaskId));
-			voice->waveform[0] = -1; // counting
-			TaskId taskId = _localLoader->addTask(
-				std::make_unique<CountWaveformTask>(media));
-			memcpy(voice->waveform.data() + 1, &taskId, sizeof(taskId));
-		}
+	const auto voice = document->voice();
+	if (!voice) {
+		return;
 	}
-}
+	const auto id = document->id;
+	if (const auto counted = lookupCountedWaveform(id)) {
+		applyVoiceWaveform(document, *counted);
+		return;
+	}
+	voice->waveform.resize(1);
+	voice->waveform[0] = -1; // counting
 
-void cancelTask(TaskId id) {
-	if (_localLoader) {
-		_localLoader->cancelTask(id);
+	auto location = document->location(true);
+	const auto bytes = media->bytes();
+	if (bytes.isEmpty() && !location.accessEnable()) {
+		return;
 	}
+
+	// Each waveform is counted in its own job, so that a chat with many
+	// voice messages doesn't wait for them to be decoded one by one.
+	const auto weak = base::make_weak(&document->session());
+	const auto cancelled = std::make_shared<std::atomic<bool>>(false);
+	if (voice->waveformCancelled) {
+		*voice->waveformCancelled = true;
+	}
+	voice->waveformCancelled = cancelled;
+	crl::async([=, location = std::move(location)]() mutable {
+		auto waveform = *cancelled
+			? VoiceWaveform()
+			: audioCountWaveform(location, bytes);
+		if (bytes.isEmpty()) {
+			location.accessDisable();
+		}
+		crl::on_main([=, waveform = std::move(waveform)] {
+			if (*cancelled) {
+				return;
+			} else if (!waveform.isEmpty()) {
+				rememberCountedWaveform(id, waveform);
+			}
+			const auto strong = weak.get();
+			const auto document = strong
+				? strong->data().documentLoaded(id)
+				: nullptr;
+			if (document) {
+				applyVoiceWaveform(document, waveform);
+			}
+		});
+	});
 }
 
 Window::Theme::Saved readThemeUsingKey(FileKey key) {
@@ -73,8 +73,6 @@ int32 oldKotatoVersion();
 
 void countVoiceWaveform(not_null<Data::DocumentMedia*> media);
 
-void cancelTask(TaskId id);
-
 void writeTheme(const Window::Theme::Saved &saved);
 void clearTheme();
 [[nodiscard]] Window::Theme::Saved readThemeAfterSwitch();
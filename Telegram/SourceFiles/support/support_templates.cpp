@@ -21,6 +21,17 @@ namespace {
 constexpr auto kQueryLimit = 10;
 constexpr auto kWeightStep = 1000;
 
+// Words of this length may match terms with a typo in them,
+// two typos are allowed starting with the second length.
+constexpr auto kTypoMinLength = 4;
+constexpr auto kTwoTyposMinLength = 8;
+
+// Weight multipliers of a term equal to the word, starting with it
+// and starting with it with a typo.
+constexpr auto kExactMultiplier = 4;
+constexpr auto kPrefixMultiplier = 2;
+constexpr auto kTypoMultiplier = 1;
+
 struct Delta {
 	std::vector<const TemplatesQuestion*> added;
 	std::vector<const TemplatesQuestion*> changed;
@@ -272,18 +283,17 @@ FilesResult ReadFiles(const QString &folder) {
 
 TemplatesIndex ComputeIndex(const TemplatesData &data) {
 	using Id = TemplatesIndex::Id;
-	using Term = TemplatesIndex::Term;
+	using Posting = TemplatesIndex::Posting;
 
-	auto uniqueFirst = std::map<QChar, base::flat_set<Id>>();
-	auto uniqueFull = std::map<Id, base::flat_set<Term>>();
+	auto unique = std::map<QString, std::map<Id, int>>();
 	const auto pushString = [&](
 			const Id &id,
 			const QString &string,
 			int weight) {
 		const auto list = TextUtilities::PrepareSearchWords(string);
 		for (const auto &word : list) {
-			uniqueFirst[word[0]].emplace(id);
-			uniqueFull[id].emplace(std::make_pair(word, weight));
+			auto &already = unique[word][id];
+			already = std::max(already, weight);
 		}
 	};
 	for (const auto &[path, file] : data.files) {
@@ -298,11 +308,14 @@ TemplatesIndex ComputeIndex(const TemplatesData &data) {
 	}
 
 	auto result = TemplatesIndex();
-	for (const auto &[ch, unique] : uniqueFirst) {
-		result.first.emplace(ch, unique | ranges::to_vector);
-	}
-	for (const auto &[id, unique] : uniqueFull) {
-		result.full.emplace(id, unique | ranges::to_vector);
+	result.terms.reserve(unique.size());
+	for (const auto &[term, ids] : unique) {
+		auto postings = std::vector<Posting>();
+		postings.reserve(ids.size());
+		for (const auto &[id, weight] : ids) {
+			postings.push_back({ id, weight });
+		}
+		result.terms.emplace(term, std::move(postings));
 	}
 	return result;
 }
@@ -311,37 +324,137 @@ void ReplaceFileIndex(
 		TemplatesIndex &result,
 		TemplatesIndex &&source,
 		const QString &path) {
-	for (auto i = begin(result.full); i != end(result.full);) {
-		if (i->first.first == path) {
-			i = result.full.erase(i);
+	using Posting = TemplatesIndex::Posting;
+	for (auto i = begin(result.terms); i != end(result.terms);) {
+		auto &postings = i->second;
+		postings.erase(ranges::remove(
+			postings,
+			path,
+			[](const Posting &posting) { return posting.id.first; }
+		), end(postings));
+		if (postings.empty()) {
+			i = result.terms.erase(i);
 		} else {
 			++i;
 		}
 	}
-	for (auto &[id, list] : source.full) {
-		result.full.emplace(id, std::move(list));
-	}
-
-	using Id = TemplatesIndex::Id;
-	for (auto &[ch, list] : result.first) {
-		auto i = ranges::lower_bound(
-			list,
-			std::make_pair(path, QString()));
-		auto j = std::find_if(i, end(list), [&](const Id &id) {
-			return id.first != path;
-		});
-		list.erase(i, j);
-	}
-	for (auto &[ch, list] : source.first) {
-		auto &to = result.first[ch];
+	for (auto &[term, list] : source.terms) {
+		auto &to = result.terms[term];
 		to.insert(
 			end(to),
 			std::make_move_iterator(begin(list)),
 			std::make_move_iterator(end(list)));
-		ranges::sort(to);
+		ranges::sort(to, std::less<>(), &Posting::id);
 	}
 }
 
+// Best weight of each question matching one word of the query.
+[[nodiscard]] std::map<TemplatesIndex::Id, int> CollectMatches(
+		const TemplatesIndex &index,
+		const QString &word) {
+	auto result = std::map<TemplatesIndex::Id, int>();
+	const auto add = [&](
+			const std::vector<TemplatesIndex::Posting> &postings,
+			int multiplier) {
+		for (const auto &[id, weight] : postings) {
+			auto &already = result[id];
+			already = std::max(already, weight * multiplier);
+		}
+	};
+	const auto &terms = index.terms;
+	if (word.size() < kTypoMinLength) {
+		for (auto i = terms.lower_bound(word); i != end(terms); ++i) {
+			if (!i->first.startsWith(word)) {
+				break;
+			}
+			add(i->second, (i->first == word)
+				? kExactMultiplier
+				: kPrefixMultiplier);
+		}
+		return result;
+	}
+
+	// Typos are looked for only in the terms with the same first letter.
+	//
+	// The sorted terms are walked as an implicit trie. Each row of the
+	// edit distance table belongs to one prefix length, so neighbouring
+	// terms share the rows of their common prefix. Once some prefix is
+	// within 'limit' edits of the word all the terms starting with it
+	// match, and once every value in a row is above 'limit' none of them
+	// can match. Either way the whole range of such terms is passed.
+	const auto limit = (word.size() < kTwoTyposMinLength) ? 1 : 2;
+	const auto first = word[0];
+	const auto length = int(word.size());
+	const auto maxDepth = length + limit;
+	auto rows = std::vector<int>((maxDepth + 1) * (length + 1));
+	const auto row = [&](int depth) {
+		return rows.data() + depth * (length + 1);
+	};
+	for (auto j = 0; j <= length; ++j) {
+		row(0)[j] = j;
+	}
+	auto previous = (const QString*)nullptr;
+	auto depth = 0;
+	auto i = terms.lower_bound(QString(first));
+	while (i != end(terms) && i->first[0] == first) {
+		const auto &term = i->first;
+		auto common = 0;
+		if (previous) {
+			const auto till = std::min(depth, int(term.size()));
+			while (common < till && term[common] == (*previous)[common]) {
+				++common;
+			}
+		}
+		previous = &term;
+		depth = common;
+
+		auto matched = false;
+		auto pruned = false;
+		while (depth < term.size()) {
+			if (depth == maxDepth) {
+				pruned = true;
+				break;
+			}
+			const auto from = row(depth);
+			const auto to = row(++depth);
+			const auto ch = term[depth - 1];
+			to[0] = depth;
+			auto best = depth;
+			for (auto j = 1; j <= length; ++j) {
+				to[j] = std::min({
+					from[j] + 1,
+					to[j - 1] + 1,
+					from[j - 1] + ((word[j - 1] == ch) ? 0 : 1),
+				});
+				best = std::min(best, to[j]);
+			}
+			if (to[length] <= limit) {
+				matched = true;
+				break;
+			} else if (best > limit) {
+				pruned = true;
+				break;
+			}
+		}
+		if (!matched && !pruned) {
+			++i;
+			continue;
+		}
+		const auto prefix = term.left(depth);
+		for (; i != end(terms) && i->first.startsWith(prefix); ++i) {
+			if (!matched) {
+				continue;
+			}
+			add(i->second, (i->first == word)
+				? kExactMultiplier
+				: i->first.startsWith(word)
+				? kPrefixMultiplier
+				: kTypoMultiplier);
+		}
+	}
+	return result;
+}
+
 void MoveKeys(TemplatesFile &to, const TemplatesFile &from) {
 	const auto &existing = from.questions;
 	for (auto &[normalized, question] : to.questions) {
@@ -566,9 +679,18 @@ void Templates::updateRequestFinished(QNetworkReply *reply) {
 	LOG(("Got template from url '%1'"
 		).arg(reply->url().toDisplayString()));
 	const auto content = reply->readAll();
-	crl::async([=, weak = base::make_weak(this)]{
+
+	// The keys are kept from the existing file, so they are moved to the
+	// parsed one before it is indexed.
+	auto was = _data.files.at(path);
+	crl::async([
+		=,
+		was = std::move(was),
+		weak = base::make_weak(this)
+	] {
 		auto result = ReadFromBlob(content);
 		auto one = TemplatesData();
+		MoveKeys(result.result, was);
 		one.files.emplace(path, std::move(result.result));
 		auto index = ComputeIndex(one);
 		crl::on_main(weak,[
@@ -579,8 +701,7 @@ void Templates::updateRequestFinished(QNetworkReply *reply) {
 		]() mutable {
 			auto &existing = _data.files.at(path);
 			auto &parsed = one.files.at(path);
-			MoveKeys(parsed, existing);
-			ReplaceFileIndex(_index, ComputeIndex(one), path);
+			ReplaceFileIndex(_index, std::move(index), path);
 			if (!errors.isEmpty()) {
 				_errors.fire(std::move(errors));
 			}
@@ -666,56 +787,33 @@ Templates::~Templates() = default;
 
 auto Templates::query(const QString &text) const -> std::vector<Question> {
 	const auto words = TextUtilities::PrepareSearchWords(text);
-	const auto questions = [&](const QString &word) {
-		const auto i = _index.first.find(word[0]);
-		return (i == end(_index.first)) ? 0 : i->second.size();
-	};
-	const auto best = ranges::min_element(words, std::less<>(), questions);
-	if (best == std::end(words)) {
-		return {};
-	}
-	const auto narrowed = _index.first.find((*best)[0]);
-	if (narrowed == end(_index.first)) {
+	if (words.isEmpty()) {
 		return {};
 	}
 	using Id = TemplatesIndex::Id;
-	using Term = TemplatesIndex::Term;
 	const auto questionById = [&](const Id &id) {
 		return _data.files.at(id.first).questions.at(id.second);
 	};
 
-	const auto computeWeight = [&](const Id &id) {
-		auto result = 0;
-		const auto full = _index.full.find(id);
-		for (const auto &word : words) {
-			const auto from = ranges::lower_bound(
-				full->second,
-				word,
-				std::less<>(),
-				[](const Term &term) { return term.first; });
-			const auto till = std::find_if(
-				from,
-				end(full->second),
-				[&](const Term &term) {
-					return !term.first.startsWith(word);
-				});
-			const auto weight = std::max_element(
-				from,
-				till,
-				[](const Term &a, const Term &b) {
-					return a.second < b.second;
-				});
-			if (weight == till) {
-				return 0;
+	// Every word of the query should match some term of the question.
+	auto weights = CollectMatches(_index, words.front());
+	for (const auto &word : words | ranges::views::drop(1)) {
+		if (weights.empty()) {
+			break;
+		}
+		const auto matches = CollectMatches(_index, word);
+		for (auto i = begin(weights); i != end(weights);) {
+			const auto j = matches.find(i->first);
+			if (j == end(matches)) {
+				i = weights.erase(i);
+			} else {
+				i->second += j->second;
+				++i;
 			}
-			result += weight->second * (weight->first == word ? 2 : 1);
 		}
-		return result;
-	};
+	}
+
 	using Pair = std::pair<Id, int>;
-	const auto pairById = [&](const Id &id) {
-		return std::make_pair(id, computeWeight(id));
-	};
 	const auto sorter = [](const Pair &a, const Pair &b) {
 		// weight DESC filename DESC question ASC
 		if (a.second > b.second) {
@@ -730,14 +828,13 @@ auto Templates::query(const QString &text) const -> std::vector<Question> {
 			return (a.first.second < b.first.second);
 		}
 	};
-	const auto good = narrowed->second | ranges::views::transform(
-		pairById
-	) | ranges::views::filter([](const Pair &pair) {
-		return pair.second > 0;
-	}) | ranges::to_vector | ranges::actions::stable_sort(sorter);
-	return good | ranges::views::transform([&](const Pair &pair) {
+	auto good = std::vector<Pair>(begin(weights), end(weights));
+	const auto limit = std::min(int(good.size()), kQueryLimit);
+	ranges::partial_sort(good, begin(good) + limit, sorter);
+	return good | ranges::views::take(limit) | ranges::views::transform([&](
+			const Pair &pair) {
 		return questionById(pair.first);
-	}) | ranges::views::take(kQueryLimit) | ranges::to_vector;
+	}) | ranges::to_vector;
 }
 
 } // namespace Support
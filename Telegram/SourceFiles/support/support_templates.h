@@ -36,10 +36,15 @@ struct TemplatesData {
 
 struct TemplatesIndex {
 	using Id = std::pair<QString, QString>; // filename, normalized question
-	using Term = std::pair<QString, int>; // search term, weight
+	struct Posting {
+		Id id;
+		int weight = 0;
+	};
 
-	std::map<QChar, std::vector<Id>> first;
-	std::map<Id, std::vector<Term>> full;
+	// Sorted by the search term, so all the terms starting with some
+	// prefix are found by a binary search, like in a prefix tree.
+	// Postings of each term are sorted by id.
+	base::flat_map<QString, std::vector<Posting>> terms;
 };
 
 } // namespace details
@@ -1020,8 +1020,7 @@ QImage GenerateDitheredGradient(
 	return result;
 }
 
-ChatThemeBackground PrepareBackgroundImage(
-		const ChatThemeBackgroundData &data) {
+QImage ReadPreparedBackgroundImage(const ChatThemeBackgroundData &data) {
 	auto prepared = (data.isPattern || data.colors.empty())
 		? PreprocessBackgroundImage(
 			ReadBackgroundImage(data.path, data.bytes, data.gzipSvg))
@@ -1036,8 +1035,16 @@ ChatThemeBackground PrepareBackgroundImage(
 		} else if (IsPatternInverted(data.colors, data.patternOpacity)) {
 			prepared = InvertPatternImage(std::move(prepared));
 		}
-		prepared.setDevicePixelRatio(style::DevicePixelRatio());
-	} else if (data.colors.empty()) {
+	}
+	return prepared;
+}
+
+ChatThemeBackground PrepareBackgroundImage(
+		const ChatThemeBackgroundData &data) {
+	auto prepared = data.prepared.isNull()
+		? ReadPreparedBackgroundImage(data)
+		: data.prepared;
+	if ((data.isPattern && !prepared.isNull()) || data.colors.empty()) {
 		prepared.setDevicePixelRatio(style::DevicePixelRatio());
 	}
 	const auto imageMonoColor = (data.colors.size() < 2)
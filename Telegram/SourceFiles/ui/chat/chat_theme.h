@@ -51,6 +51,7 @@ struct ChatThemeBackgroundData {
 	bool isBlurred = false;
 	bool generateGradient = false;
 	int gradientRotation = 0;
+	QImage prepared; // Already prepared, f.e. read from the disk cache.
 };
 
 struct ChatThemeBubblesData {
@@ -265,6 +266,11 @@ struct ChatBackgroundRects {
 [[nodiscard]] QImage GenerateDitheredGradient(
 	const std::vector<QColor> &colors,
 	int rotation);
+
+// Reads the paper and applies the pattern colors, the result doesn't
+// depend on the window size or the device pixel ratio.
+[[nodiscard]] QImage ReadPreparedBackgroundImage(
+	const ChatThemeBackgroundData &data);
 [[nodiscard]] ChatThemeBackground PrepareBackgroundImage(
 	const ChatThemeBackgroundData &data);
 
@@ -74,6 +74,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "api/api_global_privacy.h"
 #include "support/support_helper.h"
 #include "storage/file_upload.h"
+#include "storage/file_download.h" // Storage::kMaxFileInMemory.
+#include "ui/image/image_prepare.h"
 #include "facades.h"
 #include "window/themes/window_theme.h"
 #include "styles/style_window.h"
@@ -83,6 +85,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "styles/style_info.h"
 #include "styles/style_menu_icons.h"
 
+#include <QtCore/QBuffer>
+
 namespace Window {
 namespace {
 
@@ -90,6 +94,7 @@ constexpr auto kCustomThemesInMemory = 5;
 constexpr auto kMaxChatEntryHistorySize = 50;
 constexpr auto kDayBaseFile = ":/gui/day-custom-base.tdesktop-theme"_cs;
 constexpr auto kNightBaseFile = ":/gui/night-custom-base.tdesktop-theme"_cs;
+constexpr auto kBackgroundCacheVersion = 1;
 
 [[nodiscard]] Fn<void(style::palette&)> PreparePaletteCallback(
 		bool dark,
@@ -133,6 +138,92 @@ constexpr auto kNightBaseFile = ":/gui/night-custom-base.tdesktop-theme"_cs;
 	};
 }
 
+// Only pattern papers are cached, they require rendering the SVG and
+// colorizing it, while photo papers are just decoded from the file.
+[[nodiscard]] std::optional<Storage::Cache::Key> BackgroundCacheKey(
+		const Data::WallPaper &paper) {
+	const auto document = paper.document();
+	if (!document || !paper.isPattern()) {
+		return std::nullopt;
+	}
+	auto description = QByteArray();
+	{
+		auto stream = QDataStream(&description, QIODevice::WriteOnly);
+		stream.setVersion(QDataStream::Qt_5_1);
+		stream
+			<< qint32(kBackgroundCacheVersion)
+			<< quint64(document->id)
+			<< qint32(paper.gradientRotation())
+			<< paper.patternOpacity();
+		for (const auto &color : paper.backgroundColors()) {
+			stream << quint32(color.rgba());
+		}
+	}
+	return Data::ChatBackgroundCacheKey(description);
+}
+
+// Invokes 'done' on a background thread with data.prepared filled from
+// the disk cache if it was saved there, reads and saves it otherwise.
+void ResolvePreparedBackground(
+		not_null<Main::Session*> session,
+		std::optional<Storage::Cache::Key> key,
+		Ui::ChatThemeBackgroundData data,
+		FnMut<void(Ui::ChatThemeBackgroundData&&)> done) {
+	if (!key) {
+		crl::async([
+			data = std::move(data),
+			done = std::move(done)
+		]() mutable {
+			done(std::move(data));
+		});
+		return;
+	}
+	const auto weak = base::make_weak(session.get());
+	const auto save = [=](const QImage &image) {
+		auto bytes = QByteArray();
+		{
+			auto buffer = QBuffer(&bytes);
+			image.save(&buffer, "PNG");
+		}
+		if (bytes.isEmpty() || bytes.size() > Storage::kMaxFileInMemory) {
+			return;
+		}
+		crl::on_main(weak, [=, bytes = std::move(bytes)]() mutable {
+			session->data().cache().put(
+				*key,
+				Storage::Cache::Database::TaggedValue(
+					std::move(bytes),
+					Data::kImageCacheTag));
+		});
+	};
+	session->data().cache().get(*key, [
+		=,
+		data = std::move(data),
+		done = std::move(done)
+	](QByteArray &&value) mutable {
+		crl::async([
+			=,
+			value = std::move(value),
+			data = std::move(data),
+			done = std::move(done)
+		]() mutable {
+			auto cached = value.isEmpty()
+				? QImage()
+				: Images::Read({ .content = value }).image;
+			if (!cached.isNull()) {
+				data.prepared = std::move(cached).convertToFormat(
+					QImage::Format_ARGB32_Premultiplied);
+			} else if (!data.bytes.isEmpty() || !data.path.isEmpty()) {
+				data.prepared = Ui::ReadPreparedBackgroundImage(data);
+				if (!data.prepared.isNull()) {
+					save(data.prepared);
+				}
+			}
+			done(std::move(data));
+		});
+	});
+}
+
 void ChooseJumpDateTimeBox(
 	not_null<Ui::GenericBox*> box,
 	QDateTime minDate,
@@ -1764,23 +1855,28 @@ void SessionController::cacheChatTheme(
 		.preparePalette = PreparePaletteCallback(
 			dark,
 			i->second.accentColor),
-		.backgroundData = backgroundData(theme),
 		.bubblesData = PrepareBubblesData(data, type),
 		.basedOnDark = dark,
 	};
-	crl::async([
-		this,
-		descriptor = std::move(descriptor),
-		weak = base::make_weak(this)
-	]() mutable {
-		crl::on_main(weak,[
+	ResolvePreparedBackground(
+		&session(),
+		BackgroundCacheKey(*paper),
+		backgroundData(theme),
+		[
 			this,
-			result = std::make_shared<Ui::ChatTheme>(std::move(descriptor))
-		]() mutable {
-			result->finishCreateOnMain();
-			cacheChatThemeDone(std::move(result));
+			descriptor = std::move(descriptor),
+			weak = base::make_weak(this)
+		](Ui::ChatThemeBackgroundData &&data) mutable {
+			descriptor.backgroundData = std::move(data);
+			crl::on_main(weak, [
+				this,
+				result = std::make_shared<Ui::ChatTheme>(
+					std::move(descriptor))
+			]() mutable {
+				result->finishCreateOnMain();
+				cacheChatThemeDone(std::move(result));
+			});
 		});
-	});
 	if (media && media->loaded(true)) {
 		theme.media = nullptr;
 	}
@@ -1827,19 +1923,24 @@ void SessionController::updateCustomThemeBackground(CachedTheme &theme) {
 	}
 	const auto key = strong->key();
 	const auto weak = base::make_weak(this);
-	crl::async([=, data = backgroundData(theme, false)] {
-		crl::on_main(weak, [
-			=,
-			result = Ui::PrepareBackgroundImage(data)
-		]() mutable {
-			const auto i = _customChatThemes.find(key);
-			if (i != end(_customChatThemes)) {
-				if (const auto strong = i->second.theme.lock()) {
-					strong->updateBackgroundImageFrom(std::move(result));
+	ResolvePreparedBackground(
+		&session(),
+		BackgroundCacheKey(theme.paper),
+		backgroundData(theme, false),
+		[=](Ui::ChatThemeBackgroundData &&data) {
+			crl::on_main(weak, [
+				=,
+				result = Ui::PrepareBackgroundImage(data)
+			]() mutable {
+				const auto i = _customChatThemes.find(key);
+				if (i != end(_customChatThemes)) {
+					if (const auto strong = i->second.theme.lock()) {
+						strong->updateBackgroundImageFrom(
+							std::move(result));
+					}
 				}
-			}
+			});
 		});
-	});
 }
 
 Ui::ChatThemeBackgroundData SessionController::backgroundData(